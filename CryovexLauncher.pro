@@ -29,39 +29,107 @@ INCLUDEPATH += src/utils/
 # Source files
 SOURCES += \
     src/main.cpp \
+    src/InGameMode.cpp \
     src/auth/AuthManager.cpp \
     src/auth/MicrosoftAuth.cpp \
     src/version/VersionManager.cpp \
     src/version/MinecraftVersion.cpp \
+    src/version/VersionResolver.cpp \
+    src/version/ManifestCache.cpp \
     src/download/DownloadManager.cpp \
     src/download/DownloadTask.cpp \
+    src/download/InstallPlanner.cpp \
+    src/download/AssetIndexParser.cpp \
+    src/download/AssetIndexStreamer.cpp \
     src/launcher/GameLauncher.cpp \
     src/launcher/JvmArgumentBuilder.cpp \
+    src/launcher/ArgumentTemplate.cpp \
+    src/launcher/LaunchPlanCache.cpp \
+    src/launcher/LaunchMetrics.cpp \
+    src/launcher/GameOutputParser.cpp \
+    src/launcher/GameOutputModel.cpp \
+    src/launcher/JvmTuning.cpp \
+    src/launcher/JavaRuntimeDiscovery.cpp \
+    src/launcher/AppCdsManager.cpp \
+    src/launcher/PageCacheWarmer.cpp \
+    src/launcher/GameInstance.cpp \
+    src/launcher/InstanceManager.cpp \
+    src/launcher/ProcessSampler.cpp \
+    src/launcher/ProcessPlacement.cpp \
+    src/launcher/ProcessSpawn.cpp \
+    src/launcher/LaunchVerifier.cpp \
+    src/launcher/DetachedGame.cpp \
     src/config/ConfigManager.cpp \
     src/config/Profile.cpp \
     src/utils/Logger.cpp \
     src/utils/FileUtils.cpp \
-    src/utils/NetworkUtils.cpp
+    src/utils/NetworkUtils.cpp \
+    src/utils/FileStateIndex.cpp \
+    src/utils/RuleEngine.cpp \
+    src/utils/CompiledManifest.cpp \
+    src/utils/ZipReader.cpp \
+    src/utils/NativesCache.cpp \
+    src/utils/RotatingLogFile.cpp \
+    src/utils/AssetClassifier.cpp \
+    src/utils/ProcessMemory.cpp \
+    src/utils/DetachedGameState.cpp \
+    src/utils/BackgroundGovernor.cpp
 
 # Header files
 HEADERS += \
+    src/InGameMode.h \
     src/auth/AuthManager.h \
     src/auth/MicrosoftAuth.h \
     src/version/VersionManager.h \
     src/version/MinecraftVersion.h \
+    src/version/VersionResolver.h \
+    src/version/ManifestCache.h \
     src/download/DownloadManager.h \
     src/download/DownloadTask.h \
+    src/download/InstallPlanner.h \
+    src/download/AssetIndexParser.h \
+    src/download/AssetIndexStreamer.h \
     src/launcher/GameLauncher.h \
     src/launcher/JvmArgumentBuilder.h \
+    src/launcher/ArgumentTemplate.h \
+    src/launcher/LaunchPlanCache.h \
+    src/launcher/LaunchMetrics.h \
+    src/launcher/GameOutputParser.h \
+    src/launcher/GameOutputModel.h \
+    src/launcher/JvmTuning.h \
+    src/launcher/JavaRuntimeDiscovery.h \
+    src/launcher/AppCdsManager.h \
+    src/launcher/PageCacheWarmer.h \
+    src/launcher/GameInstance.h \
+    src/launcher/InstanceManager.h \
+    src/launcher/ProcessSampler.h \
+    src/launcher/ProcessPlacement.h \
+    src/launcher/ProcessSpawn.h \
+    src/launcher/LaunchVerifier.h \
+    src/launcher/DetachedGame.h \
     src/config/ConfigManager.h \
     src/config/Profile.h \
     src/utils/Logger.h \
     src/utils/FileUtils.h \
-    src/utils/NetworkUtils.h
+    src/utils/NetworkUtils.h \
+    src/utils/FileStateIndex.h \
+    src/utils/RuleEngine.h \
+    src/utils/CompiledManifest.h \
+    src/utils/ZipReader.h \
+    src/utils/NativesCache.h \
+    src/utils/RotatingLogFile.h \
+    src/utils/AssetClassifier.h \
+    src/utils/ProcessMemory.h \
+    src/utils/DetachedGameState.h \
+    src/utils/BackgroundGovernor.h
 
 # QML files
 RESOURCES += qml.qrc
 
+# zlib inflates natives jars
+unix: LIBS += -lz
+win32: LIBS += -lzlib
+
 # Platform-specific settings
 win32 {
     RC_ICONS = resources/icon.ico
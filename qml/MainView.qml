@@ -44,7 +44,7 @@ Item {
                     
                     ListView {
                         id: versionList
-                        model: [] // Will be populated by VersionManager
+                        model: VersionManager
                         
                         delegate: ItemDelegate {
                             width: versionList.width
@@ -97,6 +97,8 @@ Item {
                             
                             onClicked: {
                                 selectedVersion = model
+                                // Speculative: only installed versions, and silent if they do not resolve
+                                GameLauncher.warmVersion(model.id, VersionManager.installedManifest(model.id))
                             }
                         }
                     }
@@ -106,7 +108,8 @@ Item {
                     Layout.fillWidth: true
                     text: "Refresh Versions"
                     Material.background: Material.accent
-                    // onClicked: VersionManager.refreshVersions()
+                    enabled: !VersionManager.isLoading
+                    onClicked: VersionManager.refreshVersions()
                 }
             }
         }
@@ -168,6 +171,13 @@ Item {
                             color: Material.hintTextColor
                         }
                         
+                        Text {
+                            text: "Preloading game files..."
+                            font.pixelSize: 12
+                            color: Material.hintTextColor
+                            visible: GameLauncher.isWarming
+                        }
+                        
                         Item { Layout.fillHeight: true }
                         
                         ProgressBar {
@@ -198,7 +208,8 @@ Item {
                     
                     enabled: selectedVersion !== null && AuthManager.isLoggedIn
                     
-                    // onClicked: GameLauncher.launchGame(...)
+                    onClicked: GameLauncher.installAndLaunch(selectedVersion.id,
+                                                             VersionManager.resolvedManifest(selectedVersion.id))
                 }
                 
                 Item { Layout.fillWidth: true }
@@ -217,6 +228,218 @@ Item {
                 }
             }
             
+            // Launch timeline
+            Rectangle {
+                Layout.fillWidth: true
+                Layout.preferredHeight: launchTimelineColumn.implicitHeight + 30
+                color: Material.backgroundDimColor
+                radius: 10
+                visible: GameLauncher.launchTimeline.length > 0
+
+                ColumnLayout {
+                    id: launchTimelineColumn
+                    anchors.fill: parent
+                    anchors.margins: 15
+                    spacing: 6
+
+                    Text {
+                        text: GameLauncher.lastLaunchMs > 0
+                              ? "Last Launch: " + GameLauncher.lastLaunchMs + " ms"
+                              : "Launching..."
+                        font.pixelSize: 16
+                        font.bold: true
+                        color: Material.foreground
+                    }
+
+                    Flow {
+                        Layout.fillWidth: true
+                        spacing: 8
+
+                        Repeater {
+                            model: GameLauncher.launchTimeline
+
+                            Rectangle {
+                                width: timelineEntryText.implicitWidth + 16
+                                height: 24
+                                radius: 12
+                                color: modelData.kind === "milestone" ? Material.accent : "transparent"
+                                border.color: Material.dividerColor
+                                border.width: 1
+
+                                Text {
+                                    id: timelineEntryText
+                                    anchors.centerIn: parent
+                                    text: modelData.kind === "milestone"
+                                          ? modelData.name + " @ " + modelData.startMs + " ms"
+                                          : modelData.name + " " + modelData.durationMs + " ms"
+                                    font.pixelSize: 11
+                                    color: Material.foreground
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+
+            // Running instances
+            Rectangle {
+                Layout.fillWidth: true
+                Layout.preferredHeight: Math.min(instancesView.contentHeight, 160) + 50
+                color: Material.backgroundDimColor
+                radius: 10
+                visible: GameLauncher.instances.count > 0
+
+                ColumnLayout {
+                    anchors.fill: parent
+                    anchors.margins: 15
+                    spacing: 6
+
+                    RowLayout {
+                        Layout.fillWidth: true
+
+                        Text {
+                            text: "Instances (" + GameLauncher.instances.runningCount + " running)"
+                            font.pixelSize: 16
+                            font.bold: true
+                            color: Material.foreground
+                        }
+
+                        Item { Layout.fillWidth: true }
+
+                        Button {
+                            text: "Clear Ended"
+                            flat: true
+                            onClicked: GameLauncher.instances.clearEnded()
+                        }
+
+                        Button {
+                            text: "Kill All"
+                            flat: true
+                            enabled: GameLauncher.instances.runningCount > 0
+                            onClicked: GameLauncher.instances.killAll()
+                        }
+                    }
+
+                    ListView {
+                        id: instancesView
+                        Layout.fillWidth: true
+                        Layout.fillHeight: true
+                        clip: true
+                        model: GameLauncher.instances
+
+                        delegate: ItemDelegate {
+                            width: instancesView.width
+                            height: 32
+                            highlighted: GameLauncher.output === model.instance.output
+                            onClicked: GameLauncher.showInstance(model.instanceId)
+
+                            RowLayout {
+                                anchors.fill: parent
+                                anchors.leftMargin: 8
+                                anchors.rightMargin: 8
+
+                                Text {
+                                    Layout.fillWidth: true
+                                    text: "#" + model.instanceId + "  " + model.versionId + "  " + model.state
+                                          + (model.state === "running" ? "  pid " + model.pid : "")
+                                    font.pixelSize: 12
+                                    color: model.state === "crashed" || model.state === "failed"
+                                           ? Material.color(Material.Red) : Material.foreground
+                                }
+
+                                Text {
+                                    text: model.state === "running" && model.threads > 0
+                                          ? model.cpuPercent.toFixed(0) + "% CPU, "
+                                            + Math.round(model.rss / 1048576) + " MB, "
+                                            + model.threads + " threads, "
+                                            + model.majorFaultRate.toFixed(0) + " faults/s, "
+                                            + "I/O " + Math.round(model.readRate / 1024) + "/"
+                                            + Math.round(model.writeRate / 1024) + " KB/s"
+                                          : model.outputLines + " lines"
+                                            + (model.cpuMs >= 0 ? ", CPU " + (model.cpuMs / 1000).toFixed(1) + " s" : "")
+                                            + (model.peakRss >= 0 ? ", peak " + Math.round(model.peakRss / 1048576) + " MB" : "")
+                                    font.pixelSize: 11
+                                    color: Material.hintTextColor
+                                }
+
+                                Button {
+                                    text: model.state === "running" || model.state === "preparing" ? "Kill" : "Remove"
+                                    flat: true
+                                    onClicked: model.state === "running" || model.state === "preparing"
+                                               ? GameLauncher.instances.kill(model.instanceId)
+                                               : GameLauncher.instances.remove(model.instanceId)
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+
+            // Game output console
+            Rectangle {
+                Layout.fillWidth: true
+                Layout.preferredHeight: 220
+                color: Material.backgroundDimColor
+                radius: 10
+                visible: GameLauncher.output.count > 0
+
+                ColumnLayout {
+                    anchors.fill: parent
+                    anchors.margins: 15
+                    spacing: 6
+
+                    RowLayout {
+                        Layout.fillWidth: true
+
+                        Text {
+                            text: "Game Output"
+                            font.pixelSize: 16
+                            font.bold: true
+                            color: Material.foreground
+                        }
+
+                        Item { Layout.fillWidth: true }
+
+                        Text {
+                            text: GameLauncher.output.droppedLines > 0
+                                  ? GameLauncher.output.droppedLines + " older lines in " + GameLauncher.logFilePath
+                                  : GameLauncher.logFilePath
+                            font.pixelSize: 10
+                            color: Material.hintTextColor
+                            elide: Text.ElideLeft
+                            Layout.maximumWidth: 400
+                        }
+                    }
+
+                    ListView {
+                        id: outputView
+                        Layout.fillWidth: true
+                        Layout.fillHeight: true
+                        clip: true
+                        model: GameLauncher.output
+                        reuseItems: true
+
+                        // Follow the tail unless the user scrolled up
+                        property bool followTail: true
+                        onMovementEnded: followTail = atYEnd
+                        onCountChanged: if (followTail) positionViewAtEnd()
+
+                        delegate: Text {
+                            width: outputView.width
+                            text: model.text
+                            font.family: "monospace"
+                            font.pixelSize: 11
+                            wrapMode: Text.NoWrap
+                            elide: Text.ElideRight
+                            color: model.level === "ERROR" || model.level === "FATAL" || model.isError
+                                   ? Material.color(Material.Red)
+                                   : model.level === "WARN" ? Material.color(Material.Orange)
+                                                            : Material.foreground
+                        }
+                    }
+                }
+            }
+
             // Recent activity / News
             Rectangle {
                 Layout.fillWidth: true
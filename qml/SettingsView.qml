@@ -108,6 +108,45 @@ Item {
                             }
                         }
                         
+                        // Detected runtimes
+                        RowLayout {
+                            Layout.fillWidth: true
+                            
+                            Label {
+                                Layout.preferredWidth: 120
+                                text: "Detected Java:"
+                                color: Material.foreground
+                            }
+                            
+                            ComboBox {
+                                Layout.fillWidth: true
+                                textRole: "label"
+                                valueRole: "path"
+                                model: [{ path: "java", label: "Automatic (best match per version)" }].concat(
+                                           JavaRuntimes.runtimes.map(function(runtime) {
+                                               return { path: runtime.path,
+                                                        label: "Java " + runtime.version + " (" + runtime.vendor + ", "
+                                                               + runtime.arch + ") - " + runtime.path }
+                                           }))
+                                currentIndex: Math.max(0, indexOfValue(ConfigManager.javaPath))
+                                onActivated: ConfigManager.javaPath = currentValue
+                            }
+                            
+                            BusyIndicator {
+                                Layout.preferredWidth: 32
+                                Layout.preferredHeight: 32
+                                running: JavaRuntimes.isScanning
+                                visible: running
+                            }
+                            
+                            Button {
+                                text: "Rescan"
+                                Material.background: Material.backgroundDimColor
+                                enabled: !JavaRuntimes.isScanning
+                                onClicked: JavaRuntimes.scan()
+                            }
+                        }
+                        
                         // Memory Settings
                         RowLayout {
                             Layout.fillWidth: true
@@ -141,6 +180,304 @@ Item {
                                 color: Material.hintTextColor
                             }
                         }
+
+                        // Concurrent clients
+                        RowLayout {
+                            Layout.fillWidth: true
+                            
+                            Label {
+                                Layout.preferredWidth: 120
+                                text: "Max Instances:"
+                                color: Material.foreground
+                            }
+                            
+                            SpinBox {
+                                from: 1
+                                to: 64
+                                value: ConfigManager.maxInstances
+                                
+                                Material.background: Material.backgroundColor
+                                
+                                onValueModified: ConfigManager.maxInstances = value
+                            }
+                            
+                            Item { Layout.fillWidth: true }
+                        }
+
+                        // Resource monitor
+                        RowLayout {
+                            Layout.fillWidth: true
+                            
+                            Label {
+                                Layout.preferredWidth: 120
+                                text: "Monitor (ms):"
+                                color: Material.foreground
+                            }
+                            
+                            SpinBox {
+                                from: 0
+                                to: 10000
+                                stepSize: 250
+                                value: ConfigManager.monitorIntervalMs
+                                
+                                Material.background: Material.backgroundColor
+                                
+                                onValueModified: ConfigManager.monitorIntervalMs = value
+                            }
+                            
+                            Label {
+                                text: "(0 = off)"
+                                color: Material.hintTextColor
+                            }
+                            
+                            Item { Layout.fillWidth: true }
+                        }
+
+                        // JVM tuning profile
+                        RowLayout {
+                            Layout.fillWidth: true
+
+                            Label {
+                                Layout.preferredWidth: 120
+                                text: "JVM Profile:"
+                                color: Material.foreground
+                            }
+
+                            ComboBox {
+                                id: jvmProfileCombo
+                                Layout.preferredWidth: 220
+                                textRole: "label"
+                                valueRole: "name"
+                                model: [
+                                    { name: "auto", label: "Automatic" },
+                                    { name: "low-latency", label: "Low latency (G1)" },
+                                    { name: "throughput", label: "Throughput (Parallel)" },
+                                    { name: "zgc", label: "Generational ZGC (Java 21+)" },
+                                    { name: "low-memory", label: "Low memory" }
+                                ]
+                                Component.onCompleted: currentIndex = indexOfValue(ConfigManager.jvmProfile)
+                                onActivated: ConfigManager.jvmProfile = currentValue
+                            }
+
+                            Item { Layout.fillWidth: true }
+                        }
+
+                        // Integrity check of the game files
+                        RowLayout {
+                            Layout.fillWidth: true
+
+                            Label {
+                                Layout.preferredWidth: 120
+                                text: "Verify Files:"
+                                color: Material.foreground
+                            }
+
+                            ComboBox {
+                                Layout.preferredWidth: 220
+                                textRole: "label"
+                                valueRole: "name"
+                                model: [
+                                    { name: "parallel", label: "While the game starts" },
+                                    { name: "before", label: "Before every launch" },
+                                    { name: "stat", label: "Sizes only" }
+                                ]
+                                Component.onCompleted: currentIndex = indexOfValue(ConfigManager.launchVerification)
+                                onActivated: ConfigManager.launchVerification = currentValue
+                            }
+
+                            Item { Layout.fillWidth: true }
+                        }
+
+                        CheckBox {
+                            text: "Class data sharing (faster startup after the first launch, Java 13+)"
+                            checked: ConfigManager.appCdsEnabled
+                            onToggled: ConfigManager.appCdsEnabled = checked
+                        }
+
+                        CheckBox {
+                            text: "Keep games running when the launcher closes"
+                            checked: ConfigManager.detachGames
+                            onToggled: ConfigManager.detachGames = checked
+                        }
+
+                        CheckBox {
+                            text: "Slow down downloads and file checks while a game is running"
+                            checked: ConfigManager.throttleWhilePlaying
+                            onToggled: ConfigManager.throttleWhilePlaying = checked
+                        }
+
+                        // Download ceiling while throttled
+                        RowLayout {
+                            Layout.fillWidth: true
+                            enabled: ConfigManager.throttleWhilePlaying
+
+                            Label {
+                                Layout.preferredWidth: 120
+                                text: "In-game (KB/s):"
+                                color: Material.foreground
+                            }
+
+                            SpinBox {
+                                from: 0
+                                to: 102400
+                                stepSize: 256
+                                value: ConfigManager.playingBandwidthKBps
+
+                                Material.background: Material.backgroundColor
+
+                                onValueModified: ConfigManager.playingBandwidthKBps = value
+                            }
+
+                            Label {
+                                text: "(0 = no limit)"
+                                color: Material.hintTextColor
+                            }
+
+                            Item { Layout.fillWidth: true }
+                        }
+
+                        CheckBox {
+                            text: "Minimal launcher while playing (frees memory, hides instances and console)"
+                            checked: ConfigManager.minimalWhilePlaying
+                            onToggled: ConfigManager.minimalWhilePlaying = checked
+                        }
+                    }
+                }
+                
+                // Process placement of the current profile's games
+                GroupBox {
+                    id: placementGroup
+                    Layout.fillWidth: true
+                    title: "Process Placement"
+                    enabled: ConfigManager.currentProfile !== null
+                    
+                    property var placement: ConfigManager.currentProfile ? ConfigManager.currentProfile.placement : ({})
+                    
+                    function setPlacement(key, value) {
+                        var updated = Object.assign({}, placement)
+                        updated[key] = value
+                        ConfigManager.currentProfile.placement = updated
+                    }
+                    
+                    Material.background: Material.backgroundDimColor
+                    
+                    ColumnLayout {
+                        anchors.fill: parent
+                        spacing: 15
+                        
+                        RowLayout {
+                            Layout.fillWidth: true
+                            
+                            Label {
+                                Layout.preferredWidth: 120
+                                text: "CPUs:"
+                                color: Material.foreground
+                            }
+                            
+                            TextField {
+                                Layout.fillWidth: true
+                                text: placementGroup.placement.cpus || ""
+                                placeholderText: "all (e.g. 0-7,16)"
+                                
+                                Material.background: Material.backgroundColor
+                                
+                                onEditingFinished: placementGroup.setPlacement("cpus", text)
+                            }
+                        }
+                        
+                        RowLayout {
+                            Layout.fillWidth: true
+                            
+                            Label {
+                                Layout.preferredWidth: 120
+                                text: "Disk Priority:"
+                                color: Material.foreground
+                            }
+                            
+                            ComboBox {
+                                Layout.preferredWidth: 220
+                                textRole: "label"
+                                valueRole: "name"
+                                model: [
+                                    { name: "default", label: "Default" },
+                                    { name: "best-effort", label: "Best effort" },
+                                    { name: "idle", label: "Idle" }
+                                ]
+                                currentIndex: Math.max(0, indexOfValue(placementGroup.placement.ioClass || "default"))
+                                onActivated: placementGroup.setPlacement("ioClass", currentValue)
+                            }
+                            
+                            Item { Layout.fillWidth: true }
+                        }
+                        
+                        RowLayout {
+                            Layout.fillWidth: true
+                            
+                            Label {
+                                Layout.preferredWidth: 120
+                                text: "Memory Limit:"
+                                color: Material.foreground
+                            }
+                            
+                            SpinBox {
+                                from: 0
+                                to: 65536
+                                stepSize: 512
+                                value: placementGroup.placement.memoryLimitMB || 0
+                                
+                                Material.background: Material.backgroundColor
+                                
+                                onValueModified: placementGroup.setPlacement("memoryLimitMB", value)
+                            }
+                            
+                            Label {
+                                text: "MB (0 = none)"
+                                color: Material.hintTextColor
+                            }
+                            
+                            Item { Layout.fillWidth: true }
+                        }
+                        
+                        RowLayout {
+                            Layout.fillWidth: true
+                            
+                            Label {
+                                Layout.preferredWidth: 120
+                                text: "CPU Limit:"
+                                color: Material.foreground
+                            }
+                            
+                            SpinBox {
+                                from: 0
+                                to: 6400
+                                stepSize: 50
+                                value: placementGroup.placement.cpuLimitPercent || 0
+                                
+                                Material.background: Material.backgroundColor
+                                
+                                onValueModified: placementGroup.setPlacement("cpuLimitPercent", value)
+                            }
+                            
+                            Label {
+                                text: "% of one core (0 = none)"
+                                color: Material.hintTextColor
+                            }
+                            
+                            Item { Layout.fillWidth: true }
+                        }
+                        
+                        CheckBox {
+                            text: "Run in the background (lower CPU priority, batch scheduling)"
+                            checked: placementGroup.placement.background === true
+                            onToggled: placementGroup.setPlacement("background", checked)
+                        }
+                        
+                        Label {
+                            Layout.fillWidth: true
+                            text: "Limits need a writable cgroup v2 hierarchy; without one they are skipped."
+                            color: Material.hintTextColor
+                            wrapMode: Text.WordWrap
+                        }
                     }
                 }
                 
@@ -110,6 +110,7 @@ ApplicationWindow {
                     Button {
                         text: "Settings"
                         Material.background: Material.backgroundDimColor
+                        enabled: !InGameMode.active
                         onClicked: stackView.push(settingsComponent)
                     }
                 }
@@ -127,6 +128,9 @@ ApplicationWindow {
             Connections {
                 target: AuthManager
                 function onLoginStatusChanged() {
+                    if (InGameMode.active) {
+                        return
+                    }
                     if (AuthManager.isLoggedIn) {
                         stackView.replace(mainViewComponent)
                     } else {
@@ -134,6 +138,19 @@ ApplicationWindow {
                     }
                 }
             }
+            
+            // The full views are destroyed while a game runs and rebuilt after it
+            Connections {
+                target: InGameMode
+                function onActiveChanged() {
+                    if (InGameMode.active) {
+                        stackView.replace(null, inGameComponent, {}, StackView.Immediate)
+                    } else {
+                        stackView.replace(null, AuthManager.isLoggedIn ? mainViewComponent : loginViewComponent,
+                                          {}, StackView.Immediate)
+                    }
+                }
+            }
         }
     }
     
@@ -153,6 +170,50 @@ ApplicationWindow {
         SettingsView {}
     }
     
+    Component {
+        id: inGameComponent
+        
+        Item {
+            ColumnLayout {
+                anchors.centerIn: parent
+                spacing: 15
+                
+                Text {
+                    Layout.alignment: Qt.AlignHCenter
+                    text: GameLauncher.currentVersion !== "" ? "Playing " + GameLauncher.currentVersion : "Game running"
+                    font.pixelSize: 24
+                    font.bold: true
+                    color: Material.foreground
+                }
+                
+                Text {
+                    Layout.alignment: Qt.AlignHCenter
+                    text: GameLauncher.logFilePath
+                    font.pixelSize: 12
+                    color: Material.hintTextColor
+                    visible: text !== ""
+                }
+                
+                RowLayout {
+                    Layout.alignment: Qt.AlignHCenter
+                    spacing: 10
+                    
+                    Button {
+                        text: "Show Launcher"
+                        Material.background: Material.backgroundDimColor
+                        onClicked: InGameMode.restore()
+                    }
+                    
+                    Button {
+                        text: GameLauncher.instances.runningCount > 1 ? "Stop All" : "Stop Game"
+                        Material.background: Material.Red
+                        onClicked: GameLauncher.instances.killAll()
+                    }
+                }
+            }
+        }
+    }
+    
     // Loading overlay
     Rectangle {
         anchors.fill: parent
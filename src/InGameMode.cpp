@@ -0,0 +1,113 @@
+#include "InGameMode.h"
+#include "auth/AuthManager.h"
+#include "config/ConfigManager.h"
+#include "version/VersionManager.h"
+#include "version/ManifestCache.h"
+#include "launcher/GameLauncher.h"
+#include "utils/CompiledManifest.h"
+#include "utils/ProcessMemory.h"
+#include <QQmlEngine>
+#include <QQuickWindow>
+#include <QGuiApplication>
+#include <QLoggingCategory>
+
+Q_LOGGING_CATEGORY(inGameMode, "cryovex.main.ingame")
+
+namespace {
+
+// Lets the unloaded views and the web view be deleted before trimming
+const int RELEASE_DELAY_MS = 2000;
+
+}
+
+InGameMode::InGameMode(QQmlEngine* engine, GameLauncher* gameLauncher, VersionManager* versionManager,
+                       QObject *parent)
+    : QObject(parent)
+    , m_engine(engine)
+    , m_gameLauncher(gameLauncher)
+    , m_versionManager(versionManager)
+{
+    m_releaseTimer.setSingleShot(true);
+    m_releaseTimer.setInterval(RELEASE_DELAY_MS);
+    connect(&m_releaseTimer, &QTimer::timeout, this, &InGameMode::releaseMemory);
+
+    connect(gameLauncher, &GameLauncher::gameStarted, this, &InGameMode::enter);
+    connect(&ConfigManager::instance(), &ConfigManager::minimalWhilePlayingChanged, this, &InGameMode::onSettingChanged);
+    connect(gameLauncher, &GameLauncher::runningStatusChanged, this, [this]() {
+        if (!m_gameLauncher->isRunning()) {
+            m_restored = false;
+            leave();
+        }
+    });
+}
+
+void InGameMode::enter()
+{
+    if (m_active || m_restored || !ConfigManager::instance().minimalWhilePlaying()) {
+        return;
+    }
+    m_residentBefore = ProcessMemory::residentBytes();
+    qCInfo(inGameMode) << "Entering in-game mode, launcher RSS" << m_residentBefore / 1024 << "KiB";
+
+    // QML replaces the views right away; their items are deleted later
+    m_active = true;
+    emit activeChanged();
+
+    AuthManager::instance().releaseResources();
+    ManifestCache::instance().trim();
+    CompiledManifest::clearCache();
+    m_versionManager->releaseCaches();
+
+    m_releaseTimer.start();
+}
+
+void InGameMode::restore()
+{
+    m_restored = true;
+    leave();
+}
+
+void InGameMode::onSettingChanged()
+{
+    if (!ConfigManager::instance().minimalWhilePlaying()) {
+        leave();
+    } else if (m_gameLauncher->isRunning()) {
+        enter();
+    }
+}
+
+void InGameMode::leave()
+{
+    if (!m_active) {
+        return;
+    }
+    m_releaseTimer.stop();
+    qCInfo(inGameMode) << "Leaving in-game mode, launcher RSS" << ProcessMemory::residentBytes() / 1024 << "KiB";
+
+    m_active = false;
+    emit activeChanged();
+}
+
+void InGameMode::releaseMemory()
+{
+    if (!m_active) {
+        return;
+    }
+
+    if (m_engine) {
+        m_engine->collectGarbage();
+        m_engine->trimComponentCache();
+    }
+    // Scene graph textures, glyph caches and the like of the hidden views
+    for (QWindow* window : QGuiApplication::topLevelWindows()) {
+        if (auto* quickWindow = qobject_cast<QQuickWindow*>(window)) {
+            quickWindow->releaseResources();
+        }
+    }
+    ProcessMemory::releaseFreeHeap();
+
+    const qint64 residentAfter = ProcessMemory::residentBytes();
+    qCInfo(inGameMode) << "In-game mode released memory: launcher RSS" << m_residentBefore / 1024 << "KiB ->"
+                       << residentAfter / 1024 << "KiB";
+    emit released(m_residentBefore, residentAfter);
+}
\ No newline at end of file
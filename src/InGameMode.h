@@ -0,0 +1,48 @@
+#pragma once
+
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+
+class QQmlEngine;
+class GameLauncher;
+class VersionManager;
+
+// Shrinks the launcher while a game runs, leaving the memory to the JVM:
+// the QML views go (main.qml swaps in a small panel), as do the login web
+// view, parsed manifests and the QML engine's caches, and freed heap is
+// handed back to the system. All of it is rebuilt on demand after the game.
+// Opt-in (ConfigManager::minimalWhilePlaying): the instance list, console
+// and monitor come back through restore().
+class InGameMode : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(bool active READ isActive NOTIFY activeChanged)
+
+public:
+    InGameMode(QQmlEngine* engine, GameLauncher* gameLauncher, VersionManager* versionManager,
+               QObject *parent = nullptr);
+
+    bool isActive() const { return m_active; }
+    // Brings the full views back until the last game exits
+    Q_INVOKABLE void restore();
+
+signals:
+    void activeChanged();
+    // Launcher RSS before entering and once everything was released
+    void released(qint64 bytesBefore, qint64 bytesAfter);
+
+private:
+    void enter();
+    void onSettingChanged();
+    void leave();
+    void releaseMemory();
+
+    QPointer<QQmlEngine> m_engine;
+    GameLauncher* m_gameLauncher;
+    VersionManager* m_versionManager;
+    QTimer m_releaseTimer;
+    bool m_active = false;
+    bool m_restored = false;
+    qint64 m_residentBefore = -1;
+};
\ No newline at end of file
@@ -23,12 +23,22 @@ AuthManager::AuthManager(QObject *parent)
             this, &AuthManager::onAuthenticationCompleted);
     connect(m_microsoftAuth, &MicrosoftAuth::authenticationError,
             this, &AuthManager::onAuthenticationError);
+    
+    m_refreshTimer.setSingleShot(true);
+    connect(&m_refreshTimer, &QTimer::timeout, this, &AuthManager::refreshToken);
 }
 
 void AuthManager::initialize()
 {
     qCInfo(authManager) << "Initializing AuthManager";
     loadSavedAuth();
+    
+    // Expired while the launcher was closed
+    if (m_isLoggedIn && !hasValidToken()) {
+        refreshToken();
+    } else {
+        scheduleRefresh();
+    }
 }
 
 void AuthManager::login()
@@ -38,9 +48,18 @@ void AuthManager::login()
     m_microsoftAuth->startAuthentication();
 }
 
+void AuthManager::releaseResources()
+{
+    if (m_isLoading) {
+        return;
+    }
+    m_microsoftAuth->releaseResources();
+}
+
 void AuthManager::logout()
 {
     qCInfo(authManager) << "Logging out user:" << m_username;
+    m_refreshTimer.stop();
     clearAuth();
     setLoggedIn(false);
     setUserInfo(QString(), QString());
@@ -48,18 +67,33 @@ void AuthManager::logout()
 
 void AuthManager::refreshToken()
 {
-    if (m_refreshToken.isEmpty()) {
-        qCWarning(authManager) << "No refresh token available";
-        emit loginError("No refresh token available");
+    if (m_isLoading || m_refreshing) {
         return;
     }
     
     qCInfo(authManager) << "Refreshing access token";
-    setLoading(true);
-    
-    // TODO: Implement token refresh logic
-    // For now, just re-authenticate
-    login();
+    m_refreshing = true;
+    if (!m_microsoftAuth->refresh()) {
+        m_refreshing = false;
+        qCWarning(authManager) << "No refresh token available";
+        onAuthenticationError("No refresh token available");
+    }
+}
+
+bool AuthManager::hasValidToken() const
+{
+    return !m_accessToken.isEmpty() && m_expiresAt.isValid() && m_expiresAt > QDateTime::currentDateTimeUtc();
+}
+
+void AuthManager::scheduleRefresh()
+{
+    if (!m_isLoggedIn || !m_expiresAt.isValid()) {
+        m_refreshTimer.stop();
+        return;
+    }
+    // QTimer takes an int, so very distant expiries are rechecked every few days
+    const qint64 delay = QDateTime::currentDateTimeUtc().msecsTo(m_expiresAt) - REFRESH_AHEAD_MS;
+    m_refreshTimer.start(int(qBound<qint64>(0, delay, qint64(7) * 24 * 60 * 60 * 1000)));
 }
 
 void AuthManager::onAuthenticationCompleted(const QJsonObject& authData)
@@ -68,6 +102,7 @@ void AuthManager::onAuthenticationCompleted(const QJsonObject& authData)
     
     m_accessToken = authData["access_token"].toString();
     m_refreshToken = authData["refresh_token"].toString();
+    m_expiresAt = QDateTime::fromString(authData["expires_at"].toString(), Qt::ISODate);
     m_username = authData["username"].toString();
     m_uuid = authData["uuid"].toString();
     
@@ -76,13 +111,30 @@ void AuthManager::onAuthenticationCompleted(const QJsonObject& authData)
     setLoading(false);
     
     saveAuth();
-    emit loginSuccess();
+    scheduleRefresh();
+    
+    const bool refreshed = m_refreshing;
+    m_refreshing = false;
+    if (!refreshed) {
+        emit loginSuccess();
+    }
 }
 
 void AuthManager::onAuthenticationError(const QString& error)
 {
     qCWarning(authManager) << "Authentication error:" << error;
     setLoading(false);
+    
+    // A failed background refresh only matters once the token is gone
+    if (m_refreshing) {
+        m_refreshing = false;
+        saveAuth(); // a rejected refresh token is dropped
+        if (hasValidToken()) {
+            m_refreshTimer.start(RETRY_DELAY_MS);
+            return;
+        }
+        setLoggedIn(false);
+    }
     emit loginError(error);
 }
 
@@ -144,9 +196,17 @@ void AuthManager::loadSavedAuth()
     QJsonObject authData = doc.object();
     m_accessToken = authData["access_token"].toString();
     m_refreshToken = authData["refresh_token"].toString();
+    m_expiresAt = QDateTime::fromString(authData["expires_at"].toString(), Qt::ISODate);
     m_username = authData["username"].toString();
     m_uuid = authData["uuid"].toString();
     
+    // Files from before per-stage caching only have the refresh token
+    QJsonObject tokens = authData["tokens"].toObject();
+    if (tokens.isEmpty()) {
+        tokens["refreshToken"] = m_refreshToken;
+    }
+    m_microsoftAuth->restoreTokens(tokens);
+    
     if (!m_accessToken.isEmpty() && !m_username.isEmpty()) {
         setUserInfo(m_username, m_uuid);
         setLoggedIn(true);
@@ -163,8 +223,10 @@ void AuthManager::saveAuth()
     QJsonObject authData;
     authData["access_token"] = m_accessToken;
     authData["refresh_token"] = m_refreshToken;
+    authData["expires_at"] = m_expiresAt.toString(Qt::ISODate);
     authData["username"] = m_username;
     authData["uuid"] = m_uuid;
+    authData["tokens"] = m_microsoftAuth->tokens();
     
     QFile authFile(authFilePath);
     if (!authFile.open(QIODevice::WriteOnly)) {
@@ -181,6 +243,8 @@ void AuthManager::clearAuth()
 {
     m_accessToken.clear();
     m_refreshToken.clear();
+    m_expiresAt = QDateTime();
+    m_microsoftAuth->restoreTokens(QJsonObject());
     
     QString appDataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
     QString authFilePath = QDir(appDataPath).filePath("auth.json");
@@ -7,9 +7,13 @@
 #include <QJsonDocument>
 #include <QWebEngineView>
 #include <QTimer>
+#include <QDateTime>
 
 class MicrosoftAuth;
 
+// The signed-in account. Tokens persist in auth.json with their expiries;
+// a restart reuses them, and a timer renews the Minecraft token silently
+// from the refresh token shortly before it expires.
 class AuthManager : public QObject
 {
     Q_OBJECT
@@ -28,10 +32,14 @@ public:
     QString uuid() const { return m_uuid; }
     QString accessToken() const { return m_accessToken; }
     bool isLoading() const { return m_isLoading; }
+    
+    // Frees the login web view while it is not needed
+    void releaseResources();
 
 public slots:
     void login();
     void logout();
+    // Silent: no browser, no loading state
     void refreshToken();
 
 signals:
@@ -56,13 +64,22 @@ private:
     void loadSavedAuth();
     void saveAuth();
     void clearAuth();
+    void scheduleRefresh();
+    bool hasValidToken() const;
+
+    // Renew this long before the Minecraft token expires
+    static const qint64 REFRESH_AHEAD_MS = 15 * 60 * 1000;
+    static const int RETRY_DELAY_MS = 60 * 1000;
 
     bool m_isLoggedIn = false;
     QString m_username;
     QString m_uuid;
     QString m_accessToken;
     QString m_refreshToken;
+    QDateTime m_expiresAt;
     bool m_isLoading = false;
+    bool m_refreshing = false;
     
     MicrosoftAuth* m_microsoftAuth;
+    QTimer m_refreshTimer;
 };
\ No newline at end of file
@@ -12,9 +12,61 @@
 #include <QRandomGenerator>
 #include <QWebEngineSettings>
 #include <QWebEngineProfile>
+#include <QEventLoop>
+#include <QVector>
+#include <algorithm>
 
 Q_LOGGING_CATEGORY(microsoftAuth, "cryovex.auth.microsoft")
 
+namespace {
+
+const char* TOKEN_URL = "https://login.microsoftonline.com/consumers/oauth2/v2.0/token";
+const char* XBOX_LIVE_URL = "https://user.auth.xboxlive.com/user/authenticate";
+const char* XSTS_URL = "https://xsts.auth.xboxlive.com/xsts/authorize";
+const char* MINECRAFT_LOGIN_URL = "https://api.minecraftservices.com/authentication/login_with_xbox";
+const char* PROFILE_URL = "https://api.minecraftservices.com/minecraft/profile";
+const char* ENTITLEMENTS_URL = "https://api.minecraftservices.com/entitlements/mcstore";
+
+const qint64 EXPIRY_MARGIN_S = 5 * 60;
+// When a response carries no expiry
+const qint64 DEFAULT_LIFETIME_S = 60 * 60;
+
+QDateTime expiryIn(qint64 seconds)
+{
+    return QDateTime::currentDateTimeUtc().addSecs(seconds > 0 ? seconds : DEFAULT_LIFETIME_S);
+}
+
+// Xbox NotAfter has seven fractional digits, more than Qt parses
+QDateTime expiryAt(const QString& notAfter)
+{
+    const QDateTime expiry = QDateTime::fromString(notAfter.left(19) + "Z", Qt::ISODate);
+    return expiry.isValid() ? expiry : expiryIn(0);
+}
+
+}
+
+bool MicrosoftAuth::Token::isValid() const
+{
+    return !value.isEmpty() && expiresAt.isValid()
+           && QDateTime::currentDateTimeUtc().secsTo(expiresAt) > EXPIRY_MARGIN_S;
+}
+
+QJsonObject MicrosoftAuth::Token::toJson() const
+{
+    QJsonObject json;
+    json["value"] = value;
+    json["expiresAt"] = expiresAt.toString(Qt::ISODate);
+    return json;
+}
+
+MicrosoftAuth::Token MicrosoftAuth::Token::fromJson(const QJsonObject& json)
+{
+    Token token;
+    token.value = json["value"].toString();
+    token.expiresAt = QDateTime::fromString(json["expiresAt"].toString(), Qt::ISODate);
+    return token;
+}
+
 MicrosoftAuth::MicrosoftAuth(QObject *parent)
     : QObject(parent)
     , m_webView(nullptr)
@@ -56,6 +108,9 @@ void MicrosoftAuth::startAuthentication()
         return;
     }
     
+    // A new sign-in may be a different account
+    clearTokens();
+    
     // Generate PKCE parameters
     m_codeVerifier = generateCodeVerifier();
     QString codeChallenge = generateCodeChallenge(m_codeVerifier);
@@ -83,6 +138,138 @@ void MicrosoftAuth::startAuthentication()
     m_webView->activateWindow();
 }
 
+bool MicrosoftAuth::refresh()
+{
+    if (m_running) {
+        return true;
+    }
+    if (m_refreshToken.isEmpty() && !m_msa.isValid() && !m_xbl.isValid() && !m_xsts.isValid()) {
+        return false;
+    }
+    
+    qCInfo(microsoftAuth) << "Refreshing Minecraft token silently";
+    m_minecraft = Token();
+    beginChain();
+    return true;
+}
+
+QJsonObject MicrosoftAuth::tokens() const
+{
+    QJsonObject json;
+    json["msa"] = m_msa.toJson();
+    json["refreshToken"] = m_refreshToken;
+    json["xbl"] = m_xbl.toJson();
+    json["xsts"] = m_xsts.toJson();
+    json["userHash"] = m_userHash;
+    json["minecraft"] = m_minecraft.toJson();
+    return json;
+}
+
+void MicrosoftAuth::restoreTokens(const QJsonObject& tokens)
+{
+    m_msa = Token::fromJson(tokens["msa"].toObject());
+    m_refreshToken = tokens["refreshToken"].toString();
+    m_xbl = Token::fromJson(tokens["xbl"].toObject());
+    m_xsts = Token::fromJson(tokens["xsts"].toObject());
+    m_userHash = tokens["userHash"].toString();
+    m_minecraft = Token::fromJson(tokens["minecraft"].toObject());
+}
+
+void MicrosoftAuth::clearTokens()
+{
+    m_msa = Token();
+    m_refreshToken.clear();
+    m_xbl = Token();
+    m_xsts = Token();
+    m_userHash.clear();
+    m_minecraft = Token();
+}
+
+QUrl MicrosoftAuth::endpoint(const QString& url) const
+{
+    // Only benchmark instances have an override; real sign-ins always go to the services
+    QUrl result(url);
+    if (!m_endpointOverride.isEmpty()) {
+        result.setScheme(m_endpointOverride.scheme());
+        result.setHost(m_endpointOverride.host());
+        result.setPort(m_endpointOverride.port());
+    }
+    return result;
+}
+
+void MicrosoftAuth::beginChain()
+{
+    m_running = true;
+    m_chainTimer.start();
+    if (m_pipelined) {
+        preconnect();
+    }
+    continueChain();
+}
+
+void MicrosoftAuth::continueChain()
+{
+    if (m_minecraft.isValid()) {
+        // Independent of each other, so both go out at once
+        m_profile = QJsonObject();
+        m_ownsMinecraft = false;
+        m_pendingRequests = 2;
+        fetchMinecraftProfile(m_minecraft.value);
+        if (m_pipelined) {
+            fetchEntitlements(m_minecraft.value);
+        }
+    } else if (m_xsts.isValid() && !m_userHash.isEmpty()) {
+        authenticateWithMinecraft(m_xsts.value, m_userHash);
+    } else if (m_xbl.isValid()) {
+        authenticateWithXsts(m_xbl.value);
+    } else if (m_msa.isValid()) {
+        authenticateWithXboxLive(m_msa.value);
+    } else if (!m_refreshToken.isEmpty()) {
+        refreshMicrosoftToken();
+    } else {
+        fail("Sign-in required");
+    }
+}
+
+void MicrosoftAuth::preconnect()
+{
+    // TCP and TLS handshakes with the later hosts overlap the first hops
+    QStringList seen;
+    for (const char* url : {TOKEN_URL, XBOX_LIVE_URL, XSTS_URL, MINECRAFT_LOGIN_URL}) {
+        const QUrl target = endpoint(url);
+        const QString key = target.scheme() + "://" + target.authority();
+        if (seen.contains(key)) {
+            continue;
+        }
+        seen << key;
+        if (target.scheme() == "https") {
+            m_networkManager->connectToHostEncrypted(target.host(), quint16(target.port(443)));
+        } else {
+            m_networkManager->connectToHost(target.host(), quint16(target.port(80)));
+        }
+    }
+}
+
+void MicrosoftAuth::fail(const QString& error)
+{
+    m_running = false;
+    m_pendingRequests = 0;
+    emit authenticationError(error);
+}
+
+void MicrosoftAuth::releaseResources()
+{
+    if (m_running || (m_webView && m_webView->isVisible())) {
+        return;
+    }
+    if (m_webView) {
+        qCInfo(microsoftAuth) << "Releasing WebEngine view";
+        m_webView->deleteLater();
+        m_webView = nullptr;
+    }
+    m_networkManager->clearConnectionCache();
+}
+
 void MicrosoftAuth::onUrlChanged(const QUrl& url)
 {
     qCDebug(microsoftAuth) << "URL changed to:" << url.toString();
@@ -168,8 +355,7 @@ void MicrosoftAuth::exchangeCodeForTokens(const QString& authCode)
 {
     qCInfo(microsoftAuth) << "Exchanging authorization code for access token";
     
-    QUrl tokenUrl("https://login.microsoftonline.com/consumers/oauth2/v2.0/token");
-    QNetworkRequest request(tokenUrl);
+    QNetworkRequest request(endpoint(TOKEN_URL));
     request.setHeader(QNetworkRequest::ContentTypeHeader, "application/x-www-form-urlencoded");
     
     QUrlQuery postData;
@@ -186,10 +372,32 @@ void MicrosoftAuth::exchangeCodeForTokens(const QString& authCode)
     
     qCInfo(microsoftAuth) << "Token request data:" << postData.toString();
     
+    m_running = true;
+    m_chainTimer.start();
+    if (m_pipelined) {
+        preconnect();
+    }
     QNetworkReply* reply = m_networkManager->post(request, postData.toString().toUtf8());
     connect(reply, &QNetworkReply::finished, this, &MicrosoftAuth::onTokenExchangeFinished);
 }
 
+void MicrosoftAuth::refreshMicrosoftToken()
+{
+    qCInfo(microsoftAuth) << "Refreshing Microsoft access token";
+    
+    QNetworkRequest request(endpoint(TOKEN_URL));
+    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/x-www-form-urlencoded");
+    
+    QUrlQuery postData;
+    postData.addQueryItem("client_id", getClientId());
+    postData.addQueryItem("grant_type", "refresh_token");
+    postData.addQueryItem("refresh_token", m_refreshToken);
+    postData.addQueryItem("scope", "XboxLive.signin offline_access");
+    
+    QNetworkReply* reply = m_networkManager->post(request, postData.toString(QUrl::FullyEncoded).toUtf8());
+    connect(reply, &QNetworkReply::finished, this, &MicrosoftAuth::onTokenExchangeFinished);
+}
+
 void MicrosoftAuth::onTokenExchangeFinished()
 {
     QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
@@ -200,7 +408,11 @@ void MicrosoftAuth::onTokenExchangeFinished()
         qCWarning(microsoftAuth) << "Token exchange failed:" << reply->errorString();
         qCWarning(microsoftAuth) << "HTTP Status:" << reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
         qCWarning(microsoftAuth) << "Response body:" << responseData;
-        emit authenticationError("Failed to exchange authorization code: " + reply->errorString());
+        // A rejected refresh token will not work next time either
+        if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 400) {
+            m_refreshToken.clear();
+        }
+        fail("Failed to exchange authorization code: " + reply->errorString());
         return;
     }
     
@@ -208,30 +420,34 @@ void MicrosoftAuth::onTokenExchangeFinished()
     QJsonDocument doc = QJsonDocument::fromJson(reply->readAll(), &error);
     if (error.error != QJsonParseError::NoError) {
         qCWarning(microsoftAuth) << "Failed to parse token response:" << error.errorString();
-        emit authenticationError("Invalid token response");
+        fail("Invalid token response");
         return;
     }
     
     QJsonObject tokenData = doc.object();
-    m_accessToken = tokenData["access_token"].toString();
-    m_refreshToken = tokenData["refresh_token"].toString();
+    m_msa.value = tokenData["access_token"].toString();
+    m_msa.expiresAt = expiryIn(tokenData["expires_in"].toInteger());
+    // Refresh tokens rotate; keep the old one if none came back
+    const QString refreshToken = tokenData["refresh_token"].toString();
+    if (!refreshToken.isEmpty()) {
+        m_refreshToken = refreshToken;
+    }
     
-    if (m_accessToken.isEmpty()) {
+    if (m_msa.value.isEmpty()) {
         qCWarning(microsoftAuth) << "No access token in response";
-        emit authenticationError("No access token received");
+        fail("No access token received");
         return;
     }
     
     qCInfo(microsoftAuth) << "Successfully obtained Microsoft access token";
-    authenticateWithXboxLive(m_accessToken);
+    continueChain();
 }
 
 void MicrosoftAuth::authenticateWithXboxLive(const QString& accessToken)
 {
     qCInfo(microsoftAuth) << "Authenticating with Xbox Live";
     
-    QUrl xblUrl("https://user.auth.xboxlive.com/user/authenticate");
-    QNetworkRequest request(xblUrl);
+    QNetworkRequest request(endpoint(XBOX_LIVE_URL));
     request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
     request.setRawHeader("Accept", "application/json");
     
@@ -257,7 +473,7 @@ void MicrosoftAuth::onXboxLiveAuthFinished()
     
     if (reply->error() != QNetworkReply::NoError) {
         qCWarning(microsoftAuth) << "Xbox Live auth failed:" << reply->errorString();
-        emit authenticationError("Xbox Live authentication failed: " + reply->errorString());
+        fail("Xbox Live authentication failed: " + reply->errorString());
         return;
     }
     
@@ -265,29 +481,29 @@ void MicrosoftAuth::onXboxLiveAuthFinished()
     QJsonDocument doc = QJsonDocument::fromJson(reply->readAll(), &error);
     if (error.error != QJsonParseError::NoError) {
         qCWarning(microsoftAuth) << "Failed to parse Xbox Live response:" << error.errorString();
-        emit authenticationError("Invalid Xbox Live response");
+        fail("Invalid Xbox Live response");
         return;
     }
     
     QJsonObject xblData = doc.object();
-    m_xblToken = xblData["Token"].toString();
+    m_xbl.value = xblData["Token"].toString();
+    m_xbl.expiresAt = expiryAt(xblData["NotAfter"].toString());
     
-    if (m_xblToken.isEmpty()) {
+    if (m_xbl.value.isEmpty()) {
         qCWarning(microsoftAuth) << "No Xbox Live token received";
-        emit authenticationError("No Xbox Live token received");
+        fail("No Xbox Live token received");
         return;
     }
     
     qCInfo(microsoftAuth) << "Successfully obtained Xbox Live token";
-    authenticateWithXsts(m_xblToken);
+    continueChain();
 }
 
 void MicrosoftAuth::authenticateWithXsts(const QString& xblToken)
 {
     qCInfo(microsoftAuth) << "Authenticating with XSTS";
     
-    QUrl xstsUrl("https://xsts.auth.xboxlive.com/xsts/authorize");
-    QNetworkRequest request(xstsUrl);
+    QNetworkRequest request(endpoint(XSTS_URL));
     request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
     request.setRawHeader("Accept", "application/json");
     
@@ -314,7 +530,7 @@ void MicrosoftAuth::onXstsAuthFinished()
     
     if (reply->error() != QNetworkReply::NoError) {
         qCWarning(microsoftAuth) << "XSTS auth failed:" << reply->errorString();
-        emit authenticationError("XSTS authentication failed: " + reply->errorString());
+        fail("XSTS authentication failed: " + reply->errorString());
         return;
     }
     
@@ -322,12 +538,13 @@ void MicrosoftAuth::onXstsAuthFinished()
     QJsonDocument doc = QJsonDocument::fromJson(reply->readAll(), &error);
     if (error.error != QJsonParseError::NoError) {
         qCWarning(microsoftAuth) << "Failed to parse XSTS response:" << error.errorString();
-        emit authenticationError("Invalid XSTS response");
+        fail("Invalid XSTS response");
         return;
     }
     
     QJsonObject xstsData = doc.object();
-    m_xstsToken = xstsData["Token"].toString();
+    m_xsts.value = xstsData["Token"].toString();
+    m_xsts.expiresAt = expiryAt(xstsData["NotAfter"].toString());
     
     // Extract user hash from DisplayClaims
     QJsonObject displayClaims = xstsData["DisplayClaims"].toObject();
@@ -336,22 +553,21 @@ void MicrosoftAuth::onXstsAuthFinished()
         m_userHash = xui[0].toObject()["uhs"].toString();
     }
     
-    if (m_xstsToken.isEmpty() || m_userHash.isEmpty()) {
+    if (m_xsts.value.isEmpty() || m_userHash.isEmpty()) {
         qCWarning(microsoftAuth) << "Missing XSTS token or user hash";
-        emit authenticationError("Incomplete XSTS response");
+        fail("Incomplete XSTS response");
         return;
     }
     
     qCInfo(microsoftAuth) << "Successfully obtained XSTS token";
-    authenticateWithMinecraft(m_xstsToken, m_userHash);
+    continueChain();
 }
 
 void MicrosoftAuth::authenticateWithMinecraft(const QString& xstsToken, const QString& userHash)
 {
     qCInfo(microsoftAuth) << "Authenticating with Minecraft";
     
-    QUrl mcUrl("https://api.minecraftservices.com/authentication/login_with_xbox");
-    QNetworkRequest request(mcUrl);
+    QNetworkRequest request(endpoint(MINECRAFT_LOGIN_URL));
     request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
     request.setRawHeader("Accept", "application/json");
     
@@ -359,8 +575,6 @@ void MicrosoftAuth::authenticateWithMinecraft(const QString& xstsToken, const QS
     QString identityToken = "XBL3.0 x=" + userHash + ";" + xstsToken;
     mcData["identityToken"] = identityToken;
     
-    qCInfo(microsoftAuth) << "Minecraft request body:" << QJsonDocument(mcData).toJson(QJsonDocument::Compact);
-    
     QJsonDocument doc(mcData);
     QNetworkReply* reply = m_networkManager->post(request, doc.toJson());
     connect(reply, &QNetworkReply::finished, this, &MicrosoftAuth::onMinecraftAuthFinished);
@@ -376,7 +590,7 @@ void MicrosoftAuth::onMinecraftAuthFinished()
         qCWarning(microsoftAuth) << "Minecraft auth failed:" << reply->errorString();
         qCWarning(microsoftAuth) << "HTTP Status:" << reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
         qCWarning(microsoftAuth) << "Response body:" << responseData;
-        emit authenticationError("Minecraft authentication failed: " + reply->errorString());
+        fail("Minecraft authentication failed: " + reply->errorString());
         return;
     }
     
@@ -386,44 +600,55 @@ void MicrosoftAuth::onMinecraftAuthFinished()
     if (error.error != QJsonParseError::NoError) {
         qCWarning(microsoftAuth) << "Failed to parse Minecraft response:" << error.errorString();
         qCWarning(microsoftAuth) << "Raw response:" << responseData;
-        emit authenticationError("Invalid Minecraft response");
+        fail("Invalid Minecraft response");
         return;
     }
     
     QJsonObject mcData = doc.object();
-    m_mcAccessToken = mcData["access_token"].toString();
+    m_minecraft.value = mcData["access_token"].toString();
+    m_minecraft.expiresAt = expiryIn(mcData["expires_in"].toInteger());
     
-    if (m_mcAccessToken.isEmpty()) {
+    if (m_minecraft.value.isEmpty()) {
         qCWarning(microsoftAuth) << "No Minecraft access token received";
-        qCWarning(microsoftAuth) << "Full response:" << mcData;
-        emit authenticationError("No Minecraft access token received");
+        fail("No Minecraft access token received");
         return;
     }
     
     qCInfo(microsoftAuth) << "Successfully obtained Minecraft access token";
-    fetchMinecraftProfile(m_mcAccessToken);
+    continueChain();
 }
 
 void MicrosoftAuth::fetchMinecraftProfile(const QString& mcAccessToken)
 {
     qCInfo(microsoftAuth) << "Fetching Minecraft profile";
     
-    QUrl profileUrl("https://api.minecraftservices.com/minecraft/profile");
-    QNetworkRequest request(profileUrl);
+    QNetworkRequest request(endpoint(PROFILE_URL));
     request.setRawHeader("Authorization", ("Bearer " + mcAccessToken).toUtf8());
     
     QNetworkReply* reply = m_networkManager->get(request);
     connect(reply, &QNetworkReply::finished, this, &MicrosoftAuth::onProfileFetchFinished);
 }
 
+void MicrosoftAuth::fetchEntitlements(const QString& mcAccessToken)
+{
+    QNetworkRequest request(endpoint(ENTITLEMENTS_URL));
+    request.setRawHeader("Authorization", ("Bearer " + mcAccessToken).toUtf8());
+    
+    QNetworkReply* reply = m_networkManager->get(request);
+    connect(reply, &QNetworkReply::finished, this, &MicrosoftAuth::onEntitlementsFinished);
+}
+
 void MicrosoftAuth::onProfileFetchFinished()
 {
     QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
     reply->deleteLater();
+    if (!m_running) {
+        return; // the chain already failed
+    }
     
     if (reply->error() != QNetworkReply::NoError) {
         qCWarning(microsoftAuth) << "Profile fetch failed:" << reply->errorString();
-        emit authenticationError("Failed to fetch Minecraft profile: " + reply->errorString());
+        fail("Failed to fetch Minecraft profile: " + reply->errorString());
         return;
     }
     
@@ -431,7 +656,7 @@ void MicrosoftAuth::onProfileFetchFinished()
     QJsonDocument doc = QJsonDocument::fromJson(reply->readAll(), &error);
     if (error.error != QJsonParseError::NoError) {
         qCWarning(microsoftAuth) << "Failed to parse profile response:" << error.errorString();
-        emit authenticationError("Invalid profile response");
+        fail("Invalid profile response");
         return;
     }
     
@@ -441,22 +666,136 @@ void MicrosoftAuth::onProfileFetchFinished()
     
     if (username.isEmpty() || uuid.isEmpty()) {
         qCWarning(microsoftAuth) << "Incomplete profile data";
-        emit authenticationError("Incomplete profile data");
+        fail("Incomplete profile data");
         return;
     }
     
     qCInfo(microsoftAuth) << "Successfully fetched profile for user:" << username;
+    m_profile = profileData;
+    
+    // Sequential baseline: entitlements only now
+    if (!m_pipelined) {
+        fetchEntitlements(m_minecraft.value);
+    }
+    --m_pendingRequests;
+    finishIfComplete();
+}
+
+void MicrosoftAuth::onEntitlementsFinished()
+{
+    QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
+    reply->deleteLater();
+    if (!m_running) {
+        return;
+    }
+    
+    // Informational: Game Pass accounts can play without a store entitlement
+    if (reply->error() != QNetworkReply::NoError) {
+        qCWarning(microsoftAuth) << "Entitlement check failed:" << reply->errorString();
+    } else {
+        const QJsonArray items = QJsonDocument::fromJson(reply->readAll()).object()["items"].toArray();
+        for (const QJsonValue& item : items) {
+            const QString name = item.toObject()["name"].toString();
+            if (name == "product_minecraft" || name == "game_minecraft") {
+                m_ownsMinecraft = true;
+            }
+        }
+        if (!m_ownsMinecraft) {
+            qCWarning(microsoftAuth) << "Account has no Minecraft store entitlement";
+        }
+    }
+    --m_pendingRequests;
+    finishIfComplete();
+}
+
+void MicrosoftAuth::finishIfComplete()
+{
+    if (m_pendingRequests > 0) {
+        return;
+    }
+    m_running = false;
+    qCInfo(microsoftAuth) << "Sign-in chain finished in" << m_chainTimer.elapsed() << "ms";
     
     // Create the final authentication data
     QJsonObject authData;
-    authData["access_token"] = m_mcAccessToken;
+    authData["access_token"] = m_minecraft.value;
     authData["refresh_token"] = m_refreshToken;
-    authData["username"] = username;
-    authData["uuid"] = uuid;
+    authData["expires_at"] = m_minecraft.expiresAt.toString(Qt::ISODate);
+    authData["username"] = m_profile["name"].toString();
+    authData["uuid"] = m_profile["id"].toString();
+    authData["owns_minecraft"] = m_ownsMinecraft;
     
     emit authenticationCompleted(authData);
 }
 
+void MicrosoftAuth::runBenchmark(int iterations)
+{
+    // e.g. http://127.0.0.1:8765: every hop goes to one stand-in server
+    const QUrl standIn(qEnvironmentVariable("CRYOVEX_AUTH_ENDPOINT"));
+    if (!standIn.isValid() || standIn.host().isEmpty()) {
+        qCWarning(microsoftAuth) << "Set CRYOVEX_AUTH_ENDPOINT to a stand-in server, see tests/auth_standin.py";
+        return;
+    }
+    
+    // Each run starts without idle connections, like a launcher restart
+    auto measure = [iterations, standIn](bool pipelined, const QJsonObject& cached) {
+        QVector<qint64> samples;
+        MicrosoftAuth auth;
+        auth.m_endpointOverride = standIn;
+        auth.setPipelined(pipelined);
+        QElapsedTimer timer;
+        for (int i = 0; i < iterations; ++i) {
+            auth.restoreTokens(cached);
+            auth.m_networkManager->clearConnectionCache();
+            
+            QEventLoop loop;
+            bool ok = false;
+            connect(&auth, &MicrosoftAuth::authenticationCompleted, &loop, [&]() {
+                ok = true;
+                loop.quit();
+            });
+            connect(&auth, &MicrosoftAuth::authenticationError, &loop, &QEventLoop::quit);
+            timer.start();
+            auth.refresh();
+            loop.exec();
+            if (!ok) {
+                return QVector<qint64>();
+            }
+            samples.append(timer.elapsed());
+        }
+        std::sort(samples.begin(), samples.end());
+        return samples;
+    };
+    
+    auto report = [](const char* name, const QVector<qint64>& samples) {
+        if (samples.isEmpty()) {
+            qCWarning(microsoftAuth) << "  " << name << ": failed";
+            return;
+        }
+        qCInfo(microsoftAuth) << "  " << name << ": median" << samples.at(samples.size() / 2) << "ms, p90"
+                              << samples.at(samples.size() * 9 / 10) << "ms";
+    };
+    
+    QJsonObject refreshOnly;
+    refreshOnly["refreshToken"] = "benchmark";
+    
+    // A restart where the Xbox tokens are still valid only logs in to Minecraft
+    MicrosoftAuth warm;
+    warm.m_endpointOverride = standIn;
+    QEventLoop loop;
+    connect(&warm, &MicrosoftAuth::authenticationCompleted, &loop, &QEventLoop::quit);
+    connect(&warm, &MicrosoftAuth::authenticationError, &loop, &QEventLoop::quit);
+    warm.restoreTokens(refreshOnly);
+    warm.refresh();
+    loop.exec();
+    const QJsonObject cachedXsts = warm.tokens();
+    
+    qCInfo(microsoftAuth) << "Silent sign-in latency," << iterations << "runs against" << standIn.toString();
+    report("refresh token, sequential", measure(false, refreshOnly));
+    report("refresh token, pipelined", measure(true, refreshOnly));
+    report("cached XSTS token, pipelined", measure(true, cachedXsts));
+}
+
 QString MicrosoftAuth::generateCodeVerifier()
 {
     // Generate a random 128-character string for PKCE
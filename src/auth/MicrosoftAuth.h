@@ -5,19 +5,57 @@
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include <QJsonObject>
+#include <QDateTime>
+#include <QElapsedTimer>
 #include <QUrl>
 #include <QUrlQuery>
 #include <QTimer>
 
+// Microsoft account sign-in: OAuth code or refresh token, then Xbox Live,
+// XSTS and Minecraft login, then profile and entitlements. Every token is
+// kept with its expiry, so a chain only runs the stages whose token ran out;
+// with a refresh token none of them needs the browser. Profile and
+// entitlements are fetched in parallel, and connections to the later hosts
+// are opened while the earlier hops are still in flight.
 class MicrosoftAuth : public QObject
 {
     Q_OBJECT
 
 public:
+    struct Token {
+        QString value;
+        QDateTime expiresAt;
+
+        // With a few minutes to spare for the request that uses it
+        bool isValid() const;
+        QJsonObject toJson() const;
+        static Token fromJson(const QJsonObject& json);
+    };
+
     explicit MicrosoftAuth(QObject *parent = nullptr);
     ~MicrosoftAuth();
     
     void startAuthentication();
+    // Renews the Minecraft token without the browser, from the first stage
+    // whose token is still valid. False if there is nothing to renew from.
+    bool refresh();
+    bool isRunning() const { return m_running; }
+
+    // Every stage's token, for auth.json, and back
+    QJsonObject tokens() const;
+    void restoreTokens(const QJsonObject& tokens);
+    QDateTime minecraftExpiry() const { return m_minecraft.expiresAt; }
+
+    // Off: one request at a time, as a baseline for the benchmark
+    void setPipelined(bool pipelined) { m_pipelined = pipelined; }
+
+    // Drops the login web view and idle connections unless a login is in
+    // progress; the view is created again by the next startAuthentication()
+    void releaseResources();
+
+    // Silent sign-in latency against CRYOVEX_AUTH_ENDPOINT, a local stand-in
+    // of the auth services such as tests/auth_standin.py
+    static void runBenchmark(int iterations = 20);
 
 signals:
     void authenticationCompleted(const QJsonObject& authData);
@@ -30,14 +68,26 @@ private slots:
     void onXstsAuthFinished();
     void onMinecraftAuthFinished();
     void onProfileFetchFinished();
+    void onEntitlementsFinished();
 
 private:
     void exchangeCodeForTokens(const QString& authCode);
+    void refreshMicrosoftToken();
     void authenticateWithXboxLive(const QString& accessToken);
     void authenticateWithXsts(const QString& xblToken);
     void authenticateWithMinecraft(const QString& xstsToken, const QString& userHash);
     void fetchMinecraftProfile(const QString& mcAccessToken);
+    void fetchEntitlements(const QString& mcAccessToken);
     void initializeWebView(); // Safe WebEngine initialization
+
+    // Runs the first stage without a valid token; each stage calls it again
+    void beginChain();
+    void continueChain();
+    void preconnect();
+    void finishIfComplete();
+    void fail(const QString& error);
+    void clearTokens();
+    QUrl endpoint(const QString& url) const;
     
     // PKCE helper methods
     QString generateCodeVerifier();
@@ -46,13 +96,21 @@ private:
     QWebEngineView* m_webView;
     QNetworkAccessManager* m_networkManager;
     
-    QString m_accessToken;
+    Token m_msa;
     QString m_refreshToken;
-    QString m_xblToken;
-    QString m_xstsToken;
-    QString m_mcAccessToken;
+    Token m_xbl;
+    Token m_xsts;
     QString m_userHash;
+    Token m_minecraft;
     QString m_codeVerifier; // For PKCE
+
+    bool m_running = false;
+    bool m_pipelined = true;
+    int m_pendingRequests = 0; // profile and entitlements
+    QJsonObject m_profile;
+    bool m_ownsMinecraft = false;
+    QElapsedTimer m_chainTimer;
+    QUrl m_endpointOverride; // runBenchmark() only: scheme, host and port of a stand-in
     
     // Remove static constants, use methods instead
     QString getClientId() const;
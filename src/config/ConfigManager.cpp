@@ -82,6 +82,12 @@ void ConfigManager::addProfile(const QString& username, const QString& uuid)
 {
     beginInsertRows(QModelIndex(), m_profiles.size(), m_profiles.size());
     Profile* profile = new Profile(username, uuid, this);
+    connect(profile, &Profile::placementChanged, this, [this, profile]() {
+        saveProfiles();
+        if (profile == m_currentProfile) {
+            emit placementChanged();
+        }
+    });
     m_profiles.append(profile);
     endInsertRows();
     
@@ -98,6 +104,7 @@ void ConfigManager::removeProfile(const QString& uuid)
             if (profile == m_currentProfile) {
                 m_currentProfile = nullptr;
                 emit currentProfileChanged();
+                emit placementChanged();
             }
             profile->deleteLater();
             endRemoveRows();
@@ -115,6 +122,7 @@ void ConfigManager::setCurrentProfile(const QString& uuid)
     if (profile && profile != m_currentProfile) {
         m_currentProfile = profile;
         emit currentProfileChanged();
+        emit placementChanged();
         saveSettings();
     }
 }
@@ -156,6 +164,97 @@ void ConfigManager::setMemoryMB(int memory)
     }
 }
 
+void ConfigManager::setJvmProfile(const QString& profile)
+{
+    if (m_jvmProfile != profile) {
+        m_jvmProfile = profile;
+        emit jvmProfileChanged();
+        saveSettings();
+    }
+}
+
+void ConfigManager::setAppCdsEnabled(bool enabled)
+{
+    if (m_appCdsEnabled != enabled) {
+        m_appCdsEnabled = enabled;
+        emit appCdsEnabledChanged();
+        saveSettings();
+    }
+}
+
+void ConfigManager::setMaxInstances(int count)
+{
+    if (m_maxInstances != count) {
+        m_maxInstances = count;
+        emit maxInstancesChanged();
+        saveSettings();
+    }
+}
+
+void ConfigManager::setMonitorIntervalMs(int intervalMs)
+{
+    if (m_monitorIntervalMs != intervalMs) {
+        m_monitorIntervalMs = intervalMs;
+        emit monitorIntervalMsChanged();
+        saveSettings();
+    }
+}
+
+void ConfigManager::setLaunchVerification(const QString& mode)
+{
+    if (m_launchVerification != mode) {
+        m_launchVerification = mode;
+        emit launchVerificationChanged();
+        saveSettings();
+    }
+}
+
+void ConfigManager::setDetachGames(bool detach)
+{
+    if (m_detachGames != detach) {
+        m_detachGames = detach;
+        emit detachGamesChanged();
+        saveSettings();
+    }
+}
+
+void ConfigManager::setThrottleWhilePlaying(bool throttle)
+{
+    if (m_throttleWhilePlaying != throttle) {
+        m_throttleWhilePlaying = throttle;
+        emit throttleWhilePlayingChanged();
+        saveSettings();
+    }
+}
+
+void ConfigManager::setPlayingBandwidthKBps(int kilobytesPerSecond)
+{
+    kilobytesPerSecond = qMax(0, kilobytesPerSecond);
+    if (m_playingBandwidthKBps != kilobytesPerSecond) {
+        m_playingBandwidthKBps = kilobytesPerSecond;
+        emit playingBandwidthKBpsChanged();
+        saveSettings();
+    }
+}
+
+void ConfigManager::setMinimalWhilePlaying(bool minimal)
+{
+    if (m_minimalWhilePlaying != minimal) {
+        m_minimalWhilePlaying = minimal;
+        emit minimalWhilePlayingChanged();
+        saveSettings();
+    }
+}
+
+void ConfigManager::setManifestCacheMB(int megabytes)
+{
+    if (m_manifestCacheMB != megabytes) {
+        m_manifestCacheMB = megabytes;
+        emit manifestCacheMBChanged();
+        saveSettings();
+    }
+}
+
 void ConfigManager::loadSettings()
 {
     QString settingsPath = getSettingsFilePath();
@@ -182,6 +281,16 @@ void ConfigManager::loadSettings()
     m_gameDirectory = settings["gameDirectory"].toString(m_gameDirectory);
     m_javaPath = settings["javaPath"].toString(m_javaPath);
     m_memoryMB = settings["memoryMB"].toInt(m_memoryMB);
+    m_jvmProfile = settings["jvmProfile"].toString(m_jvmProfile);
+    m_appCdsEnabled = settings["appCdsEnabled"].toBool(m_appCdsEnabled);
+    m_manifestCacheMB = settings["manifestCacheMB"].toInt(m_manifestCacheMB);
+    m_maxInstances = settings["maxInstances"].toInt(m_maxInstances);
+    m_monitorIntervalMs = settings["monitorIntervalMs"].toInt(m_monitorIntervalMs);
+    m_launchVerification = settings["launchVerification"].toString(m_launchVerification);
+    m_detachGames = settings["detachGames"].toBool(m_detachGames);
+    m_throttleWhilePlaying = settings["throttleWhilePlaying"].toBool(m_throttleWhilePlaying);
+    m_playingBandwidthKBps = settings["playingBandwidthKBps"].toInt(m_playingBandwidthKBps);
+    m_minimalWhilePlaying = settings["minimalWhilePlaying"].toBool(m_minimalWhilePlaying);
     
     QString currentProfileUuid = settings["currentProfile"].toString();
     if (!currentProfileUuid.isEmpty()) {
@@ -195,6 +304,16 @@ void ConfigManager::saveSettings()
     settings["gameDirectory"] = m_gameDirectory;
     settings["javaPath"] = m_javaPath;
     settings["memoryMB"] = m_memoryMB;
+    settings["jvmProfile"] = m_jvmProfile;
+    settings["appCdsEnabled"] = m_appCdsEnabled;
+    settings["manifestCacheMB"] = m_manifestCacheMB;
+    settings["maxInstances"] = m_maxInstances;
+    settings["monitorIntervalMs"] = m_monitorIntervalMs;
+    settings["launchVerification"] = m_launchVerification;
+    settings["detachGames"] = m_detachGames;
+    settings["throttleWhilePlaying"] = m_throttleWhilePlaying;
+    settings["playingBandwidthKBps"] = m_playingBandwidthKBps;
+    settings["minimalWhilePlaying"] = m_minimalWhilePlaying;
     if (m_currentProfile) {
         settings["currentProfile"] = m_currentProfile->uuid();
     }
@@ -12,6 +12,16 @@ class ConfigManager : public QAbstractListModel
     Q_PROPERTY(QString gameDirectory READ gameDirectory WRITE setGameDirectory NOTIFY gameDirectoryChanged)
     Q_PROPERTY(QString javaPath READ javaPath WRITE setJavaPath NOTIFY javaPathChanged)
     Q_PROPERTY(int memoryMB READ memoryMB WRITE setMemoryMB NOTIFY memoryMBChanged)
+    Q_PROPERTY(QString jvmProfile READ jvmProfile WRITE setJvmProfile NOTIFY jvmProfileChanged)
+    Q_PROPERTY(bool appCdsEnabled READ appCdsEnabled WRITE setAppCdsEnabled NOTIFY appCdsEnabledChanged)
+    Q_PROPERTY(int manifestCacheMB READ manifestCacheMB WRITE setManifestCacheMB NOTIFY manifestCacheMBChanged)
+    Q_PROPERTY(int maxInstances READ maxInstances WRITE setMaxInstances NOTIFY maxInstancesChanged)
+    Q_PROPERTY(int monitorIntervalMs READ monitorIntervalMs WRITE setMonitorIntervalMs NOTIFY monitorIntervalMsChanged)
+    Q_PROPERTY(QString launchVerification READ launchVerification WRITE setLaunchVerification NOTIFY launchVerificationChanged)
+    Q_PROPERTY(bool detachGames READ detachGames WRITE setDetachGames NOTIFY detachGamesChanged)
+    Q_PROPERTY(bool throttleWhilePlaying READ throttleWhilePlaying WRITE setThrottleWhilePlaying NOTIFY throttleWhilePlayingChanged)
+    Q_PROPERTY(int playingBandwidthKBps READ playingBandwidthKBps WRITE setPlayingBandwidthKBps NOTIFY playingBandwidthKBpsChanged)
+    Q_PROPERTY(bool minimalWhilePlaying READ minimalWhilePlaying WRITE setMinimalWhilePlaying NOTIFY minimalWhilePlayingChanged)
 
 public:
     enum ProfileRoles {
@@ -36,6 +46,16 @@ public:
     QString gameDirectory() const { return m_gameDirectory; }
     QString javaPath() const { return m_javaPath; }
     int memoryMB() const { return m_memoryMB; }
+    QString jvmProfile() const { return m_jvmProfile; }
+    bool appCdsEnabled() const { return m_appCdsEnabled; }
+    int manifestCacheMB() const { return m_manifestCacheMB; }
+    int maxInstances() const { return m_maxInstances; }
+    int monitorIntervalMs() const { return m_monitorIntervalMs; }
+    QString launchVerification() const { return m_launchVerification; }
+    bool detachGames() const { return m_detachGames; }
+    bool throttleWhilePlaying() const { return m_throttleWhilePlaying; }
+    int playingBandwidthKBps() const { return m_playingBandwidthKBps; }
+    bool minimalWhilePlaying() const { return m_minimalWhilePlaying; }
     
     Q_INVOKABLE void addProfile(const QString& username, const QString& uuid);
     Q_INVOKABLE void removeProfile(const QString& uuid);
@@ -46,12 +66,34 @@ public slots:
     void setGameDirectory(const QString& directory);
     void setJavaPath(const QString& path);
     void setMemoryMB(int memory);
+    void setJvmProfile(const QString& profile);
+    void setAppCdsEnabled(bool enabled);
+    void setManifestCacheMB(int megabytes);
+    void setMaxInstances(int count);
+    void setMonitorIntervalMs(int intervalMs);
+    void setLaunchVerification(const QString& mode);
+    void setDetachGames(bool detach);
+    void setThrottleWhilePlaying(bool throttle);
+    void setPlayingBandwidthKBps(int kilobytesPerSecond);
+    void setMinimalWhilePlaying(bool minimal);
 
 signals:
     void currentProfileChanged();
+    // Placement of the current profile changed, or another profile became current
+    void placementChanged();
     void gameDirectoryChanged();
     void javaPathChanged();
     void memoryMBChanged();
+    void jvmProfileChanged();
+    void appCdsEnabledChanged();
+    void manifestCacheMBChanged();
+    void maxInstancesChanged();
+    void monitorIntervalMsChanged();
+    void launchVerificationChanged();
+    void detachGamesChanged();
+    void throttleWhilePlayingChanged();
+    void playingBandwidthKBpsChanged();
+    void minimalWhilePlayingChanged();
     void profileAdded(Profile* profile);
     void profileRemoved(const QString& uuid);
 
@@ -73,4 +115,14 @@ private:
     QString m_gameDirectory;
     QString m_javaPath;
     int m_memoryMB = 2048;
+    QString m_jvmProfile = "auto"; // JvmTuning profile name
+    bool m_appCdsEnabled = true;
+    int m_manifestCacheMB = 32;
+    int m_maxInstances = 1; // concurrent game processes
+    int m_monitorIntervalMs = 1000; // 0 = no resource sampling
+    QString m_launchVerification = "parallel"; // "stat", "before" or "parallel"
+    bool m_detachGames = false; // games outlive the launcher through the log helper
+    bool m_throttleWhilePlaying = true; // background work backs off while a game runs
+    int m_playingBandwidthKBps = 2048; // download ceiling while throttled, 0 = none
+    bool m_minimalWhilePlaying = false; // in-game mode: views unloaded while a game runs
 };
\ No newline at end of file
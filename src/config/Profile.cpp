@@ -62,6 +62,14 @@ void Profile::setMemoryMB(int memory)
     }
 }
 
+void Profile::setPlacement(const QJsonObject& placement)
+{
+    if (m_placement != placement) {
+        m_placement = placement;
+        emit placementChanged();
+    }
+}
+
 QJsonObject Profile::toJson() const
 {
     QJsonObject json;
@@ -72,6 +80,7 @@ QJsonObject Profile::toJson() const
     json["lastPlayed"] = m_lastPlayed.toString(Qt::ISODate);
     json["javaPath"] = m_javaPath;
     json["memoryMB"] = m_memoryMB;
+    json["placement"] = m_placement;
     return json;
 }
 
@@ -84,4 +93,5 @@ void Profile::fromJson(const QJsonObject& json)
     setLastPlayed(QDateTime::fromString(json["lastPlayed"].toString(), Qt::ISODate));
     setJavaPath(json["javaPath"].toString());
     setMemoryMB(json["memoryMB"].toInt(2048));
+    setPlacement(json["placement"].toObject());
 }
\ No newline at end of file
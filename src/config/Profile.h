@@ -15,6 +15,8 @@ class Profile : public QObject
     Q_PROPERTY(QDateTime lastPlayed READ lastPlayed WRITE setLastPlayed NOTIFY lastPlayedChanged)
     Q_PROPERTY(QString javaPath READ javaPath WRITE setJavaPath NOTIFY javaPathChanged)
     Q_PROPERTY(int memoryMB READ memoryMB WRITE setMemoryMB NOTIFY memoryMBChanged)
+    // ProcessPlacement::toJson() form: cpus, background, ioClass, ioLevel, memoryLimitMB, cpuLimitPercent
+    Q_PROPERTY(QJsonObject placement READ placement WRITE setPlacement NOTIFY placementChanged)
 
 public:
     explicit Profile(QObject *parent = nullptr);
@@ -27,6 +29,7 @@ public:
     QDateTime lastPlayed() const { return m_lastPlayed; }
     QString javaPath() const { return m_javaPath; }
     int memoryMB() const { return m_memoryMB; }
+    QJsonObject placement() const { return m_placement; }
     
     void setName(const QString& name);
     void setUsername(const QString& username);
@@ -34,6 +37,7 @@ public:
     void setLastPlayed(const QDateTime& dateTime);
     void setJavaPath(const QString& path);
     void setMemoryMB(int memory);
+    void setPlacement(const QJsonObject& placement);
     
     QJsonObject toJson() const;
     void fromJson(const QJsonObject& json);
@@ -45,6 +49,7 @@ signals:
     void lastPlayedChanged();
     void javaPathChanged();
     void memoryMBChanged();
+    void placementChanged();
 
 private:
     QString m_name;
@@ -54,4 +59,5 @@ private:
     QDateTime m_lastPlayed;
     QString m_javaPath;
     int m_memoryMB = 2048;
+    QJsonObject m_placement;
 };
\ No newline at end of file
@@ -0,0 +1,238 @@
+#include "AssetIndexParser.h"
+#include <QLoggingCategory>
+
+Q_LOGGING_CATEGORY(assetIndexParser, "cryovex.download.assetparser")
+
+AssetIndexParser::AssetIndexParser(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void AssetIndexParser::feed(const QByteArray& data)
+{
+    if (m_complete || hasError()) {
+        return;
+    }
+
+    m_buffer.append(data);
+    parse();
+
+    // Drop consumed bytes; at most one partial token is carried over
+    if (m_position > 0) {
+        m_buffer.remove(0, m_position);
+        m_position = 0;
+    }
+}
+
+bool AssetIndexParser::finish()
+{
+    if (!m_complete && !hasError()) {
+        setError("Unexpected end of asset index");
+    }
+    return m_complete;
+}
+
+void AssetIndexParser::parse()
+{
+    const int length = m_buffer.size();
+
+    while (m_position < length && !hasError()) {
+        const char c = m_buffer.at(m_position);
+
+        switch (c) {
+        case ' ':
+        case '\t':
+        case '\r':
+        case '\n':
+            ++m_position;
+            break;
+
+        case '{':
+        case '[': {
+            if (m_complete) {
+                setError("Trailing data after asset index");
+                return;
+            }
+            Frame frame;
+            frame.type = c == '{' ? ObjectContainer : ArrayContainer;
+            frame.expectKey = frame.type == ObjectContainer;
+            m_stack.append(frame);
+            if (inEntry()) {
+                m_entryHash.clear();
+                m_entrySize = -1;
+            }
+            ++m_position;
+            break;
+        }
+
+        case '}':
+        case ']':
+            if (m_stack.isEmpty()) {
+                setError("Unbalanced closing bracket");
+                return;
+            }
+            if (c == '}' && inEntry()) {
+                ++m_entryCount;
+                emit assetFound(m_stack.at(1).key, m_entryHash, m_entrySize);
+            }
+            m_stack.removeLast();
+            m_complete = m_stack.isEmpty();
+            ++m_position;
+            break;
+
+        case ':':
+            ++m_position;
+            break;
+
+        case ',':
+            if (!m_stack.isEmpty() && m_stack.last().type == ObjectContainer) {
+                m_stack.last().expectKey = true;
+            }
+            ++m_position;
+            break;
+
+        case '"': {
+            QString value;
+            if (!readString(&value)) {
+                return; // need more data
+            }
+            if (!m_stack.isEmpty() && m_stack.last().type == ObjectContainer && m_stack.last().expectKey) {
+                m_stack.last().key = value;
+                m_stack.last().expectKey = false;
+            } else {
+                handleScalar(value);
+            }
+            break;
+        }
+
+        default: {
+            QByteArray literal;
+            if (!readLiteral(&literal)) {
+                return; // need more data
+            }
+            handleScalar(QString::fromLatin1(literal));
+            break;
+        }
+        }
+    }
+}
+
+bool AssetIndexParser::readString(QString* value)
+{
+    // m_position is on the opening quote
+    const char* data = m_buffer.constData();
+    const int length = m_buffer.size();
+    int end = m_position + 1;
+    bool escaped = false;
+
+    while (end < length) {
+        if (data[end] == '\\') {
+            escaped = true;
+            end += 2;
+            continue;
+        }
+        if (data[end] == '"') {
+            break;
+        }
+        ++end;
+    }
+    if (end >= length) {
+        return false;
+    }
+
+    const int start = m_position + 1;
+    m_position = end + 1;
+
+    if (!escaped) {
+        *value = QString::fromUtf8(data + start, end - start);
+        return true;
+    }
+
+    QString result;
+    QByteArray pending;
+    for (int i = start; i < end; ++i) {
+        if (data[i] != '\\') {
+            pending.append(data[i]);
+            continue;
+        }
+
+        const char escape = data[++i];
+        switch (escape) {
+        case 'n': pending.append('\n'); break;
+        case 't': pending.append('\t'); break;
+        case 'r': pending.append('\r'); break;
+        case 'b': pending.append('\b'); break;
+        case 'f': pending.append('\f'); break;
+        case 'u': {
+            result += QString::fromUtf8(pending);
+            pending.clear();
+            bool ok = false;
+            const ushort unit = QByteArray(data + i + 1, 4).toUShort(&ok, 16);
+            if (!ok) {
+                setError("Invalid unicode escape in asset index");
+                return true;
+            }
+            result += QChar(unit);
+            i += 4;
+            break;
+        }
+        default:
+            pending.append(escape); // \" \\ \/
+            break;
+        }
+    }
+    result += QString::fromUtf8(pending);
+    *value = result;
+    return true;
+}
+
+bool AssetIndexParser::readLiteral(QByteArray* value)
+{
+    const char* data = m_buffer.constData();
+    const int length = m_buffer.size();
+    int end = m_position;
+
+    while (end < length) {
+        const char c = data[end];
+        if (c == ',' || c == '}' || c == ']' || c == ' ' || c == '\n' || c == '\r' || c == '\t') {
+            break;
+        }
+        ++end;
+    }
+    if (end >= length) {
+        return false;
+    }
+
+    *value = QByteArray(data + m_position, end - m_position);
+    m_position = end;
+    return true;
+}
+
+void AssetIndexParser::handleScalar(const QString& value)
+{
+    if (m_stack.size() != 3 || !inEntry()) {
+        return;
+    }
+
+    const QString& field = m_stack.at(2).key;
+    if (field == QLatin1String("hash")) {
+        m_entryHash = value;
+    } else if (field == QLatin1String("size")) {
+        m_entrySize = value.toLongLong();
+    }
+}
+
+bool AssetIndexParser::inEntry() const
+{
+    // { "objects": { "<name>": { "hash": ..., "size": ... } } }
+    return m_stack.size() == 3
+        && m_stack.at(0).key == QLatin1String("objects")
+        && m_stack.at(1).type == ObjectContainer
+        && m_stack.at(2).type == ObjectContainer;
+}
+
+void AssetIndexParser::setError(const QString& error)
+{
+    qCWarning(assetIndexParser) << error;
+    m_errorString = error;
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <QObject>
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+// Incremental (SAX-style) parser for asset index JSON. Bytes can be fed as
+// they arrive off the network; every "objects" entry is reported as soon as
+// its closing brace has been seen, without building a QJsonDocument.
+class AssetIndexParser : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit AssetIndexParser(QObject *parent = nullptr);
+
+    void feed(const QByteArray& data);
+    bool finish();
+
+    bool isComplete() const { return m_complete; }
+    bool hasError() const { return !m_errorString.isEmpty(); }
+    QString errorString() const { return m_errorString; }
+    int entryCount() const { return m_entryCount; }
+
+signals:
+    void assetFound(const QString& name, const QString& hash, qint64 size);
+
+private:
+    enum ContainerType {
+        ObjectContainer,
+        ArrayContainer
+    };
+
+    struct Frame {
+        ContainerType type = ObjectContainer;
+        bool expectKey = true;
+        QString key;
+    };
+
+    void parse();
+    bool readString(QString* value);
+    bool readLiteral(QByteArray* value);
+    void handleScalar(const QString& value);
+    bool inEntry() const;
+    void setError(const QString& error);
+
+    QByteArray m_buffer;
+    int m_position = 0;
+    QVector<Frame> m_stack;
+
+    QString m_entryHash;
+    qint64 m_entrySize = -1;
+    int m_entryCount = 0;
+    bool m_complete = false;
+    QString m_errorString;
+};
\ No newline at end of file
@@ -0,0 +1,223 @@
+#include "AssetIndexStreamer.h"
+#include "AssetIndexParser.h"
+#include "DownloadManager.h"
+#include "DownloadTask.h"
+#include "utils/AssetClassifier.h"
+#include "utils/BackgroundGovernor.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLoggingCategory>
+
+Q_LOGGING_CATEGORY(assetIndexStreamer, "cryovex.download.assets")
+
+AssetIndexStreamer::AssetIndexStreamer(const QString& assetsDirectory, DownloadManager* downloadManager,
+                                       QObject *parent)
+    : QObject(parent)
+    , m_assetsDirectory(assetsDirectory)
+    , m_language(AssetClassifier::systemLanguage())
+    , m_downloadManager(downloadManager)
+    , m_parser(new AssetIndexParser(this))
+{
+    m_pool.setMaxThreadCount(2);
+    BackgroundGovernor::instance().registerPool(&m_pool);
+    connect(m_parser, &AssetIndexParser::assetFound, this, &AssetIndexStreamer::onAssetFound);
+}
+
+AssetIndexStreamer::~AssetIndexStreamer()
+{
+    m_pool.waitForDone();
+}
+
+void AssetIndexStreamer::start(const InstallRequirement& assetIndex)
+{
+    qCInfo(assetIndexStreamer) << "Streaming asset index:" << assetIndex.url.toString();
+
+    m_timer.start();
+    m_indexTask = m_downloadManager->addPriorityDownload(assetIndex);
+
+    connect(m_indexTask, &DownloadTask::dataReceived, this, &AssetIndexStreamer::onIndexData);
+    connect(m_indexTask, &DownloadTask::finished, this, &AssetIndexStreamer::onIndexFinished);
+    connect(m_indexTask, &DownloadTask::error, this, &AssetIndexStreamer::onIndexError);
+}
+
+int AssetIndexStreamer::entryCount() const
+{
+    return m_parser->entryCount();
+}
+
+void AssetIndexStreamer::onIndexData(const QByteArray& data)
+{
+    m_parser->feed(data);
+    flushPending();
+}
+
+void AssetIndexStreamer::onIndexFinished()
+{
+    m_indexCompleteMs = m_timer.elapsed();
+    m_indexDone = true;
+
+    if (!m_parser->finish()) {
+        qCWarning(assetIndexStreamer) << "Asset index incomplete:" << m_parser->errorString();
+        m_failed = true;
+    }
+
+    flushPending();
+    finishIfDone();
+}
+
+void AssetIndexStreamer::onIndexError(const QString& errorString)
+{
+    qCWarning(assetIndexStreamer) << "Asset index download failed:" << errorString;
+    m_indexDone = true;
+    m_failed = true;
+    finishIfDone();
+}
+
+void AssetIndexStreamer::onAssetFound(const QString& name, const QString& hash, qint64 size)
+{
+    // Several names can share one object
+    if (hash.isEmpty() || m_seenHashes.contains(hash)) {
+        return;
+    }
+    m_seenHashes.insert(hash);
+
+    InstallRequirement requirement;
+    requirement.kind = InstallRequirement::Asset;
+    requirement.url = InstallPlanner::assetObjectUrl(hash);
+    requirement.filePath = InstallPlanner::assetObjectPath(m_assetsDirectory, hash);
+    requirement.sha1 = hash;
+    requirement.size = size;
+    requirement.critical = AssetClassifier::isNeededAtStartup(name, m_language);
+    m_pending.append(requirement);
+}
+
+void AssetIndexStreamer::flushPending()
+{
+    if (m_pending.isEmpty()) {
+        return;
+    }
+
+    const QList<InstallRequirement> batch = m_pending;
+    m_pending.clear();
+    ++m_batchesInFlight;
+
+    m_pool.start([this, batch]() {
+        BackgroundGovernor::applyThreadPriority();
+        QList<InstallRequirement> missing;
+        for (const InstallRequirement& requirement : batch) {
+            QFileInfo info(requirement.filePath);
+            if (!info.exists() || (requirement.size >= 0 && info.size() != requirement.size)) {
+                missing.append(requirement);
+            }
+        }
+
+        QMetaObject::invokeMethod(this, [this, missing]() {
+            enqueueMissing(missing);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void AssetIndexStreamer::enqueueMissing(const QList<InstallRequirement>& missing)
+{
+    --m_batchesInFlight;
+
+    if (!missing.isEmpty()) {
+        if (m_firstRequestMs < 0) {
+            m_firstRequestMs = m_timer.elapsed();
+        }
+        m_queuedAssets += missing.size();
+        QList<InstallRequirement> critical;
+        for (const InstallRequirement& requirement : missing) {
+            if (requirement.critical) {
+                critical.append(requirement);
+            }
+        }
+        if (!critical.isEmpty()) {
+            emit criticalAssetsQueued(critical);
+        }
+        m_downloadManager->addDownloads(missing);
+    }
+
+    finishIfDone();
+}
+
+void AssetIndexStreamer::finishIfDone()
+{
+    if (!m_indexDone || m_batchesInFlight > 0) {
+        return;
+    }
+
+    qCInfo(assetIndexStreamer) << "Asset index streamed:" << m_parser->entryCount() << "entries,"
+                               << m_queuedAssets << "assets queued, first request after" << m_firstRequestMs
+                               << "ms, index complete after" << m_indexCompleteMs << "ms";
+
+    emit finished(!m_failed);
+}
+
+void AssetIndexStreamer::runBenchmark(const QString& indexPath, int chunkBytes)
+{
+    QFile file(indexPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCWarning(assetIndexStreamer) << "Benchmark needs an asset index:" << indexPath << file.errorString();
+        return;
+    }
+    const QByteArray data = file.readAll();
+    chunkBytes = qMax(1, chunkBytes);
+
+    // <assets>/indexes/<id>.json
+    const QString assetsDirectory = QDir::cleanPath(QFileInfo(indexPath).absolutePath() + "/..");
+    QSet<QString> seen;
+    auto isMissing = [&](const QString& hash, qint64 size) {
+        if (hash.isEmpty() || seen.contains(hash)) {
+            return false;
+        }
+        seen.insert(hash);
+        const QFileInfo info(InstallPlanner::assetObjectPath(assetsDirectory, hash));
+        return !info.exists() || (size >= 0 && info.size() != size);
+    };
+
+    // Buffered: nothing can be checked before the whole document is parsed
+    QElapsedTimer timer;
+    timer.start();
+    const QJsonObject objects = QJsonDocument::fromJson(data).object()["objects"].toObject();
+    const qint64 parseMs = timer.elapsed();
+    qint64 bufferedFirstMs = -1;
+    int missing = 0;
+    for (auto it = objects.constBegin(); it != objects.constEnd(); ++it) {
+        const QJsonObject object = it.value().toObject();
+        if (isMissing(object["hash"].toString(), object["size"].toInteger(-1))) {
+            if (bufferedFirstMs < 0) {
+                bufferedFirstMs = timer.elapsed();
+            }
+            ++missing;
+        }
+    }
+    const qint64 bufferedMs = timer.elapsed();
+
+    // Streamed: every entry is checked as soon as its chunk has been fed
+    seen.clear();
+    qint64 streamedFirstMs = -1;
+    AssetIndexParser parser;
+    QObject::connect(&parser, &AssetIndexParser::assetFound, &parser,
+                     [&](const QString&, const QString& hash, qint64 size) {
+        if (isMissing(hash, size) && streamedFirstMs < 0) {
+            streamedFirstMs = timer.elapsed();
+        }
+    });
+    timer.restart();
+    for (qsizetype offset = 0; offset < data.size(); offset += chunkBytes) {
+        parser.feed(data.mid(offset, chunkBytes));
+    }
+    parser.finish();
+    const qint64 streamedMs = timer.elapsed();
+
+    qCInfo(assetIndexStreamer) << "Asset index" << indexPath << ":" << objects.size() << "entries," << missing
+                               << "objects missing under" << assetsDirectory;
+    qCInfo(assetIndexStreamer) << "  buffered: parse" << parseMs << "ms, first missing object after"
+                               << bufferedFirstMs << "ms, all checked after" << bufferedMs << "ms";
+    qCInfo(assetIndexStreamer) << "  streamed in" << chunkBytes / 1024 << "KiB chunks: first missing object after"
+                               << streamedFirstMs << "ms, all checked after" << streamedMs << "ms";
+}
\ No newline at end of file
@@ -1,5 +1,8 @@
 #include "DownloadManager.h"
 #include "DownloadTask.h"
+#include "utils/FileStateIndex.h"
+#include "utils/BackgroundGovernor.h"
+#include <QFileInfo>
 #include <QLoggingCategory>
 
 Q_LOGGING_CATEGORY(downloadManager, "cryovex.download.manager")
@@ -11,6 +14,11 @@ DownloadManager::DownloadManager(QObject *parent)
 {
     m_progressTimer->setInterval(100); // Update progress every 100ms
     connect(m_progressTimer, &QTimer::timeout, this, &DownloadManager::onDownloadProgress);
+    
+    // While a game runs, fewer transfers share a bandwidth ceiling
+    BackgroundGovernor& governor = BackgroundGovernor::instance();
+    connect(&governor, &BackgroundGovernor::bandwidthLimitChanged, this, &DownloadManager::shareBandwidth);
+    connect(&governor, &BackgroundGovernor::throttledChanged, this, &DownloadManager::processQueue);
 }
 
 int DownloadManager::rowCount(const QModelIndex &parent) const
@@ -21,10 +29,28 @@ int DownloadManager::rowCount(const QModelIndex &parent) const
 
 QVariant DownloadManager::data(const QModelIndex &index, int role) const
 {
-    Q_UNUSED(index)
-    Q_UNUSED(role)
-    // Stub implementation
-    return QVariant();
+    if (!index.isValid() || index.row() >= m_allTasks.size()) {
+        return QVariant();
+    }
+    
+    DownloadTask* task = m_allTasks.at(index.row());
+    
+    switch (role) {
+    case UrlRole:
+        return task->url();
+    case FilePathRole:
+        return task->filePath();
+    case ProgressRole:
+        return task->progress();
+    case StatusRole:
+        return task->status();
+    case SpeedRole:
+        return task->downloadSpeed();
+    case SizeRole:
+        return task->expectedSize() >= 0 ? task->expectedSize() : task->totalBytes();
+    default:
+        return QVariant();
+    }
 }
 
 QHash<int, QByteArray> DownloadManager::roleNames() const
@@ -41,60 +67,284 @@ QHash<int, QByteArray> DownloadManager::roleNames() const
 
 double DownloadManager::totalProgress() const
 {
-    // Stub implementation
-    return 0.0;
+    if (m_totalBytes <= 0) {
+        return 0.0;
+    }
+    
+    qint64 bytes = m_completedBytes;
+    for (DownloadTask* task : m_activeDownloads) {
+        bytes += task->downloadedBytes();
+    }
+    
+    return qMin(1.0, static_cast<double>(bytes) / m_totalBytes);
 }
 
 void DownloadManager::addDownload(const QString& url, const QString& filePath, const QString& expectedSha1)
 {
-    qCInfo(downloadManager) << "Adding download:" << url << "to" << filePath << "(stub)";
-    Q_UNUSED(url)
-    Q_UNUSED(filePath)
-    Q_UNUSED(expectedSha1)
+    qCInfo(downloadManager) << "Adding download:" << url << "to" << filePath;
+    
+    beginInsertRows(QModelIndex(), m_allTasks.size(), m_allTasks.size());
+    DownloadTask* task = createTask(QUrl(url), filePath, expectedSha1, -1);
+    m_allTasks.append(task);
+    m_queuedDownloads.enqueue(task);
+    endInsertRows();
+    
+    emit queuedDownloadsChanged();
+    emit downloadingStatusChanged();
+    processQueue();
+}
+
+void DownloadManager::addDownloads(const QList<InstallRequirement>& requirements)
+{
+    if (requirements.isEmpty()) {
+        return;
+    }
+    
+    qCInfo(downloadManager) << "Adding" << requirements.size() << "downloads";
+    
+    beginInsertRows(QModelIndex(), m_allTasks.size(), m_allTasks.size() + requirements.size() - 1);
+    for (const InstallRequirement& requirement : requirements) {
+        DownloadTask* task = createTask(requirement.url, requirement.filePath,
+                                        requirement.sha1, requirement.size);
+        m_allTasks.append(task);
+        if (requirement.critical) {
+            m_queuedDownloads.enqueue(task);
+        } else {
+            m_deferredDownloads.enqueue(task);
+        }
+        if (requirement.size > 0) {
+            m_totalBytes += requirement.size;
+        }
+    }
+    endInsertRows();
+    
+    emit queuedDownloadsChanged();
+    emit downloadingStatusChanged();
+    emit totalBytesChanged();
+    processQueue();
+}
+
+DownloadTask* DownloadManager::addPriorityDownload(const InstallRequirement& requirement)
+{
+    qCInfo(downloadManager) << "Adding priority download:" << requirement.url.toString();
+    
+    beginInsertRows(QModelIndex(), m_allTasks.size(), m_allTasks.size());
+    DownloadTask* task = createTask(requirement.url, requirement.filePath,
+                                    requirement.sha1, requirement.size);
+    m_allTasks.append(task);
+    endInsertRows();
+    
+    if (requirement.size > 0) {
+        m_totalBytes += requirement.size;
+        emit totalBytesChanged();
+    }
+    
+    // Starts right away, even above the concurrency limit
+    if (m_paused) {
+        m_queuedDownloads.prepend(task);
+        emit queuedDownloadsChanged();
+    } else {
+        m_activeDownloads.append(task);
+        task->start(m_networkManager);
+        shareBandwidth();
+        if (!m_progressTimer->isActive()) {
+            m_progressTimer->start();
+        }
+        emit activeDownloadsChanged();
+    }
+    emit downloadingStatusChanged();
+    
+    return task;
 }
 
 void DownloadManager::pauseAll()
 {
-    qCInfo(downloadManager) << "Pausing all downloads (stub)";
+    qCInfo(downloadManager) << "Pausing all downloads";
+    m_paused = true;
+    
+    // Aborted transfers go back to the front of the queue
+    const QList<DownloadTask*> active = m_activeDownloads;
+    m_activeDownloads.clear();
+    for (int i = active.size() - 1; i >= 0; --i) {
+        DownloadTask* task = active.at(i);
+        task->pause();
+        task->resume();
+        m_queuedDownloads.prepend(task);
+    }
+    
+    m_progressTimer->stop();
+    emit activeDownloadsChanged();
+    emit queuedDownloadsChanged();
 }
 
 void DownloadManager::resumeAll()
 {
-    qCInfo(downloadManager) << "Resuming all downloads (stub)";
+    qCInfo(downloadManager) << "Resuming all downloads";
+    m_paused = false;
+    processQueue();
 }
 
 void DownloadManager::cancelAll()
 {
-    qCInfo(downloadManager) << "Cancelling all downloads (stub)";
+    qCInfo(downloadManager) << "Cancelling all downloads";
+    
+    const QList<DownloadTask*> active = m_activeDownloads;
+    m_activeDownloads.clear();
+    for (DownloadTask* task : active) {
+        task->cancel();
+    }
+    m_queuedDownloads.clear();
+    m_deferredDownloads.clear();
+    
+    beginResetModel();
+    qDeleteAll(m_allTasks);
+    m_allTasks.clear();
+    endResetModel();
+    
+    m_totalBytes = 0;
+    m_completedBytes = 0;
+    m_progressTimer->stop();
+    
+    emit activeDownloadsChanged();
+    emit queuedDownloadsChanged();
+    emit downloadingStatusChanged();
+    emit totalBytesChanged();
+    emit totalProgressChanged();
 }
 
 void DownloadManager::setMaxConcurrentDownloads(int max)
 {
-    m_maxConcurrentDownloads = max;
-    qCInfo(downloadManager) << "Set max concurrent downloads to:" << max;
+    m_maxConcurrentDownloads = qMax(1, max);
+    qCInfo(downloadManager) << "Set max concurrent downloads to:" << m_maxConcurrentDownloads;
+    processQueue();
 }
 
 void DownloadManager::onDownloadFinished()
 {
-    // Stub implementation
+    DownloadTask* task = qobject_cast<DownloadTask*>(sender());
+    if (!task) {
+        return;
+    }
+    
+    m_completedBytes += task->expectedSize() > 0 ? task->expectedSize() : task->downloadedBytes();
+    
+    // The task hashed the file while writing it, so the next plan need not
+    if (!task->expectedSha1().isEmpty()) {
+        FileStateIndex::instance().recordVerified(QFileInfo(task->filePath()), task->expectedSha1());
+    }
+    
+    emit downloadCompleted(task->filePath());
+    finishTask(task);
 }
 
 void DownloadManager::onDownloadProgress()
 {
-    // Stub implementation
+    for (DownloadTask* task : m_activeDownloads) {
+        const int row = m_allTasks.indexOf(task);
+        if (row != -1) {
+            const QModelIndex modelIndex = index(row);
+            emit dataChanged(modelIndex, modelIndex, {ProgressRole, SpeedRole});
+        }
+    }
+    emit totalProgressChanged();
 }
 
 void DownloadManager::processQueue()
 {
-    // Stub implementation
+    if (m_paused) {
+        return;
+    }
+    
+    const int limit = concurrencyLimit();
+    while (m_activeDownloads.size() < limit && queuedDownloads() > 0) {
+        startNextDownload();
+    }
+}
+
+int DownloadManager::concurrencyLimit() const
+{
+    if (BackgroundGovernor::instance().isThrottled()) {
+        return qMin(m_maxConcurrentDownloads, BackgroundGovernor::THROTTLED_DOWNLOADS);
+    }
+    return m_maxConcurrentDownloads;
+}
+
+void DownloadManager::shareBandwidth()
+{
+    const qint64 limit = BackgroundGovernor::instance().bandwidthLimit();
+    const qint64 share = limit > 0 && !m_activeDownloads.isEmpty() ? qMax<qint64>(1, limit / m_activeDownloads.size()) : 0;
+    for (DownloadTask* task : std::as_const(m_activeDownloads)) {
+        task->setRateLimit(share);
+    }
+}
+
+DownloadTask* DownloadManager::createTask(const QUrl& url, const QString& filePath,
+                                          const QString& expectedSha1, qint64 expectedSize)
+{
+    DownloadTask* task = new DownloadTask(url, filePath, expectedSha1, this);
+    task->setExpectedSize(expectedSize);
+    
+    connect(task, &DownloadTask::finished, this, &DownloadManager::onDownloadFinished);
+    connect(task, &DownloadTask::error, this, [this, task](const QString& errorString) {
+        emit downloadFailed(task->url().toString(), errorString);
+        finishTask(task);
+    });
+    
+    return task;
 }
 
 void DownloadManager::startNextDownload()
 {
-    // Stub implementation
+    DownloadTask* task = !m_queuedDownloads.isEmpty() ? m_queuedDownloads.dequeue() : m_deferredDownloads.dequeue();
+    m_activeDownloads.append(task);
+    task->start(m_networkManager);
+    shareBandwidth();
+    
+    if (!m_progressTimer->isActive()) {
+        m_progressTimer->start();
+    }
+    
+    emit activeDownloadsChanged();
+    emit queuedDownloadsChanged();
+}
+
+void DownloadManager::finishTask(DownloadTask* task)
+{
+    if (!m_activeDownloads.removeOne(task)) {
+        return;
+    }
+    
+    emit activeDownloadsChanged();
+    processQueue();
+    shareBandwidth();
+    
+    if (m_activeDownloads.isEmpty() && queuedDownloads() == 0) {
+        m_progressTimer->stop();
+        emit totalProgressChanged();
+        emit downloadingStatusChanged();
+        emit allDownloadsCompleted();
+        removeCompletedDownloads();
+    }
 }
 
 void DownloadManager::removeCompletedDownloads()
 {
-    // Stub implementation
+    // Failed and cancelled tasks stay visible in the model
+    beginResetModel();
+    QList<DownloadTask*> remaining;
+    for (DownloadTask* task : m_allTasks) {
+        if (task->status() == DownloadTask::Completed) {
+            task->deleteLater();
+        } else {
+            remaining.append(task);
+        }
+    }
+    m_allTasks = remaining;
+    endResetModel();
+    
+    if (m_allTasks.isEmpty()) {
+        m_totalBytes = 0;
+        m_completedBytes = 0;
+        emit totalBytesChanged();
+    }
 }
\ No newline at end of file
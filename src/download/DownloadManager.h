@@ -5,6 +5,7 @@
 #include <QQueue>
 #include <QTimer>
 #include <QAbstractListModel>
+#include "InstallPlanner.h"
 
 class DownloadTask;
 
@@ -15,6 +16,7 @@ class DownloadManager : public QAbstractListModel
     Q_PROPERTY(int queuedDownloads READ queuedDownloads NOTIFY queuedDownloadsChanged)
     Q_PROPERTY(double totalProgress READ totalProgress NOTIFY totalProgressChanged)
     Q_PROPERTY(bool isDownloading READ isDownloading NOTIFY downloadingStatusChanged)
+    Q_PROPERTY(qint64 totalBytes READ totalBytes NOTIFY totalBytesChanged)
 
 public:
     enum DownloadRoles {
@@ -34,12 +36,16 @@ public:
     QHash<int, QByteArray> roleNames() const override;
     
     int activeDownloads() const { return m_activeDownloads.size(); }
-    int queuedDownloads() const { return m_queuedDownloads.size(); }
+    int queuedDownloads() const { return m_queuedDownloads.size() + m_deferredDownloads.size(); }
     double totalProgress() const;
-    bool isDownloading() const { return !m_activeDownloads.isEmpty() || !m_queuedDownloads.isEmpty(); }
+    bool isDownloading() const { return !m_activeDownloads.isEmpty() || queuedDownloads() > 0; }
+    qint64 totalBytes() const { return m_totalBytes; }
     
     Q_INVOKABLE void addDownload(const QString& url, const QString& filePath, 
                                 const QString& expectedSha1 = QString());
+    // Critical requirements start before any non-critical one still queued
+    void addDownloads(const QList<InstallRequirement>& requirements);
+    DownloadTask* addPriorityDownload(const InstallRequirement& requirement);
     Q_INVOKABLE void pauseAll();
     Q_INVOKABLE void resumeAll();
     Q_INVOKABLE void cancelAll();
@@ -50,6 +56,7 @@ signals:
     void queuedDownloadsChanged();
     void totalProgressChanged();
     void downloadingStatusChanged();
+    void totalBytesChanged();
     void downloadCompleted(const QString& filePath);
     void downloadFailed(const QString& url, const QString& error);
     void allDownloadsCompleted();
@@ -60,14 +67,23 @@ private slots:
     void processQueue();
 
 private:
+    DownloadTask* createTask(const QUrl& url, const QString& filePath,
+                             const QString& expectedSha1, qint64 expectedSize);
     void startNextDownload();
+    void finishTask(DownloadTask* task);
     void removeCompletedDownloads();
+    int concurrencyLimit() const;
+    void shareBandwidth();
     
     QNetworkAccessManager* m_networkManager;
     QList<DownloadTask*> m_activeDownloads;
     QQueue<DownloadTask*> m_queuedDownloads;
+    QQueue<DownloadTask*> m_deferredDownloads; // non-critical, after m_queuedDownloads
     QList<DownloadTask*> m_allTasks; // For model interface
     
     int m_maxConcurrentDownloads = 4;
+    bool m_paused = false;
+    qint64 m_totalBytes = 0;
+    qint64 m_completedBytes = 0;
     QTimer* m_progressTimer;
 };
\ No newline at end of file
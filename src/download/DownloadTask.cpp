@@ -62,16 +62,63 @@ void DownloadTask::start(QNetworkAccessManager* manager)
     connect(m_reply, &QNetworkReply::downloadProgress, this, &DownloadTask::onDownloadProgress);
     connect(m_reply, QOverload<QNetworkReply::NetworkError>::of(&QNetworkReply::errorOccurred),
             this, &DownloadTask::onError);
+    applyRateLimit();
     
     setStatus(Downloading);
     m_speedTimer.start();
     m_lastBytes = 0;
 }
 
+void DownloadTask::setRateLimit(qint64 bytesPerSecond)
+{
+    bytesPerSecond = qMax<qint64>(0, bytesPerSecond);
+    if (m_rateLimit != bytesPerSecond) {
+        m_rateLimit = bytesPerSecond;
+        applyRateLimit();
+    }
+}
+
+void DownloadTask::applyRateLimit()
+{
+    if (!m_reply) {
+        return;
+    }
+    
+    // Once the read buffer is full Qt stops reading the socket, and TCP flow
+    // control slows the server down to the rate we drain it at
+    const qint64 perTick = m_rateLimit * RATE_TICK_MS / 1000;
+    m_reply->setReadBufferSize(m_rateLimit > 0 ? qMax(perTick, MIN_READ_BUFFER) : 0);
+    
+    if (m_rateLimit > 0) {
+        if (!m_rateTimer) {
+            m_rateTimer = new QTimer(this);
+            m_rateTimer->setInterval(RATE_TICK_MS);
+            connect(m_rateTimer, &QTimer::timeout, this, &DownloadTask::onRateTick);
+        }
+        m_budget = perTick;
+        m_rateTimer->start();
+    } else {
+        if (m_rateTimer) {
+            m_rateTimer->stop();
+        }
+        onReadyRead();
+    }
+}
+
+void DownloadTask::onRateTick()
+{
+    // Unused budget does not carry over, so there are no bursts
+    m_budget = m_rateLimit * RATE_TICK_MS / 1000;
+    onReadyRead();
+}
+
 void DownloadTask::pause()
 {
     if (m_status == Downloading && m_reply) {
+        // Detach first so the abort is not reported as a failure
+        m_reply->disconnect(this);
         m_reply->abort();
+        cleanup();
         setStatus(Paused);
     }
 }
@@ -91,6 +138,7 @@ void DownloadTask::resume()
 void DownloadTask::cancel()
 {
     if (m_reply) {
+        m_reply->disconnect(this);
         m_reply->abort();
     }
     cleanup();
@@ -99,11 +147,23 @@ void DownloadTask::cancel()
 
 void DownloadTask::onReadyRead()
 {
-    if (!m_file || !m_reply) {
+    if (m_rateLimit > 0) {
+        readReply(m_budget);
+    } else {
+        readReply(-1);
+    }
+}
+
+void DownloadTask::readReply(qint64 maxBytes)
+{
+    if (!m_file || !m_reply || maxBytes == 0) {
         return;
     }
     
-    QByteArray data = m_reply->readAll();
+    QByteArray data = maxBytes < 0 ? m_reply->readAll() : m_reply->read(maxBytes);
+    if (maxBytes > 0) {
+        m_budget -= data.size();
+    }
     if (m_hash) {
         m_hash->addData(data);
     }
@@ -112,6 +172,11 @@ void DownloadTask::onReadyRead()
     if (written != data.size()) {
         qCWarning(downloadTask) << "Failed to write all data to file";
         onError(QNetworkReply::UnknownContentError);
+        return;
+    }
+    
+    if (!data.isEmpty()) {
+        emit dataReceived(data);
     }
 }
 
@@ -126,8 +191,8 @@ void DownloadTask::onFinished()
         return; // Error will be handled by onError
     }
     
-    // Read any remaining data
-    onReadyRead();
+    // Read any remaining data, whatever the rate limit
+    readReply(-1);
     
     if (m_file) {
         m_file->close();
@@ -217,6 +282,10 @@ bool DownloadTask::verifySha1()
 
 void DownloadTask::cleanup()
 {
+    if (m_rateTimer) {
+        m_rateTimer->stop();
+    }
+    
     if (m_reply) {
         m_reply->deleteLater();
         m_reply = nullptr;
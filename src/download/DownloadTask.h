@@ -5,6 +5,7 @@
 #include <QFile>
 #include <QCryptographicHash>
 #include <QElapsedTimer>
+#include <QTimer>
 #include <QUrl>
 
 class DownloadTask : public QObject
@@ -34,7 +35,11 @@ public:
     double progress() const { return m_progress; }
     qint64 downloadedBytes() const { return m_downloadedBytes; }
     qint64 totalBytes() const { return m_totalBytes; }
+    qint64 expectedSize() const { return m_expectedSize; }
+    void setExpectedSize(qint64 size) { m_expectedSize = size; }
     double downloadSpeed() const; // bytes per second
+    // Paces reading from the reply; 0 reads as fast as data arrives
+    void setRateLimit(qint64 bytesPerSecond);
     
     void start(QNetworkAccessManager* manager);
     void pause();
@@ -46,6 +51,7 @@ signals:
     void statusChanged();
     void finished();
     void error(const QString& errorString);
+    void dataReceived(const QByteArray& data);
 
 private slots:
     void onReadyRead();
@@ -56,6 +62,9 @@ private slots:
 private:
     void setStatus(Status status);
     void setProgress(double progress);
+    void readReply(qint64 maxBytes);
+    void applyRateLimit();
+    void onRateTick();
     bool verifySha1();
     void cleanup();
     
@@ -66,6 +75,7 @@ private:
     double m_progress = 0.0;
     qint64 m_downloadedBytes = 0;
     qint64 m_totalBytes = 0;
+    qint64 m_expectedSize = -1;
     
     QNetworkReply* m_reply = nullptr;
     QFile* m_file = nullptr;
@@ -73,4 +83,11 @@ private:
     QElapsedTimer m_speedTimer;
     qint64 m_lastBytes = 0;
     double m_currentSpeed = 0.0;
+
+    static constexpr int RATE_TICK_MS = 100;
+    static constexpr qint64 MIN_READ_BUFFER = 16 * 1024;
+
+    qint64 m_rateLimit = 0;
+    qint64 m_budget = 0; // bytes left to read this tick
+    QTimer* m_rateTimer = nullptr;
 };
\ No newline at end of file
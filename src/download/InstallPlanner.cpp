@@ -0,0 +1,440 @@
+#include "InstallPlanner.h"
+#include "DownloadManager.h"
+#include "AssetIndexStreamer.h"
+#include "utils/FileStateIndex.h"
+#include "utils/CompiledManifest.h"
+#include "utils/NativesCache.h"
+#include "utils/FileUtils.h"
+#include "utils/NetworkUtils.h"
+#include "utils/AssetClassifier.h"
+#include "utils/BackgroundGovernor.h"
+#include <QJsonDocument>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QVector>
+#include <QSet>
+#include <QHash>
+#include <QSharedPointer>
+#include <QLoggingCategory>
+#include <atomic>
+
+Q_LOGGING_CATEGORY(installPlanner, "cryovex.download.planner")
+
+namespace {
+
+// Critical files of a submitted plan that are not on disk yet
+struct CriticalGate
+{
+    QString versionId;
+    QSet<QString> pendingPaths;
+    QSet<QString> pendingUrls;
+    bool sealed = true; // false while a streamed asset index can add more
+    bool done = false;
+    QElapsedTimer timer;
+};
+
+}
+
+InstallPlanner::InstallPlanner(QObject *parent)
+    : QObject(parent)
+{
+    m_coordinator.setMaxThreadCount(1);
+    BackgroundGovernor::instance().registerPool(&m_pool);
+}
+
+InstallPlanner::~InstallPlanner()
+{
+    m_coordinator.waitForDone();
+    m_pool.waitForDone();
+}
+
+InstallPlan InstallPlanner::plan(const QString& versionId, const QJsonObject& versionManifest,
+                                 const QString& gameDirectory)
+{
+    QElapsedTimer totalTimer;
+    totalTimer.start();
+
+    InstallPlan plan;
+    plan.versionId = versionId;
+    plan.gameDirectory = gameDirectory;
+
+    // Expand the manifest into a flat requirement set
+    QElapsedTimer phaseTimer;
+    phaseTimer.start();
+    expandClient(plan, versionManifest, plan.requirements);
+    expandLibraries(plan, versionManifest, plan.requirements);
+    plan.assetsPending = !expandAssetIndex(plan, versionManifest, plan.requirements);
+    plan.timings.expandMs = phaseTimer.elapsed();
+
+    // Stat/verify in batches on the pool; each batch writes only its own flags
+    phaseTimer.restart();
+    const int count = plan.requirements.size();
+    QVector<char> missingFlags(count, 0);
+    char* flags = missingFlags.data();
+    const InstallRequirement* requirements = plan.requirements.constData();
+    std::atomic<qint64> hashNanoseconds{0};
+    std::atomic<int> filesHashed{0};
+
+    const int batchSize = qMax(64, count / (qMax(1, m_pool.maxThreadCount()) * 4) + 1);
+    for (int begin = 0; begin < count; begin += batchSize) {
+        const int end = qMin(begin + batchSize, count);
+        m_pool.start([this, flags, requirements, begin, end, &hashNanoseconds, &filesHashed]() {
+            BackgroundGovernor::applyThreadPriority();
+            for (int i = begin; i < end; ++i) {
+                qint64 nanoseconds = 0;
+                bool hashed = false;
+                flags[i] = needsDownload(requirements[i], &nanoseconds, &hashed) ? 1 : 0;
+                if (hashed) {
+                    hashNanoseconds += nanoseconds;
+                    ++filesHashed;
+                }
+            }
+        });
+    }
+    m_pool.waitForDone();
+
+    for (int i = 0; i < count; ++i) {
+        if (flags[i]) {
+            const InstallRequirement& requirement = requirements[i];
+            plan.missing.append(requirement);
+            if (requirement.size > 0) {
+                plan.totalBytes += requirement.size;
+            }
+        }
+    }
+    plan.timings.checkMs = phaseTimer.elapsed();
+    plan.timings.hashMs = hashNanoseconds / 1000000;
+    plan.timings.filesChecked = count;
+    plan.timings.filesHashed = filesHashed;
+
+    FileStateIndex::instance().save();
+    plan.timings.totalMs = totalTimer.elapsed();
+
+    qCInfo(installPlanner) << "Planned" << plan.versionId << ":" << plan.missing.size() << "of" << count
+                           << "files missing," << plan.totalBytes << "bytes"
+                           << (plan.assetsPending ? "(assets pending index)" : "");
+    qCInfo(installPlanner) << "Planning time: expand" << plan.timings.expandMs << "ms, check"
+                           << plan.timings.checkMs << "ms (hashed" << plan.timings.filesHashed << "files in"
+                           << plan.timings.hashMs << "ms), total" << plan.timings.totalMs << "ms";
+
+    return plan;
+}
+
+void InstallPlanner::planAsync(const QString& versionId, const QJsonObject& versionManifest,
+                               const QString& gameDirectory)
+{
+    m_coordinator.start([this, versionId, versionManifest, gameDirectory]() {
+        const InstallPlan result = plan(versionId, versionManifest, gameDirectory);
+        QMetaObject::invokeMethod(this, [this, result]() {
+            emit planReady(result);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void InstallPlanner::submit(const InstallPlan& plan, DownloadManager* downloadManager)
+{
+    if (!downloadManager) {
+        return;
+    }
+
+    // Natives are extracted in the background as soon as their jar is on disk,
+    // overlapping with the rest of the downloads
+    QSet<QString> missingPaths;
+    for (const InstallRequirement& requirement : plan.missing) {
+        missingPaths.insert(requirement.filePath);
+    }
+
+    QHash<QString, NativeJar> pendingNatives;
+    for (const InstallRequirement& requirement : plan.requirements) {
+        if (requirement.kind != InstallRequirement::Native) {
+            continue;
+        }
+        const NativeJar jar{requirement.filePath, requirement.sha1, requirement.extractExclude};
+        if (missingPaths.contains(requirement.filePath)) {
+            pendingNatives.insert(requirement.filePath, jar);
+        } else {
+            NativesCache::instance().extractAsync(jar);
+        }
+    }
+
+    if (!pendingNatives.isEmpty()) {
+        auto* context = new QObject(this);
+        connect(downloadManager, &DownloadManager::downloadCompleted, context,
+                [context, pendingNatives](const QString& filePath) mutable {
+            auto it = pendingNatives.find(filePath);
+            if (it == pendingNatives.end()) {
+                return;
+            }
+            NativesCache::instance().extractAsync(it.value());
+            pendingNatives.erase(it);
+            if (pendingNatives.isEmpty()) {
+                context->deleteLater();
+            }
+        });
+        connect(downloadManager, &DownloadManager::allDownloadsCompleted, context, &QObject::deleteLater);
+    }
+
+    if (plan.missing.isEmpty()) {
+        emit criticalFilesReady(plan.versionId, 0, 0);
+        return;
+    }
+
+    // The game can start once the critical files are in; sounds, music and
+    // other languages keep downloading behind them
+    auto gate = QSharedPointer<CriticalGate>::create();
+    gate->versionId = plan.versionId;
+    gate->timer.start();
+    auto addCritical = [gate](const QList<InstallRequirement>& requirements) {
+        for (const InstallRequirement& requirement : requirements) {
+            if (requirement.critical) {
+                gate->pendingPaths.insert(requirement.filePath);
+                gate->pendingUrls.insert(requirement.url.toString());
+            }
+        }
+    };
+    addCritical(plan.missing);
+
+    auto* gateContext = new QObject(this);
+    // Queued, so the finished task no longer counts as remaining
+    auto checkGate = [this, gate, gateContext, downloadManager]() {
+        if (gate->done || !gate->sealed || !gate->pendingPaths.isEmpty()) {
+            return;
+        }
+        gate->done = true;
+        const int remaining = downloadManager->activeDownloads() + downloadManager->queuedDownloads();
+        qCInfo(installPlanner) << "Critical files of" << gate->versionId << "ready after" << gate->timer.elapsed()
+                               << "ms," << remaining << "downloads remaining";
+        emit criticalFilesReady(gate->versionId, gate->timer.elapsed(), remaining);
+        gateContext->deleteLater();
+    };
+    auto failGate = [this, gate, gateContext](const QString& error) {
+        if (gate->done) {
+            return;
+        }
+        gate->done = true;
+        emit criticalFilesFailed(gate->versionId, error);
+        gateContext->deleteLater();
+    };
+    connect(downloadManager, &DownloadManager::downloadCompleted, gateContext,
+            [gate, gateContext, checkGate](const QString& filePath) {
+        if (gate->pendingPaths.remove(filePath)) {
+            QMetaObject::invokeMethod(gateContext, checkGate, Qt::QueuedConnection);
+        }
+    });
+    connect(downloadManager, &DownloadManager::downloadFailed, gateContext,
+            [gate, failGate](const QString& url, const QString& error) {
+        if (gate->pendingUrls.contains(url)) {
+            failGate(QString("Download of %1 failed: %2").arg(url, error));
+        }
+    });
+
+    QList<InstallRequirement> jobs = plan.missing;
+
+    // Without an index on disk the assets are planned while the index streams in
+    if (plan.assetsPending) {
+        for (int i = 0; i < jobs.size(); ++i) {
+            if (jobs.at(i).kind == InstallRequirement::AssetIndex) {
+                auto* streamer = new AssetIndexStreamer(assetsDirectory(plan.gameDirectory), downloadManager, this);
+                gate->sealed = false;
+                connect(streamer, &AssetIndexStreamer::criticalAssetsQueued, gateContext, addCritical);
+                connect(streamer, &AssetIndexStreamer::finished, gateContext, [gate, checkGate, failGate](bool success) {
+                    if (!success) {
+                        failGate("The asset index could not be read");
+                        return;
+                    }
+                    gate->sealed = true;
+                    checkGate();
+                });
+                connect(streamer, &AssetIndexStreamer::finished, streamer, &QObject::deleteLater);
+                streamer->start(jobs.takeAt(i));
+                break;
+            }
+        }
+    }
+
+    downloadManager->addDownloads(jobs);
+
+    // Only sounds, music or other languages missing: no download will open the gate
+    if (gate->pendingPaths.isEmpty()) {
+        QMetaObject::invokeMethod(gateContext, checkGate, Qt::QueuedConnection);
+    }
+}
+
+QString InstallPlanner::librariesDirectory(const QString& gameDirectory)
+{
+    return QDir(gameDirectory).filePath("libraries");
+}
+
+QString InstallPlanner::assetsDirectory(const QString& gameDirectory)
+{
+    return QDir(gameDirectory).filePath("assets");
+}
+
+QString InstallPlanner::assetObjectPath(const QString& assetsDirectory, const QString& hash)
+{
+    return assetsDirectory + "/objects/" + hash.left(2) + "/" + hash;
+}
+
+QUrl InstallPlanner::assetObjectUrl(const QString& hash)
+{
+    return QUrl(NetworkUtils::MINECRAFT_RESOURCES_URL + "/" + hash.left(2) + "/" + hash);
+}
+
+void InstallPlanner::expandClient(const InstallPlan& plan, const QJsonObject& manifest,
+                                  QList<InstallRequirement>& out) const
+{
+    const QJsonObject client = manifest["downloads"].toObject()["client"].toObject();
+    if (client.isEmpty()) {
+        return;
+    }
+
+    InstallRequirement requirement;
+    requirement.kind = InstallRequirement::ClientJar;
+    requirement.url = QUrl(client["url"].toString());
+    requirement.filePath = QDir(plan.gameDirectory).filePath("versions/" + plan.versionId + "/" + plan.versionId + ".jar");
+    requirement.sha1 = client["sha1"].toString();
+    requirement.size = client["size"].toInteger(-1);
+    out.append(requirement);
+}
+
+void InstallPlanner::expandLibraries(const InstallPlan& plan, const QJsonObject& manifest,
+                                     QList<InstallRequirement>& out) const
+{
+    const QString librariesDir = librariesDirectory(plan.gameDirectory);
+
+    // Other platforms' libraries were dropped when the manifest was compiled
+    const QSharedPointer<const CompiledManifest> compiled = CompiledManifest::get(manifest);
+    for (const CompiledLibrary* library : compiled->librariesFor(m_features)) {
+        // Entries with an empty url are generated locally (e.g. by the Forge installer)
+        if (library->hasArtifact() && !library->url.isEmpty()) {
+            InstallRequirement requirement;
+            requirement.kind = InstallRequirement::Library;
+            requirement.url = library->url;
+            requirement.filePath = librariesDir + "/" + library->path;
+            requirement.sha1 = library->sha1;
+            requirement.size = library->size;
+            out.append(requirement);
+        }
+
+        if (library->hasNative()) {
+            InstallRequirement requirement;
+            requirement.kind = InstallRequirement::Native;
+            requirement.url = library->nativeUrl;
+            requirement.filePath = librariesDir + "/" + library->nativePath;
+            requirement.sha1 = library->nativeSha1;
+            requirement.size = library->nativeSize;
+            requirement.extractExclude = library->extractExclude;
+            out.append(requirement);
+        }
+    }
+}
+
+bool InstallPlanner::expandAssetIndex(const InstallPlan& plan, const QJsonObject& manifest,
+                                      QList<InstallRequirement>& out) const
+{
+    const QJsonObject assetIndex = manifest["assetIndex"].toObject();
+    if (assetIndex.isEmpty()) {
+        return true;
+    }
+
+    const QString assetsDir = assetsDirectory(plan.gameDirectory);
+
+    InstallRequirement index;
+    index.kind = InstallRequirement::AssetIndex;
+    index.url = QUrl(assetIndex["url"].toString());
+    index.filePath = assetsDir + "/indexes/" + assetIndex["id"].toString() + ".json";
+    index.sha1 = assetIndex["sha1"].toString();
+    index.size = assetIndex["size"].toInteger(-1);
+    out.append(index);
+
+    // Objects can only be planned once a valid index is on disk
+    qint64 nanoseconds = 0;
+    bool hashed = false;
+    if (needsDownload(index, &nanoseconds, &hashed)) {
+        return false;
+    }
+
+    QFile file(index.filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCWarning(installPlanner) << "Failed to open asset index:" << file.errorString();
+        return false;
+    }
+
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &error);
+    if (error.error != QJsonParseError::NoError) {
+        qCWarning(installPlanner) << "Failed to parse asset index:" << error.errorString();
+        return false;
+    }
+
+    const QJsonObject objects = doc.object()["objects"].toObject();
+    const QString language = AssetClassifier::systemLanguage();
+    out.reserve(out.size() + objects.size());
+    // Several names can share one object; two jobs writing one path would
+    // corrupt it and count its bytes twice
+    QHash<QString, qsizetype> planned;
+    for (auto it = objects.constBegin(); it != objects.constEnd(); ++it) {
+        const QJsonObject object = it.value().toObject();
+        const QString hash = object["hash"].toString();
+        if (hash.isEmpty()) {
+            continue;
+        }
+
+        const bool critical = AssetClassifier::isNeededAtStartup(it.key(), language);
+        const auto existing = planned.constFind(hash);
+        if (existing != planned.constEnd()) {
+            out[existing.value()].critical |= critical;
+            continue;
+        }
+        planned.insert(hash, out.size());
+
+        InstallRequirement requirement;
+        requirement.kind = InstallRequirement::Asset;
+        requirement.url = assetObjectUrl(hash);
+        requirement.filePath = assetObjectPath(assetsDir, hash);
+        requirement.sha1 = hash;
+        requirement.size = object["size"].toInteger(-1);
+        requirement.critical = critical;
+        out.append(requirement);
+    }
+
+    return true;
+}
+
+bool InstallPlanner::needsDownload(const InstallRequirement& requirement, qint64* hashNanoseconds, bool* hashed) const
+{
+    QFileInfo info(requirement.filePath);
+    if (!info.exists()) {
+        return true;
+    }
+
+    if (requirement.size >= 0 && info.size() != requirement.size) {
+        return true;
+    }
+
+    if (m_verifyMode == StatOnly || requirement.sha1.isEmpty()) {
+        return false;
+    }
+
+    FileStateIndex& index = FileStateIndex::instance();
+    if (m_verifyMode == VerifyChanged && index.isVerified(info, requirement.sha1)) {
+        return false;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    const bool valid = FileUtils::verifySha1(requirement.filePath, requirement.sha1);
+    *hashNanoseconds = timer.nsecsElapsed();
+    *hashed = true;
+
+    if (!valid) {
+        qCWarning(installPlanner) << "Checksum mismatch, will re-download:" << requirement.filePath;
+        index.invalidate(requirement.filePath);
+        return true;
+    }
+
+    index.recordVerified(info, requirement.sha1);
+    return false;
+}
\ No newline at end of file
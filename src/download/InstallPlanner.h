@@ -0,0 +1,112 @@
+#pragma once
+
+#include <QObject>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QList>
+#include <QUrl>
+#include <QStringList>
+#include <QThreadPool>
+
+class DownloadManager;
+
+struct InstallRequirement
+{
+    enum Kind {
+        ClientJar,
+        Library,
+        Native,
+        AssetIndex,
+        Asset
+    };
+
+    Kind kind = Library;
+    QUrl url;
+    QString filePath;
+    QString sha1;
+    qint64 size = -1;
+    QStringList extractExclude; // natives only
+    bool critical = true;       // read before the title screen; the rest may arrive while the game runs
+};
+
+struct InstallPlanTimings
+{
+    qint64 expandMs = 0;  // manifest -> requirement set
+    qint64 checkMs = 0;   // parallel stat/verify against disk (wall clock)
+    qint64 hashMs = 0;    // time spent hashing, summed over workers
+    qint64 totalMs = 0;
+    int filesChecked = 0;
+    int filesHashed = 0;
+};
+
+struct InstallPlan
+{
+    QString versionId;
+    QString gameDirectory;                  // the plan's files live under it
+    QList<InstallRequirement> requirements; // everything the version needs
+    QList<InstallRequirement> missing;      // minimal job list
+    qint64 totalBytes = 0;                  // bytes left to download
+    bool assetsPending = false;             // asset index not on disk yet
+    InstallPlanTimings timings;
+
+    bool isComplete() const { return missing.isEmpty() && !assetsPending; }
+};
+
+// Expands a resolved version manifest into the flat set of files it needs and
+// diffs that set against disk on a thread pool.
+class InstallPlanner : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum VerifyMode {
+        StatOnly,      // existence and size
+        VerifyChanged, // hash files whose size/mtime differ from the last verification
+        VerifyAll      // hash everything
+    };
+    Q_ENUM(VerifyMode)
+
+    explicit InstallPlanner(QObject *parent = nullptr);
+    ~InstallPlanner();
+
+    VerifyMode verifyMode() const { return m_verifyMode; }
+    void setVerifyMode(VerifyMode mode) { m_verifyMode = mode; }
+
+    // RuleEngine::Feature bits the libraries are selected for
+    quint32 features() const { return m_features; }
+    void setFeatures(quint32 features) { m_features = features; }
+
+    // Blocks until every file has been checked, hashing included. The plan
+    // carries the requested versionId, whatever the manifest's own "id" says
+    InstallPlan plan(const QString& versionId, const QJsonObject& versionManifest, const QString& gameDirectory);
+    // Plans on a worker thread and reports through planReady(); plans run
+    // one at a time, in the order they were asked for
+    void planAsync(const QString& versionId, const QJsonObject& versionManifest, const QString& gameDirectory);
+    // Queues the missing files, critical ones first, and reports through
+    // criticalFilesReady() or criticalFilesFailed() once the game could start
+    void submit(const InstallPlan& plan, DownloadManager* downloadManager);
+
+    static QString librariesDirectory(const QString& gameDirectory);
+    static QString assetsDirectory(const QString& gameDirectory);
+
+    static QString assetObjectPath(const QString& assetsDirectory, const QString& hash);
+    static QUrl assetObjectUrl(const QString& hash);
+
+signals:
+    void planReady(const InstallPlan& plan);
+    // Everything the game reads before its title screen is on disk; the
+    // remaining downloads (sounds, music, other languages) are still running
+    void criticalFilesReady(const QString& versionId, qint64 elapsedMs, int remainingDownloads);
+    void criticalFilesFailed(const QString& versionId, const QString& error);
+
+private:
+    void expandClient(const InstallPlan& plan, const QJsonObject& manifest, QList<InstallRequirement>& out) const;
+    void expandLibraries(const InstallPlan& plan, const QJsonObject& manifest, QList<InstallRequirement>& out) const;
+    bool expandAssetIndex(const InstallPlan& plan, const QJsonObject& manifest, QList<InstallRequirement>& out) const;
+    bool needsDownload(const InstallRequirement& requirement, qint64* hashMs, bool* hashed) const;
+
+    VerifyMode m_verifyMode = VerifyChanged;
+    quint32 m_features = 0;
+    QThreadPool m_pool;        // stat/verify batches
+    QThreadPool m_coordinator; // one task per asynchronous plan
+};
\ No newline at end of file
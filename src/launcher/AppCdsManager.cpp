@@ -0,0 +1,317 @@
+#include "AppCdsManager.h"
+#include "LaunchPlanCache.h"
+#include <QStandardPaths>
+#include <QCryptographicHash>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QDateTime>
+#include <QLoggingCategory>
+#include <algorithm>
+
+Q_LOGGING_CATEGORY(appCds, "cryovex.launcher.cds")
+
+QStringList AppCdsManager::Decision::jvmArguments() const
+{
+    switch (mode) {
+    case Dump:
+        return { "-XX:ArchiveClassesAtExit=" + QDir::toNativeSeparators(archivePath) };
+    case Use:
+        return { "-XX:SharedArchiveFile=" + QDir::toNativeSeparators(archivePath) };
+    case Off:
+        break;
+    }
+    return {};
+}
+
+QJsonObject AppCdsManager::Decision::toJson() const
+{
+    QJsonObject object;
+    object["mode"] = mode == Dump ? "dump" : mode == Use ? "use" : "off";
+    if (mode != Off) {
+        object["archive"] = key;
+    }
+    if (baselineMs >= 0) {
+        object["baselineMs"] = baselineMs;
+    }
+    return object;
+}
+
+AppCdsManager& AppCdsManager::instance()
+{
+    static AppCdsManager instance;
+    return instance;
+}
+
+AppCdsManager::AppCdsManager(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void AppCdsManager::initialize()
+{
+    QFile file(QDir(archiveDirectory()).filePath("index.json"));
+    if (!file.exists()) {
+        return;
+    }
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCWarning(appCds) << "Failed to open CDS index:" << file.errorString();
+        return;
+    }
+
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &error);
+    if (error.error != QJsonParseError::NoError) {
+        qCWarning(appCds) << "Failed to parse CDS index:" << error.errorString();
+        return;
+    }
+
+    const QJsonObject archives = doc.object();
+    for (auto it = archives.constBegin(); it != archives.constEnd(); ++it) {
+        const QJsonObject entry = it.value().toObject();
+
+        Archive archive;
+        archive.key = it.key();
+        archive.ready = entry["ready"].toBool();
+        archive.baselineMs = entry["baselineMs"].toInteger(-1);
+        archive.lastUsed = entry["lastUsed"].toInteger();
+        for (const QJsonValue& value : entry["jars"].toArray()) {
+            const QJsonArray jar = value.toArray();
+            archive.jars.append(Jar{jar.at(0).toString(), jar.at(1).toInteger(), jar.at(2).toInteger()});
+        }
+
+        // Archives whose dump never completed are useless
+        if (archive.ready && QFileInfo::exists(archivePath(archive.key))) {
+            m_archives.insert(archive.key, archive);
+        } else {
+            QFile::remove(archivePath(archive.key));
+            m_dirty = true;
+        }
+    }
+
+    qCInfo(appCds) << "Loaded" << m_archives.size() << "CDS archives";
+}
+
+void AppCdsManager::save()
+{
+    if (!m_dirty) {
+        return;
+    }
+
+    QJsonObject archives;
+    for (const Archive& archive : std::as_const(m_archives)) {
+        QJsonArray jars;
+        for (const Jar& jar : archive.jars) {
+            jars.append(QJsonArray{jar.path, jar.size, jar.modified});
+        }
+
+        QJsonObject entry;
+        entry["ready"] = archive.ready;
+        entry["baselineMs"] = archive.baselineMs;
+        entry["lastUsed"] = archive.lastUsed;
+        entry["jars"] = jars;
+        archives.insert(archive.key, entry);
+    }
+
+    QDir().mkpath(archiveDirectory());
+    QFile file(QDir(archiveDirectory()).filePath("index.json"));
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(appCds) << "Failed to save CDS index:" << file.errorString();
+        return;
+    }
+
+    file.write(QJsonDocument(archives).toJson(QJsonDocument::Compact));
+    m_dirty = false;
+}
+
+AppCdsManager::Decision AppCdsManager::prepare(const LaunchPlan& plan, int javaMajor, const QString& javaBuild)
+{
+    Decision decision;
+    if (javaMajor < MIN_JAVA_MAJOR) {
+        return decision;
+    }
+
+    decision.key = archiveKey(plan.classpath(), javaBuild);
+    decision.archivePath = archivePath(decision.key);
+
+    // Another instance is still writing the archive; it only exists once that one exits
+    if (m_dumping.contains(decision.key)) {
+        qCInfo(appCds) << "CDS archive" << decision.key << "is being dumped, launching without it";
+        return decision;
+    }
+
+    auto it = m_archives.find(decision.key);
+    if (it != m_archives.end()) {
+        if (it->ready && jarsUnchanged(it->jars) && QFileInfo::exists(decision.archivePath)) {
+            it->lastUsed = QDateTime::currentMSecsSinceEpoch();
+            m_dirty = true;
+            // The dump run started cold, so one warm run without the archive sets the baseline
+            if (it->baselineMs < 0) {
+                qCInfo(appCds) << "Launching once without CDS archive" << decision.key << "to measure the baseline";
+                return decision;
+            }
+            decision.mode = Use;
+            decision.baselineMs = it->baselineMs;
+            return decision;
+        }
+
+        qCInfo(appCds) << "CDS archive" << decision.key << "is stale, recreating";
+        removeArchive(decision.key);
+    }
+
+    // The JVM refuses to overwrite half-written archives from a crashed dump
+    QDir().mkpath(archiveDirectory());
+    QFile::remove(decision.archivePath);
+
+    Archive archive;
+    archive.key = decision.key;
+    archive.jars = classpathJars(plan.classpath());
+    archive.lastUsed = QDateTime::currentMSecsSinceEpoch();
+    m_archives.insert(archive.key, archive);
+    m_dumping.insert(archive.key);
+    m_dirty = true;
+
+    decision.mode = Dump;
+    return decision;
+}
+
+bool AppCdsManager::recordStartup(const Decision& decision, qint64 startupMs, qint64* savedMs)
+{
+    auto it = m_archives.find(decision.key);
+    if (decision.key.isEmpty() || decision.mode == Dump || it == m_archives.end()) {
+        return false;
+    }
+
+    if (decision.mode == Off) {
+        // Runs that overlapped the dump do not count, it competes for CPU and disk
+        if (it->ready) {
+            it->baselineMs = startupMs;
+            m_dirty = true;
+            qCInfo(appCds) << "Startup without CDS archive" << decision.key << ":" << startupMs << "ms";
+        }
+        return false;
+    }
+
+    if (it->baselineMs < 0) {
+        return false;
+    }
+    const qint64 saved = it->baselineMs - startupMs;
+    qCInfo(appCds) << "Startup with CDS archive:" << startupMs << "ms, without:" << it->baselineMs
+                   << "ms, saved" << saved << "ms";
+    if (savedMs) {
+        *savedMs = saved;
+    }
+    return true;
+}
+
+void AppCdsManager::launchFinished(const Decision& decision, bool normalExit)
+{
+    if (decision.mode != Dump) {
+        return;
+    }
+    m_dumping.remove(decision.key);
+
+    auto it = m_archives.find(decision.key);
+    if (it == m_archives.end()) {
+        return;
+    }
+
+    const QFileInfo archive(decision.archivePath);
+    if (normalExit && archive.exists() && archive.size() > 0) {
+        it->ready = true;
+        m_dirty = true;
+        qCInfo(appCds) << "Created CDS archive" << decision.key << "(" << archive.size() / 1024 << "KB)";
+        evictOldArchives();
+    } else {
+        // Killed or crashed before the archive was written; try again next time
+        removeArchive(decision.key);
+    }
+    save();
+}
+
+void AppCdsManager::archiveRejected(const Decision& decision)
+{
+    if (decision.mode == Off) {
+        return;
+    }
+    qCWarning(appCds) << "JVM rejected CDS archive" << decision.key << ", it will be recreated";
+    removeArchive(decision.key);
+    save();
+}
+
+bool AppCdsManager::isRejectionMessage(const QString& line)
+{
+    // -Xshare:auto only warns and carries on without the archive
+    return line.contains(QLatin1String("[cds]"))
+           && (line.contains(QLatin1String("shared archive file"), Qt::CaseInsensitive)
+               || line.contains(QLatin1String("Unable to use shared archive"), Qt::CaseInsensitive));
+}
+
+QString AppCdsManager::archiveKey(const QString& classpath, const QString& javaBuild)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(classpath.toUtf8());
+    hash.addData("\n");
+    hash.addData(javaBuild.toUtf8());
+    return QString::fromLatin1(hash.result().toHex().left(24));
+}
+
+QList<AppCdsManager::Jar> AppCdsManager::classpathJars(const QString& classpath)
+{
+    QList<Jar> jars;
+    for (const QString& entry : classpath.split(QDir::listSeparator(), Qt::SkipEmptyParts)) {
+        const QFileInfo info(entry);
+        jars.append(Jar{info.absoluteFilePath(), info.size(), info.lastModified().toMSecsSinceEpoch()});
+    }
+    return jars;
+}
+
+bool AppCdsManager::jarsUnchanged(const QList<Jar>& jars)
+{
+    // The JVM validates the same size/mtime pair and silently ignores the archive otherwise
+    for (const Jar& jar : jars) {
+        const QFileInfo info(jar.path);
+        if (!info.exists() || info.size() != jar.size || info.lastModified().toMSecsSinceEpoch() != jar.modified) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void AppCdsManager::removeArchive(const QString& key)
+{
+    QFile::remove(archivePath(key));
+    if (m_archives.remove(key) > 0) {
+        m_dirty = true;
+    }
+}
+
+void AppCdsManager::evictOldArchives()
+{
+    if (m_archives.size() <= MAX_ARCHIVES) {
+        return;
+    }
+
+    QList<Archive> archives = m_archives.values();
+    std::sort(archives.begin(), archives.end(), [](const Archive& a, const Archive& b) {
+        return a.lastUsed < b.lastUsed;
+    });
+    for (int i = 0; i < archives.size() - MAX_ARCHIVES; ++i) {
+        qCInfo(appCds) << "Evicting least recently used CDS archive" << archives.at(i).key;
+        removeArchive(archives.at(i).key);
+    }
+}
+
+QString AppCdsManager::archiveDirectory() const
+{
+    QString appDataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    return QDir(appDataPath).filePath("cache/cds");
+}
+
+QString AppCdsManager::archivePath(const QString& key) const
+{
+    return QDir(archiveDirectory()).filePath(key + ".jsa");
+}
\ No newline at end of file
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QJsonObject>
+#include <QStringList>
+
+struct LaunchPlan;
+
+// Dynamic AppCDS archives for launch plans. The first launch of a classpath
+// on a given Java build records the classes it loaded with
+// -XX:ArchiveClassesAtExit; later launches map that archive with
+// -XX:SharedArchiveFile instead of loading and verifying every class again.
+// Archives live in cache/cds, keyed by classpath and Java build, and are
+// dropped when a jar changes or the JVM refuses them. The launch after a
+// dump runs once more without the archive, warm, to measure what it saves.
+class AppCdsManager : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Mode {
+        Off,
+        Dump,   // no archive yet, create one when the game exits
+        Use     // archive ready
+    };
+    Q_ENUM(Mode)
+
+    struct Decision {
+        Mode mode = Off;
+        QString key;            // also set for Off runs that measure the baseline
+        QString archivePath;
+        qint64 baselineMs = -1; // startup of a warm run without the archive
+
+        QStringList jvmArguments() const;
+        QJsonObject toJson() const;
+    };
+
+    static AppCdsManager& instance();
+
+    void initialize();
+    void save();
+
+    // javaBuild identifies the exact runtime, e.g. version, vendor and binary stamp
+    Decision prepare(const LaunchPlan& plan, int javaMajor, const QString& javaBuild);
+
+    // Startup time of a launch that reached the title screen. For Use
+    // launches with a known baseline, returns true and the time saved;
+    // Off launches of an archived classpath become its baseline.
+    bool recordStartup(const Decision& decision, qint64 startupMs, qint64* savedMs);
+    // After the process exited: a Dump run leaves its archive behind
+    void launchFinished(const Decision& decision, bool normalExit);
+    // The JVM printed that it could not map the archive
+    void archiveRejected(const Decision& decision);
+
+    static bool isRejectionMessage(const QString& line);
+
+private:
+    explicit AppCdsManager(QObject *parent = nullptr);
+    ~AppCdsManager() = default;
+
+    struct Jar {
+        QString path;
+        qint64 size = 0;
+        qint64 modified = 0;
+    };
+
+    struct Archive {
+        QString key;
+        QList<Jar> jars;
+        bool ready = false;
+        qint64 baselineMs = -1;
+        qint64 lastUsed = 0;
+    };
+
+    static QString archiveKey(const QString& classpath, const QString& javaBuild);
+    static QList<Jar> classpathJars(const QString& classpath);
+    static bool jarsUnchanged(const QList<Jar>& jars);
+    void removeArchive(const QString& key);
+    void evictOldArchives();
+    QString archiveDirectory() const;
+    QString archivePath(const QString& key) const;
+
+    static const int MIN_JAVA_MAJOR = 13; // ArchiveClassesAtExit
+    static const int MAX_ARCHIVES = 8;
+
+    QHash<QString, Archive> m_archives;
+    QSet<QString> m_dumping; // keys whose Dump run has not exited yet
+    bool m_dirty = false;
+};
\ No newline at end of file
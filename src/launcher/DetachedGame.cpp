@@ -0,0 +1,234 @@
+#include "DetachedGame.h"
+#include <QCoreApplication>
+#include <QStandardPaths>
+#include <QFileInfo>
+#include <QDir>
+#include <QLoggingCategory>
+
+#ifdef Q_OS_UNIX
+#include <csignal>
+#include <sys/stat.h>
+#endif
+
+Q_LOGGING_CATEGORY(detachedGame, "cryovex.launcher.detached")
+
+namespace {
+
+const char* HELPER_NAME = "cryovex-loghelper";
+
+#ifdef Q_OS_UNIX
+// Changes when the helper rotates the log, which renames the file we have open
+quint64 inodeOf(const QString& path)
+{
+    struct stat info;
+    return ::stat(QFile::encodeName(path).constData(), &info) == 0 ? quint64(info.st_ino) : 0;
+}
+
+// Still the process the state file recorded: a pid reused since has another
+// start time, and EPERM means it belongs to someone else. Without a recorded
+// start time (older state files, no procfs) only the pid can be checked.
+bool isOurProcess(qint64 pid, qint64 startTime)
+{
+    if (pid <= 0 || ::kill(pid_t(pid), 0) != 0) {
+        return false;
+    }
+    return startTime <= 0 || DetachedGameState::processStartTime(pid) == startTime;
+}
+#endif
+
+}
+
+DetachedGame::DetachedGame(const QString& statePath, QObject *parent)
+    : QObject(parent)
+    , m_statePath(statePath)
+{
+    m_pollTimer.setInterval(POLL_INTERVAL_MS);
+    connect(&m_pollTimer, &QTimer::timeout, this, &DetachedGame::poll);
+}
+
+bool DetachedGame::isSupported()
+{
+#ifdef Q_OS_UNIX
+    return QFileInfo(helperPath()).isExecutable();
+#else
+    return false;
+#endif
+}
+
+QString DetachedGame::helperPath()
+{
+    return QDir(QCoreApplication::applicationDirPath()).filePath(HELPER_NAME);
+}
+
+QString DetachedGame::stateDirectory()
+{
+    return QDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)).filePath("instances");
+}
+
+QString DetachedGame::statePathFor(int instanceId)
+{
+    // Instance ids restart with every session, the pid keeps the names apart
+    return QDir(stateDirectory()).filePath(QString("%1-%2.json").arg(QCoreApplication::applicationPid()).arg(instanceId));
+}
+
+bool DetachedGame::start(QProcess* process, const QString& versionId, const QString& logPath,
+                         const QString& cleanupDirectory)
+{
+    QDir().mkpath(stateDirectory());
+    QFile::remove(m_statePath);
+
+    QStringList arguments = {"--state", m_statePath, "--log", logPath, "--version", versionId};
+    if (!cleanupDirectory.isEmpty()) {
+        arguments << "--cleanup" << cleanupDirectory;
+    }
+    arguments << "--" << process->program() << process->arguments();
+
+    // The helper inherits environment, working directory and placement, and passes them on
+    process->setProgram(helperPath());
+    process->setArguments(arguments);
+    process->setStandardOutputFile(QProcess::nullDevice());
+    process->setStandardErrorFile(QProcess::nullDevice());
+
+    qint64 helperPid = 0;
+    if (!process->startDetached(&helperPid)) {
+        qCWarning(detachedGame) << "Failed to start" << helperPath() << ":" << process->errorString();
+        return false;
+    }
+    qCInfo(detachedGame) << "Log helper" << helperPid << "runs" << versionId << ", state in" << m_statePath;
+
+    m_state.versionId = versionId;
+    m_state.logFile = logPath;
+    m_state.helperPid = helperPid;
+    m_state.helperStartTime = DetachedGameState::processStartTime(helperPid);
+    m_state.startedAt = QDateTime::currentDateTimeUtc();
+    m_pollTimer.start();
+    return true;
+}
+
+void DetachedGame::attach(const DetachedGameState& state)
+{
+    m_state = state;
+    m_stateSeen = true;
+
+    // The console only shows a tail anyway
+    m_log.setFileName(state.logFile);
+    if (m_log.open(QIODevice::ReadOnly)) {
+#ifdef Q_OS_UNIX
+        m_logInode = inodeOf(state.logFile);
+#endif
+        m_log.seek(qMax<qint64>(0, m_log.size() - REPLAY_BYTES));
+        if (m_log.pos() > 0) {
+            m_log.readLine(); // resume at a line start
+        }
+    }
+
+    qCInfo(detachedGame) << "Attached to" << state.versionId << ", game pid" << state.gamePid;
+    readLog();
+    m_pollTimer.start();
+    poll();
+}
+
+void DetachedGame::kill()
+{
+#ifdef Q_OS_UNIX
+    // Before the game is spawned there is only the helper to stop
+    const bool spawned = m_state.gamePid > 0;
+    const qint64 pid = spawned ? m_state.gamePid : m_state.helperPid;
+    const qint64 startTime = spawned ? m_state.gameStartTime : m_state.helperStartTime;
+    if (m_ended || !isOurProcess(pid, startTime)) {
+        return;
+    }
+    ::kill(pid_t(pid), SIGKILL);
+#endif
+}
+
+void DetachedGame::poll()
+{
+    if (m_ended) {
+        return;
+    }
+
+    // A few hundred bytes; rewritten atomically by the helper
+    DetachedGameState state;
+    if (DetachedGameState::load(m_statePath, &state)) {
+        m_stateSeen = true;
+        const bool spawned = state.gamePid > 0 && m_state.gamePid == 0;
+        m_state = state;
+        if (spawned) {
+            emit started();
+        }
+    }
+
+    readLog();
+
+    if (m_state.phase == DetachedGameState::Ended) {
+        end(m_state);
+        return;
+    }
+
+#ifdef Q_OS_UNIX
+    // Killed helpers write no final state
+    if (!isOurProcess(m_state.helperPid, m_state.helperStartTime)) {
+        DetachedGameState lost = m_state;
+        lost.phase = DetachedGameState::Ended;
+        lost.crashed = true;
+        lost.exitCode = -1;
+        lost.error = "The log helper exited without recording the game's exit";
+        end(lost);
+    }
+#endif
+}
+
+void DetachedGame::readLog()
+{
+    if (!m_log.isOpen()) {
+        // The helper has opened, and so rotated, the log before its first state write
+        if (!m_stateSeen || !QFileInfo::exists(m_state.logFile)) {
+            return;
+        }
+        m_log.setFileName(m_state.logFile);
+        if (!m_log.open(QIODevice::ReadOnly)) {
+            return;
+        }
+#ifdef Q_OS_UNIX
+        m_logInode = inodeOf(m_state.logFile);
+#endif
+    }
+
+    QByteArray data = m_log.readAll();
+
+#ifdef Q_OS_UNIX
+    // Rotated: finish the renamed file, then continue with the new one
+    const quint64 inode = inodeOf(m_state.logFile);
+    if (inode != 0 && inode != m_logInode) {
+        data += m_log.readAll();
+        m_log.close();
+        m_log.setFileName(m_state.logFile);
+        if (m_log.open(QIODevice::ReadOnly)) {
+            m_logInode = inode;
+            data += m_log.readAll();
+        }
+    }
+#endif
+
+    if (!data.isEmpty()) {
+        emit outputReceived(data);
+    }
+}
+
+void DetachedGame::end(const DetachedGameState& state)
+{
+    m_ended = true;
+    m_pollTimer.stop();
+    m_state = state;
+    m_log.close();
+
+    // Nobody else needs it once the exit is known here
+    QFile::remove(m_statePath);
+
+    if (!state.error.isEmpty()) {
+        qCWarning(detachedGame) << state.versionId << ":" << state.error;
+        emit errorOccurred(state.error);
+    }
+    emit finished(state.exitCode, state.crashed);
+}
\ No newline at end of file
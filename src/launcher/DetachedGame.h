@@ -0,0 +1,59 @@
+#pragma once
+
+#include <QObject>
+#include <QProcess>
+#include <QFile>
+#include <QTimer>
+#include "utils/DetachedGameState.h"
+
+// A game run by the log-capture helper (cryovex-loghelper), which outlives
+// the launcher. Output is read back from the log file and the pid and exit
+// status from the helper's state file, both polled, so a later launcher
+// session can follow a game an earlier one started. Unix only.
+class DetachedGame : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DetachedGame(const QString& statePath, QObject *parent = nullptr);
+
+    // Unix, with the helper installed next to the launcher
+    static bool isSupported();
+    static QString helperPath();
+    static QString stateDirectory();
+    static QString statePathFor(int instanceId);
+
+    // Runs process's program, arguments, environment, working directory and
+    // child modifier under the helper, which removes cleanupDirectory after
+    // the game exits. False if the helper could not be started.
+    bool start(QProcess* process, const QString& versionId, const QString& logPath,
+               const QString& cleanupDirectory);
+    // Follows a game from its state file, replaying the tail of its log
+    void attach(const DetachedGameState& state);
+
+    DetachedGameState state() const { return m_state; }
+    qint64 processId() const { return m_state.gamePid; }
+    void kill();
+
+signals:
+    void started();
+    void outputReceived(const QByteArray& data);
+    void finished(int exitCode, bool crashed);
+    void errorOccurred(const QString& error);
+
+private:
+    void poll();
+    void readLog();
+    void end(const DetachedGameState& state);
+
+    static const int POLL_INTERVAL_MS = 250;
+    static const qint64 REPLAY_BYTES = 256 * 1024;
+
+    const QString m_statePath;
+    DetachedGameState m_state;
+    QTimer m_pollTimer;
+    bool m_stateSeen = false;
+    QFile m_log;
+    quint64 m_logInode = 0;
+    bool m_ended = false;
+};
\ No newline at end of file
@@ -0,0 +1,327 @@
+#include "GameInstance.h"
+#include "ProcessSpawn.h"
+#include "utils/NativesCache.h"
+#include <QCoreApplication>
+#include <QFile>
+#include <QTimer>
+#include <QLoggingCategory>
+
+Q_LOGGING_CATEGORY(gameInstance, "cryovex.launcher.instance")
+
+GameInstance::GameInstance(int id, const QString& versionId, const QString& logFilePath,
+                           LaunchMetrics* metrics, QObject *parent)
+    : QObject(parent)
+    , m_id(id)
+    , m_versionId(versionId)
+    , m_logPath(logFilePath)
+    , m_process(new QProcess(this))
+    , m_metrics(metrics)
+    , m_output(new GameOutputModel(this))
+{
+    m_metrics->setParent(this);
+    m_startedAt = QDateTime::currentDateTimeUtc();
+    m_uptime.start();
+
+    connect(m_process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+            this, &GameInstance::onFinished);
+    connect(m_process, &QProcess::started,
+            this, &GameInstance::onStarted);
+    connect(m_process, &QProcess::errorOccurred,
+            this, &GameInstance::onError);
+    connect(m_process, &QProcess::readyReadStandardOutput,
+            this, &GameInstance::onReadyReadStandardOutput);
+    connect(m_process, &QProcess::readyReadStandardError,
+            this, &GameInstance::onReadyReadStandardError);
+}
+
+GameInstance::~GameInstance()
+{
+    if (m_process->state() != QProcess::NotRunning) {
+        m_process->kill();
+        m_process->waitForFinished(3000);
+    }
+}
+
+qint64 GameInstance::uptimeMs() const
+{
+    return m_finalUptimeMs >= 0 ? m_finalUptimeMs : m_uptimeOffsetMs + m_uptime.elapsed();
+}
+
+void GameInstance::start(const QString& program, const QStringList& arguments,
+                         const QString& workingDirectory, const QProcessEnvironment& environment,
+                         const ProcessPlacement& placement, bool detach)
+{
+    m_process->setProgram(program);
+    m_process->setArguments(arguments);
+    m_process->setWorkingDirectory(workingDirectory);
+    m_process->setProcessEnvironment(environment);
+    ProcessSpawn::configure(m_process);
+
+#ifdef Q_OS_UNIX
+    if (!placement.isDefault()) {
+        m_placement = PreparedPlacement::prepare(placement, QString("%1-%2").arg(QCoreApplication::applicationPid()).arg(m_id));
+        if (!m_placement.isEmpty()) {
+            const PreparedPlacement prepared = m_placement;
+            m_process->setChildProcessModifier([prepared]() {
+                prepared.applyInChild();
+            });
+            m_metrics->setDetail("placement", placement.toJson());
+        }
+    }
+#else
+    Q_UNUSED(placement)
+#endif
+
+    if (detach && !DetachedGame::isSupported()) {
+        qCWarning(gameInstance) << "Log helper not available, instance" << m_id << "stops with the launcher";
+        detach = false;
+    }
+
+    m_metrics->beginPhase(LaunchMetrics::Spawn);
+    if (detach) {
+        // The helper writes the log and removes the natives directory after the game
+        m_detached = new DetachedGame(DetachedGame::statePathFor(m_id), this);
+        connectDetached();
+        const bool started = m_detached->start(m_process, m_versionId, m_logPath, m_nativesDirectory);
+        m_placement.closeDescriptors();
+        if (started) {
+            m_nativesDirectory.clear();
+            m_metrics->setDetail("detached", true);
+        } else {
+            onError(QProcess::FailedToStart);
+        }
+        return;
+    }
+
+    // Raw output goes to disk as it arrives; the console only keeps the tail
+    m_logFile.open(m_logPath);
+
+    m_process->start();
+
+    // The child has its own copy of the cgroup.procs descriptor by now
+    m_placement.closeDescriptors();
+}
+
+void GameInstance::attach(const QString& statePath, const DetachedGameState& state)
+{
+    m_startedAt = state.startedAt;
+    m_uptimeOffsetMs = qMax<qint64>(0, state.startedAt.msecsTo(QDateTime::currentDateTimeUtc()));
+    m_pid = state.gamePid;
+
+    m_detached = new DetachedGame(statePath, this);
+    connectDetached();
+    if (state.phase == DetachedGameState::Ended) {
+        m_finalUptimeMs = qMax<qint64>(0, state.startedAt.msecsTo(state.endedAt));
+        m_exitCode = state.exitCode;
+        m_errorString = state.error;
+        QFile::remove(statePath);
+        setState(state.crashed ? Crashed : Exited);
+        return;
+    }
+
+    // Not yet spawned: started() follows from the state file
+    qCInfo(gameInstance) << "Instance" << m_id << "reattached to" << m_versionId << ", pid" << m_pid;
+    if (m_pid > 0) {
+        setState(Running);
+        // Long past its launch
+        markBooted();
+    }
+    m_detached->attach(state);
+}
+
+void GameInstance::connectDetached()
+{
+    connect(m_detached, &DetachedGame::started, this, &GameInstance::onStarted);
+    connect(m_detached, &DetachedGame::outputReceived, this, [this](const QByteArray& data) {
+        handleOutput(data, m_stdoutParser);
+    });
+    connect(m_detached, &DetachedGame::finished, this, [this](int exitCode, bool crashed) {
+        onFinished(exitCode, crashed ? QProcess::CrashExit : QProcess::NormalExit);
+    });
+    connect(m_detached, &DetachedGame::errorOccurred, this, [this](const QString& error) {
+        m_errorString = error;
+        emit errorOccurred(error);
+    });
+}
+
+void GameInstance::kill()
+{
+    if (m_detached && isActive()) {
+        qCInfo(gameInstance) << "Killing detached instance" << m_id << "(" << m_versionId << ")";
+        m_detached->kill();
+    } else if (m_process->state() != QProcess::NotRunning) {
+        qCInfo(gameInstance) << "Killing instance" << m_id << "(" << m_versionId << ")";
+        m_process->kill();
+    }
+}
+
+void GameInstance::fail(const QString& error)
+{
+    m_errorString = error;
+    releaseLaunchResources(false);
+    m_metrics->finish(false);
+    setState(Failed);
+}
+
+void GameInstance::onStarted()
+{
+    const qint64 pid = m_detached ? m_detached->processId() : m_process->processId();
+    qCInfo(gameInstance) << "Instance" << m_id << "started" << m_versionId << ", pid" << pid;
+
+    // JVM start runs until the game prints its first line
+    m_metrics->endPhase(LaunchMetrics::Spawn);
+    m_metrics->beginPhase(LaunchMetrics::JvmStart);
+
+    m_pid = pid;
+    setState(Running);
+    emit started();
+
+    QTimer::singleShot(BOOT_TIMEOUT_MS, this, &GameInstance::markBooted);
+}
+
+void GameInstance::onFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    qCInfo(gameInstance) << "Instance" << m_id << "finished with exit code:" << exitCode;
+
+    m_exitCode = exitCode;
+    const bool normalExit = exitStatus == QProcess::NormalExit && exitCode == 0;
+    releaseLaunchResources(normalExit);
+
+    // Still open if it exited before the title screen or before a parallel verification passed
+    m_metrics->finish(m_titleScreenReached && !m_verificationFailed);
+
+    setState(normalExit ? Exited : Crashed);
+    emit finished(exitCode);
+}
+
+void GameInstance::onError(QProcess::ProcessError error)
+{
+    qCWarning(gameInstance) << "Instance" << m_id << "process error:" << error;
+
+    if (!m_detached) {
+        m_errorString = m_process->errorString();
+    }
+
+    // finished() is not emitted when the JVM never started
+    if (error == QProcess::FailedToStart) {
+        releaseLaunchResources(false);
+        m_metrics->finish(false);
+        setState(Failed);
+    }
+
+    emit errorOccurred("Process error: " + QString::number(error));
+}
+
+void GameInstance::onReadyReadStandardOutput()
+{
+    handleOutput(m_process->readAllStandardOutput(), m_stdoutParser);
+}
+
+void GameInstance::onReadyReadStandardError()
+{
+    handleOutput(m_process->readAllStandardError(), m_stderrParser);
+}
+
+void GameInstance::handleOutput(const QByteArray& data, GameOutputParser& parser)
+{
+    m_logFile.write(data);
+
+    const QList<GameOutputLine> lines = parser.feed(data);
+    if (m_metrics->isActive() && !m_titleScreenReached) {
+        if (m_metrics->phaseRunning(LaunchMetrics::JvmStart)) {
+            m_metrics->endPhase(LaunchMetrics::JvmStart);
+        }
+        for (const GameOutputLine& line : lines) {
+            if (m_cds.mode != AppCdsManager::Off && AppCdsManager::isRejectionMessage(line.text)) {
+                AppCdsManager::instance().archiveRejected(m_cds);
+                m_cds = AppCdsManager::Decision();
+            }
+            if (m_metrics->scanLine(line.text)) {
+                reachedTitleScreen();
+                break;
+            }
+        }
+    }
+
+    m_output->append(lines);
+
+    m_usage.outputBytes += data.size();
+    m_usage.outputLines += lines.size();
+}
+
+void GameInstance::reachedTitleScreen()
+{
+    m_titleScreenReached = true;
+    const qint64 startupMs = m_metrics->elapsed();
+    qint64 savedMs = 0;
+    if (AppCdsManager::instance().recordStartup(m_cds, startupMs, &savedMs)) {
+        QJsonObject cds = m_cds.toJson();
+        cds["savedMs"] = savedMs;
+        m_metrics->setDetail("cds", cds);
+    }
+    if (!m_verificationPending) {
+        m_metrics->finish(true);
+        markBooted();
+    }
+}
+
+void GameInstance::markBooted()
+{
+    if (m_booted || m_state != Running) {
+        return;
+    }
+    m_booted = true;
+    qCInfo(gameInstance) << "Instance" << m_id << "booted after" << uptimeMs() << "ms";
+    emit booted();
+}
+
+void GameInstance::verificationFinished(const LaunchVerifier::Result& result)
+{
+    m_verificationPending = false;
+    m_metrics->endPhase(LaunchMetrics::Verify);
+    QJsonObject detail = result.toJson();
+    detail["mode"] = "parallel";
+    m_metrics->setDetail("verification", detail);
+
+    if (!result.passed()) {
+        m_verificationFailed = true;
+        m_errorString = QString("%1 game files failed verification").arg(result.failed.size());
+        qCWarning(gameInstance) << "Instance" << m_id << ":" << m_errorString << ", stopping it for repair";
+        kill();
+        emit errorOccurred(m_errorString);
+    } else if (m_titleScreenReached) {
+        m_metrics->finish(true);
+        markBooted();
+    }
+}
+
+void GameInstance::releaseLaunchResources(bool normalExit)
+{
+    NativesCache::removeLaunchDirectory(m_nativesDirectory);
+    m_nativesDirectory.clear();
+    m_placement.removeCgroup();
+
+    m_output->append(m_stdoutParser.finish());
+    m_output->append(m_stderrParser.finish());
+    m_logFile.close();
+
+    AppCdsManager::instance().launchFinished(m_cds, normalExit);
+    m_cds = AppCdsManager::Decision();
+
+    m_finalUptimeMs = m_uptimeOffsetMs + m_uptime.elapsed();
+    emit usageChanged();
+}
+
+void GameInstance::updateUsage(const ProcessSample& sample)
+{
+    m_usage.cpuMs = sample.cpuMs;
+    m_usage.peakRssBytes = qMax(m_usage.peakRssBytes, sample.peakRssBytes);
+}
+
+void GameInstance::setState(State state)
+{
+    if (m_state != state) {
+        m_state = state;
+        emit stateChanged();
+    }
+}
\ No newline at end of file
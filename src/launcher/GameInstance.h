@@ -0,0 +1,143 @@
+#pragma once
+
+#include <QObject>
+#include <QProcess>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include "LaunchMetrics.h"
+#include "GameOutputModel.h"
+#include "GameOutputParser.h"
+#include "AppCdsManager.h"
+#include "ProcessSampler.h"
+#include "ProcessPlacement.h"
+#include "LaunchVerifier.h"
+#include "DetachedGame.h"
+#include "utils/RotatingLogFile.h"
+
+// One copy of the game: its process, console, log file and launch timeline,
+// plus what it has cost so far. Everything is driven by process signals, so
+// an idle instance costs nothing on the GUI thread. Owned by InstanceManager,
+// which also feeds it ProcessSampler readings.
+class GameInstance : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(int instanceId READ instanceId CONSTANT)
+    Q_PROPERTY(QString versionId READ versionId CONSTANT)
+    Q_PROPERTY(State state READ state NOTIFY stateChanged)
+    Q_PROPERTY(GameOutputModel* output READ output CONSTANT)
+    Q_PROPERTY(QString logFilePath READ logFilePath CONSTANT)
+
+public:
+    enum State {
+        Preparing, // resolving the plan, process not started yet
+        Running,
+        Exited,    // exit code 0
+        Crashed,   // non-zero exit or killed
+        Failed     // never started
+    };
+    Q_ENUM(State)
+
+    struct Usage {
+        qint64 outputBytes = 0;
+        qint64 outputLines = 0;
+        qint64 cpuMs = -1;        // user + system time, -1 until sampled
+        qint64 peakRssBytes = -1;
+    };
+
+    GameInstance(int id, const QString& versionId, const QString& logFilePath,
+                 LaunchMetrics* metrics, QObject *parent = nullptr);
+    ~GameInstance();
+
+    int instanceId() const { return m_id; }
+    QString versionId() const { return m_versionId; }
+    State state() const { return m_state; }
+    bool isActive() const { return m_state == Preparing || m_state == Running; }
+    // Running and past its launch: title screen reached and files verified
+    bool isBooted() const { return m_booted; }
+    qint64 processId() const { return m_pid; } // kept after exit
+    QDateTime startedAt() const { return m_startedAt; }
+    qint64 uptimeMs() const;
+    int exitCode() const { return m_exitCode; }
+    QString errorString() const { return m_errorString; }
+    Usage usage() const { return m_usage; }
+    // Latest ProcessSampler reading of this instance's process tree
+    void updateUsage(const ProcessSample& sample);
+
+    LaunchMetrics* metrics() const { return m_metrics; }
+    GameOutputModel* output() const { return m_output; }
+    QString logFilePath() const { return m_logPath; }
+
+    // Per-launch resources, released when the process ends
+    void setNativesDirectory(const QString& directory) { m_nativesDirectory = directory; }
+    void setCdsDecision(const AppCdsManager::Decision& decision) { m_cds = decision; }
+
+    // Files are being verified while the game boots: the launch record waits
+    // for the outcome, and a failed check stops the game
+    void setVerificationPending() { m_verificationPending = true; }
+    void verificationFinished(const LaunchVerifier::Result& result);
+
+    // placement is applied in the child before exec (Unix only). A detached
+    // game runs under the log helper and keeps running if the launcher exits.
+    void start(const QString& program, const QStringList& arguments,
+               const QString& workingDirectory, const QProcessEnvironment& environment,
+               const ProcessPlacement& placement = ProcessPlacement(), bool detach = false);
+    // Follows a game an earlier session started detached
+    void attach(const QString& statePath, const DetachedGameState& state);
+    bool isDetached() const { return m_detached; }
+    void kill();
+    // Abandons a launch that never got as far as starting its process
+    void fail(const QString& error);
+
+signals:
+    void stateChanged();
+    void usageChanged();
+    void started();
+    void booted();
+    void finished(int exitCode);
+    void errorOccurred(const QString& error);
+
+private slots:
+    void onStarted();
+    void onFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void onError(QProcess::ProcessError error);
+    void onReadyReadStandardOutput();
+    void onReadyReadStandardError();
+
+private:
+    void setState(State state);
+    void handleOutput(const QByteArray& data, GameOutputParser& parser);
+    void reachedTitleScreen();
+    void markBooted();
+    void releaseLaunchResources(bool normalExit);
+    void connectDetached();
+
+    const int m_id;
+    const QString m_versionId;
+    const QString m_logPath;
+    QProcess* m_process;
+    DetachedGame* m_detached = nullptr;
+    LaunchMetrics* m_metrics;
+    GameOutputModel* m_output;
+    GameOutputParser m_stdoutParser;
+    GameOutputParser m_stderrParser{true};
+    RotatingLogFile m_logFile;
+    AppCdsManager::Decision m_cds;
+    QString m_nativesDirectory;
+    PreparedPlacement m_placement;
+    bool m_verificationPending = false;
+    bool m_verificationFailed = false;
+    bool m_titleScreenReached = false;
+    bool m_booted = false;
+    State m_state = Preparing;
+    qint64 m_pid = 0;
+    QDateTime m_startedAt;
+    QElapsedTimer m_uptime;
+    qint64 m_finalUptimeMs = -1;
+
+    // Versions whose title screen line is not recognised count as booted after this
+    static constexpr int BOOT_TIMEOUT_MS = 120000;
+    qint64 m_uptimeOffsetMs = 0; // attached: time before this session
+    int m_exitCode = 0;
+    QString m_errorString;
+    Usage m_usage;
+};
\ No newline at end of file
@@ -1,115 +1,461 @@
 #include "GameLauncher.h"
 #include "JvmArgumentBuilder.h"
+#include "JavaRuntimeDiscovery.h"
+#include "ProcessSpawn.h"
+#include "utils/CompiledManifest.h"
 #include <QLoggingCategory>
-#include <QTimer>
+#include <QDir>
+#include <QFileInfo>
 
 Q_LOGGING_CATEGORY(gameLauncher, "cryovex.launcher.game")
 
 GameLauncher::GameLauncher(QObject *parent)
     : QObject(parent)
-    , m_gameProcess(new QProcess(this))
     , m_argumentBuilder(new JvmArgumentBuilder(this))
+    , m_instances(new InstanceManager(this))
+    , m_metrics(new LaunchMetrics(this))
+    , m_warmer(new PageCacheWarmer(this))
+    , m_verifier(new LaunchVerifier(this))
+    , m_idleOutput(new GameOutputModel(this))
 {
-    connect(m_gameProcess, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
-            this, &GameLauncher::onGameFinished);
-    connect(m_gameProcess, &QProcess::errorOccurred,
-            this, &GameLauncher::onGameError);
-    connect(m_gameProcess, &QProcess::readyReadStandardOutput,
-            this, &GameLauncher::onGameReadyReadStandardOutput);
-    connect(m_gameProcess, &QProcess::readyReadStandardError,
-            this, &GameLauncher::onGameReadyReadStandardError);
+    m_warmupPool.setMaxThreadCount(1);
+    connect(m_warmer, &PageCacheWarmer::runningChanged,
+            this, &GameLauncher::warmingChanged);
+    connect(m_instances, &InstanceManager::runningCountChanged,
+            this, &GameLauncher::runningStatusChanged);
 }
 
 GameLauncher::~GameLauncher()
 {
-    if (m_gameProcess && m_gameProcess->state() != QProcess::NotRunning) {
-        m_gameProcess->kill();
-        m_gameProcess->waitForFinished(3000);
-    }
+    m_warmupPool.waitForDone();
+    m_nativesPool.waitForDone();
+    m_instances->killAttached();
+}
+
+QString GameLauncher::currentVersion() const
+{
+    return m_current && m_current->isActive() ? m_current->versionId() : QString();
+}
+
+QVariantList GameLauncher::launchTimeline() const
+{
+    return m_current ? m_current->metrics()->timeline() : m_metrics->timeline();
 }
 
 void GameLauncher::launchGame(const QString& versionId, const QJsonObject& versionManifest,
                              const QString& username, const QString& uuid, 
                              const QString& accessToken)
 {
-    qCInfo(gameLauncher) << "Launching game version:" << versionId << "for user:" << username << "(stub)";
+    qCInfo(gameLauncher) << "Launching game version:" << versionId << "for user:" << username;
     
-    Q_UNUSED(versionManifest)
-    Q_UNUSED(uuid)
-    Q_UNUSED(accessToken)
+    if (!m_instances->canStart()) {
+        emit launchError(m_instances->maxInstances() == 1
+                         ? QString("The game is already running")
+                         : QString("Instance limit reached (%1 running)").arg(m_instances->runningCount()));
+        return;
+    }
+    
+    // The metrics gathered ahead of the click go with the new instance
+    LaunchMetrics* metrics = m_metrics;
+    m_metrics = new LaunchMetrics(this);
+    GameInstance* instance = m_instances->create(versionId, metrics);
+    connect(metrics, &LaunchMetrics::launchRecorded, this, [this](const QJsonObject& record) {
+        m_lastLaunchMs = record["totalMs"].toInteger();
+        emit launchRecorded(record);
+    });
+    connect(instance, &GameInstance::started, this, &GameLauncher::gameStarted);
+    connect(instance, &GameInstance::finished, this, &GameLauncher::gameFinished);
+    connect(instance, &GameInstance::errorOccurred, this, &GameLauncher::gameError);
+    setCurrentInstance(instance);
     
+    metrics->begin(versionId);
+    
+    metrics->beginPhase(LaunchMetrics::Validate);
     if (!validateLaunchParameters(versionId, versionManifest, username, uuid, accessToken)) {
-        emit launchError("Invalid launch parameters");
+        failLaunch(instance, "Invalid launch parameters");
+        return;
+    }
+    
+    QString javaExecutable;
+    const QString javaIdentity = resolveJava(versionId, versionManifest, &javaExecutable);
+    if (javaIdentity.isEmpty()) {
+        failLaunch(instance, "Java runtime not found: " + javaExecutable);
         return;
     }
+    metrics->endPhase(LaunchMetrics::Validate);
+    
+    // A warmup of another version would only compete with this launch for the
+    // disk; one still being planned would start too late to help
+    ++m_warmupGeneration;
+    const PageCacheWarmer::Result warmup = m_warmer->lastResult();
+    if (m_warmer->isRunning() && warmup.versionId != versionId) {
+        cancelWarmup();
+    }
+    if (warmup.versionId == versionId) {
+        metrics->setDetail("pageCache", warmup.toJson());
+    }
+    
+    // A cached plan skips all manifest processing; the lookup stat-checks its files
+    LaunchPlanCache& cache = LaunchPlanCache::instance();
+    metrics->beginPhase(LaunchMetrics::Plan);
+    const QString key = LaunchPlanCache::planKey(CompiledManifest::cacheKey(versionManifest), m_settings, javaIdentity);
+    LaunchContext context;
+    if (cache.lookup(key, &context.plan)) {
+        qCInfo(gameLauncher) << "Using cached launch plan for" << versionId;
+    } else {
+        context.plan = m_argumentBuilder->buildLaunchPlan(versionManifest, m_settings, javaExecutable,
+                                                          JavaRuntimeDiscovery::instance().runtime(javaExecutable));
+        context.plan.key = key;
+        cache.insert(context.plan);
+        cache.save();
+    }
+    metrics->endPhase(LaunchMetrics::Plan);
+    metrics->setDetail("jvm", context.plan.tuning);
+    
+    context.mainClass = versionManifest["mainClass"].toString();
+    context.username = username;
+    context.uuid = uuid;
+    context.accessToken = accessToken;
+    context.javaIdentity = javaIdentity;
+    
+    // Sounds and music still downloading are checked by the installer instead
+    context.streamingAssets = versionId == m_streamingVersion;
+    if (context.streamingAssets) {
+        metrics->setDetail("streamingAssets", true);
+    }
     
-    // Stub implementation - just simulate a successful launch
-    setRunning(true);
-    setCurrentVersion(versionId);
-    emit gameStarted();
+    // Hash check of the classpath: up front, or alongside the JVM boot for a
+    // plan whose files all passed before and have not changed since
+    context.verifyInParallel = m_settings.verification == LaunchSettings::VerifyParallel
+                               && LaunchVerifier::isTrusted(context.plan);
+    if (m_settings.verification == LaunchSettings::VerifyStat || context.verifyInParallel) {
+        startLaunch(instance, context);
+        return;
+    }
     
-    // Simulate the game running for a short time
-    QTimer::singleShot(5000, this, [this]() {
-        setRunning(false);
-        setCurrentVersion(QString());
-        emit gameFinished(0);
+    // The up-front check hashes on the verifier's pool; the launch resumes
+    // once it reports back
+    metrics->beginPhase(LaunchMetrics::Verify);
+    const int ticket = m_verifier->verifyAsync(context.plan, !context.streamingAssets);
+    auto* verification = new QObject(instance);
+    connect(m_verifier, &LaunchVerifier::finished, verification,
+            [this, instance, verification, ticket, context](int finishedTicket, const LaunchVerifier::Result& result) {
+        if (finishedTicket != ticket) {
+            return;
+        }
+        verification->deleteLater();
+        
+        LaunchMetrics* metrics = instance->metrics();
+        metrics->endPhase(LaunchMetrics::Verify);
+        QJsonObject detail = result.toJson();
+        detail["mode"] = "before";
+        metrics->setDetail("verification", detail);
+        if (!result.passed()) {
+            LaunchPlanCache::instance().invalidate(context.plan.key);
+            emit repairRequired(instance->versionId());
+            failLaunch(instance, QString("%1 game files failed verification").arg(result.failed.size()));
+            return;
+        }
+        startLaunch(instance, context);
     });
 }
 
-void GameLauncher::killGame()
+void GameLauncher::startLaunch(GameInstance* instance, const LaunchContext& context)
 {
-    qCInfo(gameLauncher) << "Killing game process";
+    // Fresh natives directory of links into the shared store, one per instance.
+    // A jar the installer has not extracted yet is unpacked first, so this
+    // runs off the GUI thread.
+    instance->metrics()->beginPhase(LaunchMetrics::Natives);
+    const QString nativesDirectory = JvmArgumentBuilder::getNativesDirectory(m_settings.gameDirectory, context.plan.versionId)
+                                     + "-" + QString::number(instance->instanceId());
+    const QPointer<GameInstance> guard(instance);
+    m_nativesPool.start([this, guard, context, nativesDirectory]() {
+        const bool prepared = NativesCache::instance().prepareLaunchDirectory(nativesDirectory, context.plan.natives);
+        if (!prepared) {
+            NativesCache::removeLaunchDirectory(nativesDirectory);
+        }
+        QMetaObject::invokeMethod(this, [this, guard, context, nativesDirectory, prepared]() {
+            if (!guard) {
+                NativesCache::removeLaunchDirectory(nativesDirectory);
+                return;
+            }
+            if (!prepared) {
+                failLaunch(guard, "Failed to prepare natives for " + guard->versionId());
+                return;
+            }
+            guard->setNativesDirectory(nativesDirectory);
+            guard->metrics()->endPhase(LaunchMetrics::Natives);
+            spawnGame(guard, context, nativesDirectory);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void GameLauncher::spawnGame(GameInstance* instance, const LaunchContext& context, const QString& nativesDirectory)
+{
+    LaunchMetrics* metrics = instance->metrics();
+    const LaunchPlan& plan = context.plan;
+    const QString versionId = instance->versionId();
+    const QString key = plan.key;
+    const bool streamingAssets = context.streamingAssets;
+    
+    metrics->beginPhase(LaunchMetrics::ArgvBuild);
+    ArgumentTemplate::Variables variables = plan.variables;
+    variables[ArgumentTemplate::NativesDirectory] = QDir::toNativeSeparators(nativesDirectory);
+    variables[ArgumentTemplate::AuthPlayerName] = context.username;
+    variables[ArgumentTemplate::AuthUuid] = context.uuid;
+    variables[ArgumentTemplate::AuthAccessToken] = context.accessToken;
+    variables[ArgumentTemplate::AuthSession] = QString("token:%1:%2").arg(context.accessToken, context.uuid);
+    
+    const QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+    
+    QDir().mkpath(plan.workingDirectory);
+    QStringList arguments = ArgumentTemplate::expand(plan.templates, variables);
+    
+    // Class data sharing: record the loaded classes once, map them on later launches
+    AppCdsManager::Decision cds;
+    if (m_settings.appCds) {
+        cds = AppCdsManager::instance().prepare(plan, plan.tuning["javaMajor"].toInt(), context.javaIdentity);
+        arguments = cds.jvmArguments() + arguments;
+    }
+    instance->setCdsDecision(cds);
+    metrics->setDetail("cds", cds.toJson());
+    
+    // Modded classpaths run to tens of KB; Java 9+ reads them from a file,
+    // which goes away with the natives directory
+    if (plan.tuning["javaMajor"].toInt() >= 9) {
+        const int mainClassIndex = arguments.indexOf(context.mainClass);
+        const int before = arguments.size();
+        arguments = ProcessSpawn::withArgumentFile(arguments, mainClassIndex, QDir(nativesDirectory).filePath("cryovex-launch.args"));
+        metrics->setDetail("argumentFile", arguments.size() != before);
+    }
+    metrics->endPhase(LaunchMetrics::ArgvBuild);
     
-    if (m_gameProcess && m_gameProcess->state() != QProcess::NotRunning) {
-        m_gameProcess->kill();
+    if (m_settings.placement.memoryLimitMB > 0 && m_settings.placement.memoryLimitMB < m_settings.memoryMB) {
+        qCWarning(gameLauncher) << "Memory limit of" << m_settings.placement.memoryLimitMB
+                                << "MB is below the heap size, the game may be OOM-killed";
+    }
+    instance->start(plan.javaExecutable, arguments, plan.workingDirectory, environment, m_settings.placement, m_settings.detach);
+    
+    if (context.verifyInParallel && instance->isActive()) {
+        metrics->beginPhase(LaunchMetrics::Verify);
+        instance->setVerificationPending();
+        const int ticket = m_verifier->verifyAsync(plan, !streamingAssets);
+        connect(m_verifier, &LaunchVerifier::finished, instance,
+                [this, instance, ticket, key, versionId](int finishedTicket, const LaunchVerifier::Result& result) {
+            if (finishedTicket != ticket) {
+                return;
+            }
+            if (!result.passed()) {
+                LaunchPlanCache::instance().invalidate(key);
+                emit repairRequired(versionId);
+            }
+            instance->verificationFinished(result);
+        });
+        // Nothing left to protect once the game is gone
+        connect(instance, &GameInstance::stateChanged, m_verifier, [this, instance, ticket]() {
+            if (!instance->isActive()) {
+                m_verifier->cancel(ticket);
+            }
+        });
     }
 }
 
-void GameLauncher::onGameFinished(int exitCode, QProcess::ExitStatus exitStatus)
+void GameLauncher::installAndLaunch(const QString& versionId, const QJsonObject& versionManifest,
+                                   const QString& username, const QString& uuid,
+                                   const QString& accessToken)
 {
-    qCInfo(gameLauncher) << "Game finished with exit code:" << exitCode;
-    Q_UNUSED(exitStatus)
+    if (m_pendingLaunch.versionId == versionId) {
+        return;
+    }
+    // Nothing to plan from: the version JSON is not on disk
+    if (versionManifest.isEmpty()) {
+        qCWarning(gameLauncher) << "No manifest for" << versionId;
+        emit launchError("Version " + versionId + " is not installed");
+        return;
+    }
+    if (!m_pendingLaunch.versionId.isEmpty()) {
+        qCInfo(gameLauncher) << "Dropping pending launch of" << m_pendingLaunch.versionId;
+    }
     
-    setRunning(false);
-    setCurrentVersion(QString());
-    emit gameFinished(exitCode);
+    qCInfo(gameLauncher) << "Installing" << versionId << "before launch";
+    m_pendingLaunch = PendingLaunch{versionId, versionManifest, username, uuid, accessToken};
+    emit installRequired(versionId, versionManifest);
 }
 
-void GameLauncher::onGameError(QProcess::ProcessError error)
+void GameLauncher::installAndLaunch(const QString& versionId, const QJsonObject& versionManifest)
 {
-    qCWarning(gameLauncher) << "Game process error:" << error;
+    if (!m_credentials) {
+        qCWarning(gameLauncher) << "No credentials provider installed";
+        emit launchError("Not signed in");
+        return;
+    }
+    const Credentials credentials = m_credentials();
+    installAndLaunch(versionId, versionManifest, credentials.username, credentials.uuid, credentials.accessToken);
+}
+
+void GameLauncher::installReady(const QString& versionId, qint64 downloadMs, int remainingDownloads)
+{
+    if (m_pendingLaunch.versionId != versionId) {
+        return;
+    }
+    const PendingLaunch pending = m_pendingLaunch;
+    m_pendingLaunch = PendingLaunch();
     
-    setRunning(false);
-    setCurrentVersion(QString());
-    emit gameError("Process error: " + QString::number(error));
+    if (remainingDownloads > 0) {
+        qCInfo(gameLauncher) << "Launching" << versionId << "with" << remainingDownloads << "downloads still running";
+        m_streamingVersion = versionId;
+    }
+    recordPrelaunchPhase(LaunchMetrics::Download, downloadMs);
+    launchGame(pending.versionId, pending.versionManifest, pending.username, pending.uuid, pending.accessToken);
 }
 
-void GameLauncher::onGameReadyReadStandardOutput()
+void GameLauncher::installFailed(const QString& versionId, const QString& error)
 {
-    QByteArray data = m_gameProcess->readAllStandardOutput();
-    emit gameOutput(QString::fromUtf8(data));
+    if (m_pendingLaunch.versionId != versionId) {
+        return;
+    }
+    m_pendingLaunch = PendingLaunch();
+    emit launchError(error);
 }
 
-void GameLauncher::onGameReadyReadStandardError()
+void GameLauncher::assetsStreamed()
 {
-    QByteArray data = m_gameProcess->readAllStandardError();
-    emit gameError(QString::fromUtf8(data));
+    m_streamingVersion.clear();
 }
 
-void GameLauncher::setRunning(bool running)
+void GameLauncher::warmVersion(const QString& versionId, const QJsonObject& versionManifest)
 {
-    if (m_isRunning != running) {
-        m_isRunning = running;
-        emit runningStatusChanged();
+    cancelWarmup();
+    
+    // A running game has already faulted in what it needs
+    if (versionManifest.isEmpty() || !PageCacheWarmer::isSupported() || isRunning()) {
+        return;
+    }
+    
+    QString javaExecutable;
+    const QString javaIdentity = resolveJava(versionId, versionManifest, &javaExecutable);
+    if (javaIdentity.isEmpty()) {
+        return;
     }
+    
+    // Resolving the plan here also leaves it cached for the launch. The lookup
+    // stats every file and a build may probe Java, so both run on a worker.
+    const QString key = LaunchPlanCache::planKey(CompiledManifest::cacheKey(versionManifest), m_settings, javaIdentity);
+    const JavaRuntime runtime = JavaRuntimeDiscovery::instance().runtime(javaExecutable);
+    const LaunchSettings settings = m_settings;
+    const int generation = m_warmupGeneration;
+    m_warmupPool.start([this, versionId, versionManifest, settings, javaExecutable, runtime, key, generation]() {
+        LaunchPlanCache& cache = LaunchPlanCache::instance();
+        LaunchPlan plan;
+        if (!cache.lookup(key, &plan)) {
+            plan = m_argumentBuilder->buildLaunchPlan(versionManifest, settings, javaExecutable, runtime);
+            plan.key = key;
+            cache.insert(plan);
+            cache.save();
+        }
+        
+        QStringList files = plan.classpath().split(QDir::listSeparator(), Qt::SkipEmptyParts);
+        for (const NativeJar& jar : plan.natives) {
+            files += NativesCache::instance().extractedFiles(jar.sha1);
+        }
+        
+        // The JVM itself: libjvm, the default CDS archive and the module image
+        QDir javaHome = QFileInfo(plan.javaExecutable).dir();
+        javaHome.cdUp();
+        files << javaHome.filePath("lib/server/libjvm.so")
+              << javaHome.filePath("lib/server/classes.jsa")
+              << javaHome.filePath("lib/modules");
+        
+        const QString assetIndexPath = plan.assetIndexPath();
+        QMetaObject::invokeMethod(this, [this, versionId, files, assetIndexPath, generation]() {
+            // Another version was selected, or a game started, in the meantime
+            if (generation != m_warmupGeneration || isRunning()) {
+                return;
+            }
+            m_warmer->warm(versionId, files, assetIndexPath);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void GameLauncher::cancelWarmup()
+{
+    ++m_warmupGeneration;
+    m_warmer->cancel();
 }
 
-void GameLauncher::setCurrentVersion(const QString& version)
+QString GameLauncher::resolveJava(const QString& versionId, const QJsonObject& versionManifest, QString* executable) const
 {
-    if (m_currentVersion != version) {
-        m_currentVersion = version;
-        emit currentVersionChanged();
+    // Without an explicit path, use the discovered runtime that fits this version
+    QString javaPath = m_settings.javaPath;
+    if (JavaRuntimeDiscovery::isAutomatic(javaPath)) {
+        const int requiredMajor = CompiledManifest::get(versionManifest)->javaMajorVersion;
+        const JavaRuntime runtime = JavaRuntimeDiscovery::instance().bestFor(requiredMajor);
+        if (runtime.isValid()) {
+            qCInfo(gameLauncher) << "Using Java" << runtime.version << "for" << versionId << "from" << runtime.path;
+            javaPath = runtime.path;
+        }
     }
+    
+    const QString identity = LaunchPlanCache::javaIdentity(javaPath, executable);
+    if (identity.isEmpty()) {
+        *executable = javaPath;
+    }
+    return identity;
+}
+
+void GameLauncher::setLaunchSettings(const LaunchSettings& settings)
+{
+    m_settings = settings;
+}
+
+void GameLauncher::recordPrelaunchPhase(LaunchMetrics::Phase phase, qint64 milliseconds)
+{
+    m_metrics->recordPhase(phase, milliseconds);
+}
+
+void GameLauncher::killGame()
+{
+    qCInfo(gameLauncher) << "Killing game process";
+    
+    if (m_current) {
+        m_current->kill();
+    }
+}
+
+void GameLauncher::showInstance(int instanceId)
+{
+    if (GameInstance* instance = m_instances->instance(instanceId)) {
+        setCurrentInstance(instance);
+    }
+}
+
+void GameLauncher::setCurrentInstance(GameInstance* instance)
+{
+    for (const QMetaObject::Connection& connection : std::as_const(m_currentConnections)) {
+        disconnect(connection);
+    }
+    m_currentConnections.clear();
+    
+    m_current = instance;
+    if (instance) {
+        m_currentConnections << connect(instance->metrics(), &LaunchMetrics::timelineChanged,
+                                        this, &GameLauncher::launchTimelineChanged)
+                             << connect(instance, &GameInstance::stateChanged,
+                                        this, &GameLauncher::currentVersionChanged)
+                             << connect(instance, &QObject::destroyed, this, [this]() {
+                                    setCurrentInstance(nullptr);
+                                });
+    }
+    
+    emit currentInstanceChanged();
+    emit currentVersionChanged();
+    emit launchTimelineChanged();
+}
+
+void GameLauncher::failLaunch(GameInstance* instance, const QString& error)
+{
+    instance->fail(error);
+    emit launchError(error);
 }
 
 bool GameLauncher::validateLaunchParameters(const QString& versionId, const QJsonObject& versionManifest,
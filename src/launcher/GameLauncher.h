@@ -1,54 +1,154 @@
 #pragma once
 
 #include <QObject>
-#include <QProcess>
+#include <QPointer>
 #include <QJsonObject>
 #include <QStringList>
+#include <QThreadPool>
+#include <functional>
+#include "LaunchPlanCache.h"
+#include "LaunchMetrics.h"
+#include "GameOutputModel.h"
+#include "InstanceManager.h"
+#include "PageCacheWarmer.h"
+#include "LaunchVerifier.h"
 
 class JvmArgumentBuilder;
 
+// Resolves launch plans and starts them as instances. The single-game
+// properties follow the most recently launched instance.
 class GameLauncher : public QObject
 {
     Q_OBJECT
     Q_PROPERTY(bool isRunning READ isRunning NOTIFY runningStatusChanged)
     Q_PROPERTY(QString currentVersion READ currentVersion NOTIFY currentVersionChanged)
+    Q_PROPERTY(QVariantList launchTimeline READ launchTimeline NOTIFY launchTimelineChanged)
+    Q_PROPERTY(qint64 lastLaunchMs READ lastLaunchMs NOTIFY launchRecorded)
+    Q_PROPERTY(GameOutputModel* output READ output NOTIFY currentInstanceChanged)
+    Q_PROPERTY(QString logFilePath READ logFilePath NOTIFY currentInstanceChanged)
+    Q_PROPERTY(InstanceManager* instances READ instances CONSTANT)
+    Q_PROPERTY(bool isWarming READ isWarming NOTIFY warmingChanged)
 
 public:
+    struct Credentials {
+        QString username;
+        QString uuid;
+        QString accessToken;
+    };
+    // Supplies the signed-in account; installed by the application, as the
+    // launcher does not depend on the auth module
+    using CredentialsProvider = std::function<Credentials()>;
+    
     explicit GameLauncher(QObject *parent = nullptr);
     ~GameLauncher();
     
-    bool isRunning() const { return m_isRunning; }
-    QString currentVersion() const { return m_currentVersion; }
+    bool isRunning() const { return m_instances->runningCount() > 0; }
+    QString currentVersion() const;
+    QVariantList launchTimeline() const;
+    qint64 lastLaunchMs() const { return m_lastLaunchMs; }
+    GameOutputModel* output() const { return m_current ? m_current->output() : m_idleOutput; }
+    QString logFilePath() const { return m_current ? m_current->logFilePath() : QString(); }
+    InstanceManager* instances() const { return m_instances; }
+    bool isWarming() const { return m_warmer->isRunning(); }
     
     Q_INVOKABLE void launchGame(const QString& versionId, const QJsonObject& versionManifest,
                                const QString& username, const QString& uuid, 
                                const QString& accessToken);
+    // Has the installer fetch what the version is missing first and launches
+    // as soon as the files read before the title screen are in
+    Q_INVOKABLE void installAndLaunch(const QString& versionId, const QJsonObject& versionManifest,
+                                     const QString& username, const QString& uuid,
+                                     const QString& accessToken);
+    // As above for the signed-in account, so the token never passes through QML
+    Q_INVOKABLE void installAndLaunch(const QString& versionId, const QJsonObject& versionManifest);
+    // Kills the current instance; InstanceManager can kill the others
     Q_INVOKABLE void killGame();
+    // Points output, logFilePath and the timeline at another instance
+    Q_INVOKABLE void showInstance(int instanceId);
+    
+    // Reads the selected version's jars, natives and startup assets into the
+    // page cache ahead of the click on Play. The plan is resolved on a worker;
+    // nothing is reported to the user, as nobody asked for it.
+    Q_INVOKABLE void warmVersion(const QString& versionId, const QJsonObject& versionManifest);
+    Q_INVOKABLE void cancelWarmup();
+    
+    void setCredentialsProvider(const CredentialsProvider& provider) { m_credentials = provider; }
+    
+    LaunchSettings launchSettings() const { return m_settings; }
+    void setLaunchSettings(const LaunchSettings& settings);
+    
+    // Verify/download time spent by the installer ahead of the next launch
+    void recordPrelaunchPhase(LaunchMetrics::Phase phase, qint64 milliseconds);
+    
+    // Installer answers to installRequired(). With remainingDownloads the
+    // game starts while those are still streaming in, until assetsStreamed().
+    void installReady(const QString& versionId, qint64 downloadMs, int remainingDownloads);
+    void installFailed(const QString& versionId, const QString& error);
+    void assetsStreamed();
 
 signals:
     void runningStatusChanged();
     void currentVersionChanged();
+    void currentInstanceChanged();
     void gameStarted();
     void gameFinished(int exitCode);
-    void gameOutput(const QString& output);
     void gameError(const QString& error);
     void launchError(const QString& error);
-
-private slots:
-    void onGameFinished(int exitCode, QProcess::ExitStatus exitStatus);
-    void onGameError(QProcess::ProcessError error);
-    void onGameReadyReadStandardOutput();
-    void onGameReadyReadStandardError();
+    void launchTimelineChanged();
+    void launchRecorded(const QJsonObject& record);
+    void warmingChanged();
+    // Files of the version failed verification and need to be downloaded again
+    void repairRequired(const QString& versionId);
+    // installAndLaunch() waits for these files
+    void installRequired(const QString& versionId, const QJsonObject& versionManifest);
 
 private:
-    void setRunning(bool running);
-    void setCurrentVersion(const QString& version);
+    struct PendingLaunch {
+        QString versionId;
+        QJsonObject versionManifest;
+        QString username;
+        QString uuid;
+        QString accessToken;
+    };
+    
+    // A resolved plan and the credentials, carried past the up-front verification
+    struct LaunchContext {
+        LaunchPlan plan;
+        QString mainClass;
+        QString username;
+        QString uuid;
+        QString accessToken;
+        QString javaIdentity;
+        bool streamingAssets = false;
+        bool verifyInParallel = false;
+    };
+    
+    // Second half of launchGame(): natives on m_nativesPool, then spawnGame()
+    void startLaunch(GameInstance* instance, const LaunchContext& context);
+    // Argv and the process itself
+    void spawnGame(GameInstance* instance, const LaunchContext& context, const QString& nativesDirectory);
+    void setCurrentInstance(GameInstance* instance);
+    void failLaunch(GameInstance* instance, const QString& error);
+    // Java for a version, as LaunchPlanCache::javaIdentity(); on failure executable is the path tried
+    QString resolveJava(const QString& versionId, const QJsonObject& versionManifest, QString* executable) const;
     bool validateLaunchParameters(const QString& versionId, const QJsonObject& versionManifest,
                                  const QString& username, const QString& uuid, 
                                  const QString& accessToken);
     
-    QProcess* m_gameProcess;
     JvmArgumentBuilder* m_argumentBuilder;
-    bool m_isRunning = false;
-    QString m_currentVersion;
+    InstanceManager* m_instances;
+    LaunchMetrics* m_metrics;           // the next launch; collects pre-launch phases
+    PageCacheWarmer* m_warmer;
+    LaunchVerifier* m_verifier;
+    GameOutputModel* m_idleOutput;      // shown before the first launch
+    QPointer<GameInstance> m_current;
+    QList<QMetaObject::Connection> m_currentConnections;
+    LaunchSettings m_settings;
+    CredentialsProvider m_credentials;
+    PendingLaunch m_pendingLaunch;      // waiting for the installer
+    QString m_streamingVersion;         // assets still downloading
+    QThreadPool m_nativesPool;          // launch directories, extracting jars if needed
+    QThreadPool m_warmupPool;           // plans for warmVersion(), one at a time
+    int m_warmupGeneration = 0;         // bumped by cancelWarmup() to drop stale plans
+    qint64 m_lastLaunchMs = 0;
 };
\ No newline at end of file
@@ -0,0 +1,150 @@
+#include "GameOutputModel.h"
+
+GameOutputModel::GameOutputModel(QObject *parent)
+    : QAbstractListModel(parent)
+    , m_flushTimer(new QTimer(this))
+{
+    // Armed only while lines are pending, so an idle console costs no wakeups
+    m_flushTimer->setSingleShot(true);
+    m_flushTimer->setInterval(FRAME_INTERVAL_MS);
+    connect(m_flushTimer, &QTimer::timeout, this, &GameOutputModel::flushPending);
+}
+
+int GameOutputModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+    return m_count;
+}
+
+QVariant GameOutputModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_count) {
+        return QVariant();
+    }
+
+    const GameOutputLine& line = lineAt(index.row());
+    switch (role) {
+    case Qt::DisplayRole:
+    case TextRole:
+        return line.text;
+    case LevelRole:
+        return GameOutputLine::levelName(line.level);
+    case ThreadRole:
+        return line.thread;
+    case LoggerRole:
+        return line.logger;
+    case TimestampRole:
+        return line.timestamp;
+    case IsErrorRole:
+        return line.isError;
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> GameOutputModel::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[TextRole] = "text";
+    roles[LevelRole] = "level";
+    roles[ThreadRole] = "thread";
+    roles[LoggerRole] = "logger";
+    roles[TimestampRole] = "timestamp";
+    roles[IsErrorRole] = "isError";
+    return roles;
+}
+
+void GameOutputModel::setCapacity(int capacity)
+{
+    capacity = qMax(1, capacity);
+    if (m_capacity == capacity) {
+        return;
+    }
+
+    clear();
+    m_capacity = capacity;
+    m_ring.squeeze();
+    emit capacityChanged();
+}
+
+void GameOutputModel::append(const QList<GameOutputLine>& lines)
+{
+    if (lines.isEmpty()) {
+        return;
+    }
+
+    m_pending.append(lines);
+
+    // Nothing older than a full ring can ever be shown
+    if (m_pending.size() > m_capacity) {
+        const qsizetype excess = m_pending.size() - m_capacity;
+        m_pending.remove(0, excess);
+        m_dropped += excess;
+    }
+
+    if (!m_flushTimer->isActive()) {
+        m_flushTimer->start();
+    }
+}
+
+void GameOutputModel::clear()
+{
+    m_flushTimer->stop();
+    m_pending.clear();
+
+    beginResetModel();
+    m_ring.clear();
+    m_head = 0;
+    m_count = 0;
+    m_dropped = 0;
+    endResetModel();
+    emit countChanged();
+}
+
+void GameOutputModel::flushPending()
+{
+    if (m_pending.isEmpty()) {
+        return;
+    }
+
+    const QList<GameOutputLine> lines = std::move(m_pending);
+    m_pending.clear();
+    const int incoming = int(lines.size());
+
+    // Make room first so views see one removal and one insertion per frame
+    const int overflow = m_count + incoming - m_capacity;
+    if (overflow > 0) {
+        beginRemoveRows(QModelIndex(), 0, overflow - 1);
+        for (int i = 0; i < overflow; ++i) {
+            m_ring[(m_head + i) % m_ring.size()] = GameOutputLine();
+        }
+        m_head = (m_head + overflow) % m_ring.size();
+        m_count -= overflow;
+        m_dropped += overflow;
+        if (m_count == 0) {
+            m_ring.clear();
+            m_head = 0;
+        }
+        endRemoveRows();
+    }
+
+    beginInsertRows(QModelIndex(), m_count, m_count + incoming - 1);
+    for (const GameOutputLine& line : lines) {
+        if (m_ring.size() < m_capacity) {
+            m_ring.append(line);
+        } else {
+            m_ring[(m_head + m_count) % m_capacity] = line;
+        }
+        ++m_count;
+    }
+    endInsertRows();
+
+    emit countChanged();
+}
+
+const GameOutputLine& GameOutputModel::lineAt(int row) const
+{
+    return m_ring.at((m_head + row) % m_ring.size());
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <QAbstractListModel>
+#include <QTimer>
+#include <QVector>
+#include "GameOutputParser.h"
+
+// Bounded console for the game's output. Lines are queued as they arrive and
+// handed to views at most once per frame; once the ring is full the oldest
+// lines are dropped, so memory stays flat however chatty the game is.
+class GameOutputModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+    Q_PROPERTY(int capacity READ capacity WRITE setCapacity NOTIFY capacityChanged)
+    Q_PROPERTY(qint64 droppedLines READ droppedLines NOTIFY countChanged)
+
+public:
+    enum OutputRoles {
+        TextRole = Qt::UserRole + 1,
+        LevelRole,
+        ThreadRole,
+        LoggerRole,
+        TimestampRole,
+        IsErrorRole
+    };
+
+    explicit GameOutputModel(QObject *parent = nullptr);
+
+    // QAbstractListModel interface
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    int capacity() const { return m_capacity; }
+    // Clears the buffer
+    void setCapacity(int capacity);
+    qint64 droppedLines() const { return m_dropped; }
+
+    void append(const QList<GameOutputLine>& lines);
+    Q_INVOKABLE void clear();
+
+signals:
+    void countChanged();
+    void capacityChanged();
+
+private slots:
+    void flushPending();
+
+private:
+    const GameOutputLine& lineAt(int row) const;
+
+    static const int DEFAULT_CAPACITY = 20000;
+    static const int FRAME_INTERVAL_MS = 16;
+
+    QVector<GameOutputLine> m_ring; // grows up to m_capacity, then wraps
+    int m_head = 0;                 // physical index of row 0
+    int m_count = 0;
+    int m_capacity = DEFAULT_CAPACITY;
+    qint64 m_dropped = 0;
+    QList<GameOutputLine> m_pending;
+    QTimer* m_flushTimer;
+};
\ No newline at end of file
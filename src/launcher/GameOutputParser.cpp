@@ -0,0 +1,188 @@
+#include "GameOutputParser.h"
+#include <QXmlStreamReader>
+#include <QDateTime>
+
+GameOutputLine::Level GameOutputLine::levelFromString(QStringView level)
+{
+    if (level.compare(u"INFO", Qt::CaseInsensitive) == 0) return Info;
+    if (level.compare(u"WARN", Qt::CaseInsensitive) == 0) return Warn;
+    if (level.compare(u"WARNING", Qt::CaseInsensitive) == 0) return Warn;
+    if (level.compare(u"ERROR", Qt::CaseInsensitive) == 0) return Error;
+    if (level.compare(u"DEBUG", Qt::CaseInsensitive) == 0) return Debug;
+    if (level.compare(u"TRACE", Qt::CaseInsensitive) == 0) return Trace;
+    if (level.compare(u"FATAL", Qt::CaseInsensitive) == 0) return Fatal;
+    return Unknown;
+}
+
+QString GameOutputLine::levelName(Level level)
+{
+    switch (level) {
+    case Trace: return "TRACE";
+    case Debug: return "DEBUG";
+    case Info: return "INFO";
+    case Warn: return "WARN";
+    case Error: return "ERROR";
+    case Fatal: return "FATAL";
+    case Unknown: break;
+    }
+    return QString();
+}
+
+GameOutputParser::GameOutputParser(bool isError)
+    : m_isError(isError)
+{
+}
+
+QList<GameOutputLine> GameOutputParser::feed(const QByteArray& data)
+{
+    QList<GameOutputLine> lines;
+    m_partial.append(data);
+
+    qsizetype start = 0;
+    qsizetype newline;
+    while ((newline = m_partial.indexOf('\n', start)) >= 0) {
+        qsizetype end = newline;
+        if (end > start && m_partial.at(end - 1) == '\r') {
+            --end;
+        }
+        parseLine(m_partial.mid(start, end - start), lines);
+        start = newline + 1;
+    }
+    m_partial.remove(0, start);
+
+    // A runaway line without a newline is cut rather than buffered forever
+    if (m_partial.size() > MAX_LINE_BYTES) {
+        parseLine(m_partial, lines);
+        m_partial.clear();
+    }
+    return lines;
+}
+
+QList<GameOutputLine> GameOutputParser::finish()
+{
+    QList<GameOutputLine> lines;
+    if (!m_partial.isEmpty()) {
+        parseLine(m_partial, lines);
+        m_partial.clear();
+    }
+    if (!m_event.isEmpty()) {
+        flushEvent(lines);
+    }
+    return lines;
+}
+
+void GameOutputParser::reset()
+{
+    m_partial.clear();
+    m_event.clear();
+}
+
+void GameOutputParser::parseLine(const QByteArray& rawLine, QList<GameOutputLine>& out)
+{
+    if (!m_event.isEmpty() || rawLine.trimmed().startsWith("<log4j:Event")) {
+        m_event.append(rawLine).append('\n');
+        if (rawLine.contains("</log4j:Event>") || m_event.size() > MAX_EVENT_BYTES) {
+            flushEvent(out);
+        }
+        return;
+    }
+
+    GameOutputLine line;
+    line.text = QString::fromUtf8(rawLine);
+    line.timestamp = QDateTime::currentMSecsSinceEpoch();
+    line.isError = m_isError;
+    parsePlainLine(line.text, line);
+    out.append(line);
+}
+
+void GameOutputParser::parsePlainLine(const QString& text, GameOutputLine& line) const
+{
+    // "[12:34:56] [Render thread/INFO]: ..." optionally followed by " [logger/]:" (Forge)
+    if (!text.startsWith('[')) {
+        return;
+    }
+    const qsizetype timeEnd = text.indexOf(']');
+    if (timeEnd < 0 || !QStringView(text).mid(timeEnd + 1).startsWith(u" [")) {
+        return;
+    }
+    const qsizetype sourceStart = timeEnd + 3;
+    const qsizetype sourceEnd = text.indexOf(']', sourceStart);
+    if (sourceEnd < 0) {
+        return;
+    }
+    const QStringView source = QStringView(text).mid(sourceStart, sourceEnd - sourceStart);
+    const qsizetype slash = source.lastIndexOf('/');
+    if (slash < 0) {
+        return;
+    }
+
+    const GameOutputLine::Level level = GameOutputLine::levelFromString(source.mid(slash + 1));
+    if (level == GameOutputLine::Unknown) {
+        return;
+    }
+    line.level = level;
+    line.thread = source.left(slash).toString();
+
+    if (QStringView(text).mid(sourceEnd + 1).startsWith(u" [")) {
+        const qsizetype loggerStart = sourceEnd + 3;
+        const qsizetype loggerEnd = text.indexOf(QLatin1String("]:"), loggerStart);
+        if (loggerEnd > loggerStart) {
+            QStringView logger = QStringView(text).mid(loggerStart, loggerEnd - loggerStart);
+            if (logger.endsWith('/')) {
+                logger.chop(1);
+            }
+            line.logger = logger.toString();
+        }
+    }
+}
+
+bool GameOutputParser::parseEvent(const QByteArray& xml, GameOutputLine& line) const
+{
+    // The log4j: prefix is never declared in the output, so match qualified names
+    QXmlStreamReader reader(xml);
+    reader.setNamespaceProcessing(false);
+
+    bool seenEvent = false;
+    QString throwable;
+    while (!reader.atEnd()) {
+        if (reader.readNext() != QXmlStreamReader::StartElement) {
+            continue;
+        }
+
+        const QStringView name = reader.qualifiedName();
+        if (name == u"log4j:Event") {
+            const QXmlStreamAttributes attributes = reader.attributes();
+            line.logger = attributes.value("logger").toString();
+            line.thread = attributes.value("thread").toString();
+            line.level = GameOutputLine::levelFromString(attributes.value("level"));
+            line.timestamp = attributes.value("timestamp").toLongLong();
+            seenEvent = true;
+        } else if (name == u"log4j:Message") {
+            line.text = reader.readElementText();
+        } else if (name == u"log4j:Throwable") {
+            throwable = reader.readElementText().trimmed();
+        }
+    }
+
+    if (!throwable.isEmpty()) {
+        line.text += '\n' + throwable;
+    }
+    return seenEvent && (!reader.hasError() || !line.text.isEmpty());
+}
+
+void GameOutputParser::flushEvent(QList<GameOutputLine>& out)
+{
+    GameOutputLine line;
+    line.isError = m_isError;
+    if (!parseEvent(m_event, line)) {
+        // Truncated or malformed: show the raw XML rather than lose it
+        line = GameOutputLine();
+        line.text = QString::fromUtf8(m_event).trimmed();
+        line.isError = m_isError;
+    }
+    if (line.timestamp == 0) {
+        line.timestamp = QDateTime::currentMSecsSinceEpoch();
+    }
+    out.append(line);
+    m_event.clear();
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <QList>
+
+struct GameOutputLine
+{
+    enum Level {
+        Unknown,
+        Trace,
+        Debug,
+        Info,
+        Warn,
+        Error,
+        Fatal
+    };
+
+    QString text;
+    QString thread;
+    QString logger;
+    Level level = Unknown;
+    qint64 timestamp = 0; // ms since epoch
+    bool isError = false; // came from stderr
+
+    static Level levelFromString(QStringView level);
+    static QString levelName(Level level);
+};
+
+// Turns raw process output into lines. Bytes are split on '\n' before
+// decoding, so chunks that end mid line or mid UTF-8 sequence are carried
+// over to the next feed(). log4j XML events (the vanilla logging config)
+// are collapsed into one line each with level/thread/logger filled in;
+// plain "[time] [thread/LEVEL]: message" lines are parsed best effort.
+class GameOutputParser
+{
+public:
+    explicit GameOutputParser(bool isError = false);
+
+    QList<GameOutputLine> feed(const QByteArray& data);
+    // Emits whatever is left once the process has exited
+    QList<GameOutputLine> finish();
+    void reset();
+
+private:
+    void parseLine(const QByteArray& rawLine, QList<GameOutputLine>& out);
+    void parsePlainLine(const QString& text, GameOutputLine& line) const;
+    bool parseEvent(const QByteArray& xml, GameOutputLine& line) const;
+    void flushEvent(QList<GameOutputLine>& out);
+
+    static const int MAX_LINE_BYTES = 64 * 1024;
+    static const int MAX_EVENT_BYTES = 1024 * 1024;
+
+    bool m_isError;
+    QByteArray m_partial;
+    QByteArray m_event; // open <log4j:Event>, collected until its end tag
+};
\ No newline at end of file
@@ -0,0 +1,382 @@
+#include "InstanceManager.h"
+#include <QStandardPaths>
+#include <QDir>
+#include <QFile>
+#include <QLoggingCategory>
+
+Q_LOGGING_CATEGORY(instanceManager, "cryovex.launcher.instances")
+
+namespace {
+
+QString stateName(GameInstance::State state)
+{
+    switch (state) {
+    case GameInstance::Preparing:
+        return "preparing";
+    case GameInstance::Running:
+        return "running";
+    case GameInstance::Exited:
+        return "exited";
+    case GameInstance::Crashed:
+        return "crashed";
+    case GameInstance::Failed:
+        return "failed";
+    }
+    return QString();
+}
+
+}
+
+InstanceManager::InstanceManager(QObject *parent)
+    : QAbstractListModel(parent)
+    , m_sampler(new ProcessSampler(this))
+{
+    connect(m_sampler, &ProcessSampler::sampled, this, &InstanceManager::onSampled);
+}
+
+InstanceManager::~InstanceManager()
+{
+    // Kill everything first so the processes wind down in parallel
+    killAttached();
+}
+
+int InstanceManager::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+    return m_instances.size();
+}
+
+QVariant InstanceManager::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_instances.size()) {
+        return QVariant();
+    }
+
+    GameInstance* instance = m_instances.at(index.row());
+    switch (role) {
+    case InstanceIdRole:
+        return instance->instanceId();
+    case Qt::DisplayRole:
+    case VersionIdRole:
+        return instance->versionId();
+    case StateRole:
+        return stateName(instance->state());
+    case ProcessIdRole:
+        return instance->processId();
+    case StartedAtRole:
+        return instance->startedAt();
+    case UptimeMsRole:
+        return instance->uptimeMs();
+    case ExitCodeRole:
+        return instance->exitCode();
+    case OutputLinesRole:
+        return instance->usage().outputLines;
+    case CpuMsRole:
+        return instance->usage().cpuMs;
+    case PeakRssRole:
+        return instance->usage().peakRssBytes;
+    case LogFilePathRole:
+        return instance->logFilePath();
+    case InstanceRole:
+        return QVariant::fromValue(static_cast<QObject*>(instance));
+    default:
+        break;
+    }
+
+    // Ended instances have no live sample
+    const ProcessSample sample = instance->state() == GameInstance::Running
+                                 ? m_sampler->latest(instance->processId()) : ProcessSample();
+    switch (role) {
+    case CpuPercentRole:
+        return sample.cpuPercent;
+    case RssRole:
+        return sample.rssBytes;
+    case ThreadsRole:
+        return sample.threads;
+    case MajorFaultRateRole:
+        return sample.majorFaultsPerSecond;
+    case ReadRateRole:
+        return sample.readBytesPerSecond;
+    case WriteRateRole:
+        return sample.writeBytesPerSecond;
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> InstanceManager::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[InstanceIdRole] = "instanceId";
+    roles[VersionIdRole] = "versionId";
+    roles[StateRole] = "state";
+    roles[ProcessIdRole] = "pid";
+    roles[StartedAtRole] = "startedAt";
+    roles[UptimeMsRole] = "uptimeMs";
+    roles[ExitCodeRole] = "exitCode";
+    roles[OutputLinesRole] = "outputLines";
+    roles[CpuMsRole] = "cpuMs";
+    roles[PeakRssRole] = "peakRss";
+    roles[LogFilePathRole] = "logFilePath";
+    roles[InstanceRole] = "instance";
+    roles[CpuPercentRole] = "cpuPercent";
+    roles[RssRole] = "rss";
+    roles[ThreadsRole] = "threads";
+    roles[MajorFaultRateRole] = "majorFaultRate";
+    roles[ReadRateRole] = "readRate";
+    roles[WriteRateRole] = "writeRate";
+    return roles;
+}
+
+void InstanceManager::setMaxInstances(int maxInstances)
+{
+    maxInstances = qMax(1, maxInstances);
+    if (m_maxInstances != maxInstances) {
+        m_maxInstances = maxInstances;
+        emit maxInstancesChanged();
+    }
+}
+
+void InstanceManager::setSampleIntervalMs(int intervalMs)
+{
+    if (m_sampler->intervalMs() != intervalMs) {
+        m_sampler->setIntervalMs(intervalMs);
+        emit sampleIntervalMsChanged();
+    }
+}
+
+GameInstance* InstanceManager::create(const QString& versionId, LaunchMetrics* metrics)
+{
+    pruneEnded();
+
+    auto* instance = new GameInstance(m_nextId++, versionId, logPathFor(versionId), metrics, this);
+    append(instance);
+    return instance;
+}
+
+void InstanceManager::reattachDetached()
+{
+    const QDir directory(DetachedGame::stateDirectory());
+    const QFileInfoList files = directory.entryInfoList({"*.json"}, QDir::Files, QDir::Time | QDir::Reversed);
+    for (const QFileInfo& file : files) {
+        DetachedGameState state;
+        if (!DetachedGameState::load(file.filePath(), &state)) {
+            qCWarning(instanceManager) << "Removing unreadable instance state" << file.filePath();
+            QFile::remove(file.filePath());
+            continue;
+        }
+        auto* instance = new GameInstance(m_nextId++, state.versionId, state.logFile, new LaunchMetrics(), this);
+        append(instance);
+        instance->attach(file.filePath(), state);
+    }
+}
+
+void InstanceManager::append(GameInstance* instance)
+{
+    connect(instance, &GameInstance::stateChanged, this, [this, instance]() {
+        onStateChanged(instance);
+    });
+    connect(instance, &GameInstance::usageChanged, this, [this, instance]() {
+        onInstanceChanged(instance, {UptimeMsRole, OutputLinesRole, CpuMsRole, PeakRssRole});
+    });
+    connect(instance, &GameInstance::booted, this, &InstanceManager::updateRunningCount);
+
+    beginInsertRows(QModelIndex(), m_instances.size(), m_instances.size());
+    m_instances.append(instance);
+    endInsertRows();
+    emit countChanged();
+
+    updateRunningCount();
+}
+
+GameInstance* InstanceManager::instance(int instanceId) const
+{
+    for (GameInstance* instance : m_instances) {
+        if (instance->instanceId() == instanceId) {
+            return instance;
+        }
+    }
+    return nullptr;
+}
+
+void InstanceManager::kill(int instanceId)
+{
+    if (GameInstance* target = instance(instanceId)) {
+        target->kill();
+    }
+}
+
+void InstanceManager::killAll()
+{
+    for (GameInstance* instance : std::as_const(m_instances)) {
+        instance->kill();
+    }
+}
+
+void InstanceManager::killAttached()
+{
+    for (GameInstance* instance : std::as_const(m_instances)) {
+        if (!instance->isDetached()) {
+            instance->kill();
+        }
+    }
+}
+
+void InstanceManager::remove(int instanceId)
+{
+    for (int row = 0; row < m_instances.size(); ++row) {
+        if (m_instances.at(row)->instanceId() == instanceId) {
+            if (!m_instances.at(row)->isActive()) {
+                removeAt(row);
+            }
+            return;
+        }
+    }
+}
+
+void InstanceManager::clearEnded()
+{
+    for (int row = m_instances.size() - 1; row >= 0; --row) {
+        if (!m_instances.at(row)->isActive()) {
+            removeAt(row);
+        }
+    }
+}
+
+QVariantList InstanceManager::history(int instanceId) const
+{
+    QVariantList samples;
+    GameInstance* target = instance(instanceId);
+    if (!target || target->state() != GameInstance::Running) {
+        return samples;
+    }
+    for (const ProcessSample& sample : m_sampler->history(target->processId())) {
+        samples.append(sample.toVariant());
+    }
+    return samples;
+}
+
+void InstanceManager::onInstanceChanged(GameInstance* instance, const QList<int>& roles)
+{
+    const int row = m_instances.indexOf(instance);
+    if (row >= 0) {
+        const QModelIndex modelIndex = index(row);
+        emit dataChanged(modelIndex, modelIndex, roles);
+    }
+}
+
+void InstanceManager::onStateChanged(GameInstance* instance)
+{
+    onInstanceChanged(instance, {StateRole, ProcessIdRole, UptimeMsRole, ExitCodeRole});
+    updateRunningCount();
+
+    switch (instance->state()) {
+    case GameInstance::Running:
+        m_sampler->track(instance->processId());
+        emit instanceStarted(instance);
+        break;
+    case GameInstance::Exited:
+    case GameInstance::Crashed:
+    case GameInstance::Failed:
+        m_sampler->untrack(instance->processId());
+        qCInfo(instanceManager) << "Instance" << instance->instanceId() << "ended after"
+                                << instance->uptimeMs() << "ms," << m_runningCount << "still running";
+        emit instanceFinished(instance);
+        break;
+    case GameInstance::Preparing:
+        break;
+    }
+}
+
+void InstanceManager::updateRunningCount()
+{
+    int running = 0;
+    int booted = 0;
+    for (GameInstance* instance : std::as_const(m_instances)) {
+        if (instance->isActive()) {
+            ++running;
+        }
+        if (instance->isActive() && instance->isBooted()) {
+            ++booted;
+        }
+    }
+    if (m_runningCount != running) {
+        m_runningCount = running;
+        emit runningCountChanged();
+    }
+    if (m_bootedCount != booted) {
+        m_bootedCount = booted;
+        emit bootedCountChanged();
+    }
+}
+
+void InstanceManager::onSampled()
+{
+    for (GameInstance* instance : std::as_const(m_instances)) {
+        if (instance->state() == GameInstance::Running) {
+            instance->updateUsage(m_sampler->latest(instance->processId()));
+        }
+    }
+
+    // One change notification per tick for all rows
+    static const QList<int> roles = {
+        UptimeMsRole, OutputLinesRole, CpuMsRole, PeakRssRole, CpuPercentRole,
+        RssRole, ThreadsRole, MajorFaultRateRole, ReadRateRole, WriteRateRole
+    };
+    if (!m_instances.isEmpty()) {
+        emit dataChanged(index(0), index(m_instances.size() - 1), roles);
+    }
+}
+
+void InstanceManager::pruneEnded()
+{
+    int ended = 0;
+    for (GameInstance* instance : std::as_const(m_instances)) {
+        if (!instance->isActive()) {
+            ++ended;
+        }
+    }
+
+    // Oldest first, keeping room for the instance about to be created
+    for (int row = 0; row < m_instances.size() && ended >= MAX_ENDED; ) {
+        if (!m_instances.at(row)->isActive()) {
+            removeAt(row);
+            --ended;
+        } else {
+            ++row;
+        }
+    }
+}
+
+void InstanceManager::removeAt(int row)
+{
+    beginRemoveRows(QModelIndex(), row, row);
+    GameInstance* instance = m_instances.takeAt(row);
+    endRemoveRows();
+    instance->deleteLater();
+    emit countChanged();
+}
+
+QString InstanceManager::logPathFor(const QString& versionId) const
+{
+    QString appDataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    const QDir logDirectory(QDir(appDataPath).filePath("logs/game"));
+
+    // Concurrent clients of one version each need a file of their own
+    for (int slot = 1; ; ++slot) {
+        const QString path = logDirectory.filePath(slot == 1 ? versionId + ".log"
+                                                             : QString("%1-%2.log").arg(versionId).arg(slot));
+        bool inUse = false;
+        for (GameInstance* instance : m_instances) {
+            if (instance->isActive() && instance->logFilePath() == path) {
+                inUse = true;
+                break;
+            }
+        }
+        if (!inUse) {
+            return path;
+        }
+    }
+}
\ No newline at end of file
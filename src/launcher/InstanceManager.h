@@ -0,0 +1,109 @@
+#pragma once
+
+#include <QAbstractListModel>
+#include <QList>
+#include "GameInstance.h"
+#include "ProcessSampler.h"
+
+// Supervises every game process the launcher started, for QML as a list of
+// instances. Rows update from the instances' own signals plus one shared
+// ProcessSampler tick for the live resource columns, so dozens of clients
+// need no timers of their own. Ended instances stay listed, up to
+// MAX_ENDED, so their console can be read.
+class InstanceManager : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+    Q_PROPERTY(int runningCount READ runningCount NOTIFY runningCountChanged)
+    Q_PROPERTY(int maxInstances READ maxInstances WRITE setMaxInstances NOTIFY maxInstancesChanged)
+    Q_PROPERTY(int sampleIntervalMs READ sampleIntervalMs WRITE setSampleIntervalMs NOTIFY sampleIntervalMsChanged)
+
+public:
+    enum InstanceRoles {
+        InstanceIdRole = Qt::UserRole + 1,
+        VersionIdRole,
+        StateRole,
+        ProcessIdRole,
+        StartedAtRole,
+        UptimeMsRole,
+        ExitCodeRole,
+        OutputLinesRole,
+        CpuMsRole,
+        PeakRssRole,
+        LogFilePathRole,
+        InstanceRole,
+        // Live, from the latest ProcessSampler reading
+        CpuPercentRole,
+        RssRole,
+        ThreadsRole,
+        MajorFaultRateRole,
+        ReadRateRole,
+        WriteRateRole
+    };
+
+    explicit InstanceManager(QObject *parent = nullptr);
+    ~InstanceManager();
+
+    // QAbstractListModel interface
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    int runningCount() const { return m_runningCount; }
+    // Running instances past their launch, see GameInstance::isBooted()
+    int bootedCount() const { return m_bootedCount; }
+    int maxInstances() const { return m_maxInstances; }
+    void setMaxInstances(int maxInstances);
+    bool canStart() const { return m_runningCount < m_maxInstances; }
+
+    int sampleIntervalMs() const { return m_sampler->intervalMs(); }
+    // 0 turns resource monitoring off
+    void setSampleIntervalMs(int intervalMs);
+
+    // New instance in the Preparing state; takes ownership of metrics
+    GameInstance* create(const QString& versionId, LaunchMetrics* metrics);
+    GameInstance* instance(int instanceId) const;
+    // Lists games earlier sessions started detached, still running or not
+    void reattachDetached();
+    QList<GameInstance*> instances() const { return m_instances; }
+
+    Q_INVOKABLE void kill(int instanceId);
+    Q_INVOKABLE void killAll();
+    // Everything except detached games, which outlive the launcher
+    void killAttached();
+    // Drops an ended instance and its console
+    Q_INVOKABLE void remove(int instanceId);
+    Q_INVOKABLE void clearEnded();
+
+    // Resource samples of a running instance, oldest first, as maps with the
+    // live role names plus timestamp, cpuMs, peakRss and majorFaults
+    Q_INVOKABLE QVariantList history(int instanceId) const;
+
+signals:
+    void countChanged();
+    void runningCountChanged();
+    void bootedCountChanged();
+    void maxInstancesChanged();
+    void sampleIntervalMsChanged();
+    void instanceStarted(GameInstance* instance);
+    void instanceFinished(GameInstance* instance);
+
+private:
+    void append(GameInstance* instance);
+    void onInstanceChanged(GameInstance* instance, const QList<int>& roles);
+    void onStateChanged(GameInstance* instance);
+    void updateRunningCount();
+    void onSampled();
+    void pruneEnded();
+    void removeAt(int row);
+    QString logPathFor(const QString& versionId) const;
+
+    static const int MAX_ENDED = 8;
+
+    ProcessSampler* m_sampler;
+    QList<GameInstance*> m_instances; // launch order
+    int m_nextId = 1;
+    int m_runningCount = 0;
+    int m_bootedCount = 0;
+    int m_maxInstances = 1;
+};
\ No newline at end of file
@@ -0,0 +1,420 @@
+#include "JavaRuntimeDiscovery.h"
+#include "JvmTuning.h"
+#include "ProcessSpawn.h"
+#include <QStandardPaths>
+#include <QProcess>
+#include <QProcessEnvironment>
+#include <QTimer>
+#include <QThread>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QVariantMap>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QDateTime>
+#include <QSet>
+#include <QSysInfo>
+#include <QLoggingCategory>
+#include <algorithm>
+
+Q_LOGGING_CATEGORY(javaDiscovery, "cryovex.launcher.java")
+
+namespace {
+
+#ifdef Q_OS_WIN
+const char* const JAVA_BINARY = "bin/java.exe";
+#else
+const char* const JAVA_BINARY = "bin/java";
+#endif
+
+// Adds <root>/<entry>/<suffix> for every directory entry of root
+void addHomes(const QString& root, const QString& suffix, QStringList& out)
+{
+    const QDir dir(root);
+    if (!dir.exists()) {
+        return;
+    }
+    for (const QString& entry : dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+        out.append(QDir(dir.filePath(entry)).filePath(suffix));
+    }
+}
+
+}
+
+JavaRuntimeDiscovery& JavaRuntimeDiscovery::instance()
+{
+    static JavaRuntimeDiscovery instance;
+    return instance;
+}
+
+JavaRuntimeDiscovery::JavaRuntimeDiscovery(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void JavaRuntimeDiscovery::initialize()
+{
+    QFile file(getCacheFilePath());
+    if (!file.exists()) {
+        return;
+    }
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCWarning(javaDiscovery) << "Failed to open runtime cache:" << file.errorString();
+        return;
+    }
+
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &error);
+    if (error.error != QJsonParseError::NoError) {
+        qCWarning(javaDiscovery) << "Failed to parse runtime cache:" << error.errorString();
+        return;
+    }
+
+    const QJsonObject runtimes = doc.object();
+    for (auto it = runtimes.constBegin(); it != runtimes.constEnd(); ++it) {
+        const QJsonObject entry = it.value().toObject();
+
+        JavaRuntime runtime;
+        runtime.path = it.key();
+        runtime.modified = entry["modified"].toInteger();
+        runtime.size = entry["size"].toInteger();
+        runtime.majorVersion = entry["major"].toInt();
+        runtime.version = entry["version"].toString();
+        runtime.vendor = entry["vendor"].toString();
+        runtime.arch = entry["arch"].toString();
+        for (const QJsonValue& flag : entry["flags"].toArray()) {
+            runtime.supportedFlags.append(flag.toString());
+        }
+        m_runtimes.insert(runtime.path, runtime);
+    }
+    m_dirty = false;
+
+    qCInfo(javaDiscovery) << "Loaded" << m_runtimes.size() << "cached Java runtimes";
+    emit runtimesChanged();
+}
+
+void JavaRuntimeDiscovery::save()
+{
+    if (!m_dirty) {
+        return;
+    }
+
+    QJsonObject runtimes;
+    for (const JavaRuntime& runtime : std::as_const(m_runtimes)) {
+        QJsonObject entry;
+        entry["modified"] = runtime.modified;
+        entry["size"] = runtime.size;
+        entry["major"] = runtime.majorVersion;
+        entry["version"] = runtime.version;
+        entry["vendor"] = runtime.vendor;
+        entry["arch"] = runtime.arch;
+        entry["flags"] = QJsonArray::fromStringList(runtime.supportedFlags);
+        runtimes.insert(runtime.path, entry);
+    }
+
+    const QString cachePath = getCacheFilePath();
+    QDir().mkpath(QFileInfo(cachePath).absolutePath());
+
+    QFile file(cachePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(javaDiscovery) << "Failed to save runtime cache:" << file.errorString();
+        return;
+    }
+
+    file.write(QJsonDocument(runtimes).toJson(QJsonDocument::Compact));
+    m_dirty = false;
+}
+
+void JavaRuntimeDiscovery::scan()
+{
+    if (isScanning()) {
+        return;
+    }
+
+    const QStringList candidates = findCandidates();
+
+    // Forget runtimes that were uninstalled or replaced, keep the rest as is
+    QSet<QString> present(candidates.cbegin(), candidates.cend());
+    for (auto it = m_runtimes.begin(); it != m_runtimes.end();) {
+        if (!present.contains(it.key()) || !isUnchanged(it.value())) {
+            it = m_runtimes.erase(it);
+            m_dirty = true;
+        } else {
+            ++it;
+        }
+    }
+
+    for (const QString& path : candidates) {
+        if (!m_runtimes.contains(path)) {
+            m_queue.append(path);
+        }
+    }
+
+    qCInfo(javaDiscovery) << "Found" << candidates.size() << "Java candidates," << m_queue.size() << "need probing";
+
+    if (m_queue.isEmpty()) {
+        emit runtimesChanged();
+        emit scanFinished();
+        return;
+    }
+
+    emit scanningChanged();
+    startNextProbes();
+}
+
+QList<JavaRuntime> JavaRuntimeDiscovery::runtimes() const
+{
+    QList<JavaRuntime> runtimes = m_runtimes.values();
+    std::sort(runtimes.begin(), runtimes.end(), [](const JavaRuntime& a, const JavaRuntime& b) {
+        return a.majorVersion != b.majorVersion ? a.majorVersion > b.majorVersion : a.path < b.path;
+    });
+    return runtimes;
+}
+
+QVariantList JavaRuntimeDiscovery::runtimesVariant() const
+{
+    QVariantList list;
+    for (const JavaRuntime& runtime : runtimes()) {
+        QVariantMap entry;
+        entry["path"] = runtime.path;
+        entry["majorVersion"] = runtime.majorVersion;
+        entry["version"] = runtime.version;
+        entry["vendor"] = runtime.vendor;
+        entry["arch"] = runtime.arch;
+        list.append(entry);
+    }
+    return list;
+}
+
+JavaRuntime JavaRuntimeDiscovery::runtime(const QString& javaExecutable) const
+{
+    const QString canonical = QFileInfo(javaExecutable).canonicalFilePath();
+    auto it = m_runtimes.constFind(canonical);
+    if (it == m_runtimes.constEnd() || !isUnchanged(it.value())) {
+        return JavaRuntime();
+    }
+    return it.value();
+}
+
+JavaRuntime JavaRuntimeDiscovery::bestFor(int requiredMajor) const
+{
+    // Old versions without javaVersion in the manifest run on Java 8
+    if (requiredMajor <= 0) {
+        requiredMajor = 8;
+    }
+
+    const QString hostArch = QSysInfo::currentCpuArchitecture();
+    auto score = [&](const JavaRuntime& runtime) {
+        // Exact major first, then the closest newer one; native arch breaks ties
+        const int distance = runtime.majorVersion - requiredMajor;
+        const bool nativeArch = (hostArch == "x86_64" && (runtime.arch == "amd64" || runtime.arch == "x86_64"))
+                                || runtime.arch == hostArch;
+        return distance * 2 + (nativeArch ? 0 : 1);
+    };
+
+    JavaRuntime best;
+    int bestScore = 0;
+    for (const JavaRuntime& runtime : std::as_const(m_runtimes)) {
+        if (runtime.majorVersion < requiredMajor || !isUnchanged(runtime)) {
+            continue;
+        }
+        const int candidateScore = score(runtime);
+        if (!best.isValid() || candidateScore < bestScore
+            || (candidateScore == bestScore && runtime.path < best.path)) {
+            best = runtime;
+            bestScore = candidateScore;
+        }
+    }
+    return best;
+}
+
+bool JavaRuntimeDiscovery::isAutomatic(const QString& javaPath)
+{
+    return javaPath.isEmpty() || javaPath == "java" || javaPath == "java.exe";
+}
+
+int JavaRuntimeDiscovery::parseMajorVersion(const QString& version)
+{
+    // "1.8.0_392" -> 8, "17.0.9" -> 17, "21" -> 21, "22-ea" -> 22
+    const QStringList parts = version.split('.');
+    QString first = parts.value(0);
+    if (first == "1") {
+        first = parts.value(1);
+    }
+    const qsizetype end = std::find_if(first.cbegin(), first.cend(), [](QChar c) { return !c.isDigit(); }) - first.cbegin();
+    return first.left(end).toInt();
+}
+
+QStringList JavaRuntimeDiscovery::findCandidates() const
+{
+    QStringList homes;
+    const QString home = QDir::homePath();
+
+    const QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+    if (environment.contains("JAVA_HOME")) {
+        homes.append(QDir(environment.value("JAVA_HOME")).filePath(JAVA_BINARY));
+    }
+    const QString onPath = QStandardPaths::findExecutable("java");
+    if (!onPath.isEmpty()) {
+        homes.append(onPath);
+    }
+
+#if defined(Q_OS_WIN)
+    for (const QString& vendorDir : {"Java", "Eclipse Adoptium", "Microsoft", "Zulu", "BellSoft", "Amazon Corretto"}) {
+        addHomes(environment.value("ProgramFiles", "C:/Program Files") + "/" + vendorDir, JAVA_BINARY, homes);
+    }
+#elif defined(Q_OS_MACOS)
+    addHomes("/Library/Java/JavaVirtualMachines", QString("Contents/Home/") + JAVA_BINARY, homes);
+    addHomes(home + "/Library/Java/JavaVirtualMachines", QString("Contents/Home/") + JAVA_BINARY, homes);
+#else
+    addHomes("/usr/lib/jvm", JAVA_BINARY, homes);
+    addHomes("/usr/lib64/jvm", JAVA_BINARY, homes);
+    addHomes("/opt/java", JAVA_BINARY, homes);
+#endif
+    addHomes(home + "/.sdkman/candidates/java", JAVA_BINARY, homes);
+    addHomes(home + "/.jdks", JAVA_BINARY, homes);
+
+    // Ours, then the official launcher's: runtime/<component>/<platform>/<component>/bin/java
+    const QString appDataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    addHomes(QDir(appDataPath).filePath("runtimes"), JAVA_BINARY, homes);
+    if (!m_gameDirectory.isEmpty()) {
+        const QDir runtimeRoot(QDir(m_gameDirectory).filePath("runtime"));
+        for (const QString& component : runtimeRoot.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+            addHomes(runtimeRoot.filePath(component), component + "/" + JAVA_BINARY, homes);
+        }
+    }
+
+    // Symlinks such as /usr/bin/java and "current" collapse onto one binary
+    QStringList candidates;
+    QSet<QString> seen;
+    for (const QString& path : std::as_const(homes)) {
+        const QFileInfo info(path);
+        if (!info.isFile() || !info.isExecutable()) {
+            continue;
+        }
+        const QString canonical = info.canonicalFilePath();
+        if (!seen.contains(canonical)) {
+            seen.insert(canonical);
+            candidates.append(canonical);
+        }
+    }
+    return candidates;
+}
+
+void JavaRuntimeDiscovery::startNextProbes()
+{
+    const int limit = qMax(2, QThread::idealThreadCount());
+    while (m_running < limit && !m_queue.isEmpty()) {
+        startProbe(m_queue.takeFirst());
+    }
+}
+
+void JavaRuntimeDiscovery::startProbe(const QString& path)
+{
+    ++m_running;
+
+    // Properties go to stderr, the flag table to stdout
+    QProcess* process = new QProcess(this);
+    process->setProgram(path);
+    process->setArguments({"-XshowSettings:properties", "-XX:+UnlockExperimentalVMOptions",
+                           "-XX:+PrintFlagsFinal", "-version"});
+    ProcessSpawn::configure(process);
+
+    connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this,
+            [this, process, path](int exitCode, QProcess::ExitStatus exitStatus) {
+        finishProbe(process, path, exitStatus == QProcess::NormalExit && exitCode == 0);
+    });
+    connect(process, &QProcess::errorOccurred, this, [this, process, path](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart) {
+            finishProbe(process, path, false);
+        }
+    });
+    QTimer::singleShot(PROBE_TIMEOUT_MS, process, [process]() {
+        process->kill();
+    });
+
+    process->start();
+}
+
+void JavaRuntimeDiscovery::finishProbe(QProcess* process, const QString& path, bool success)
+{
+    if (success) {
+        JavaRuntime runtime = parseProbe(path, process->readAllStandardError(), process->readAllStandardOutput());
+        if (runtime.isValid()) {
+            qCInfo(javaDiscovery) << "Java" << runtime.version << "(" << runtime.vendor << runtime.arch << ") at" << path;
+            m_runtimes.insert(path, runtime);
+            m_dirty = true;
+        }
+    } else {
+        qCWarning(javaDiscovery) << "Probe failed for" << path;
+    }
+    process->deleteLater();
+
+    --m_running;
+    startNextProbes();
+
+    if (!isScanning()) {
+        save();
+        emit runtimesChanged();
+        emit scanningChanged();
+        emit scanFinished();
+    }
+}
+
+JavaRuntime JavaRuntimeDiscovery::parseProbe(const QString& path, const QByteArray& properties, const QByteArray& flags)
+{
+    JavaRuntime runtime;
+    runtime.path = path;
+    const QFileInfo info(path);
+    runtime.modified = info.lastModified().toMSecsSinceEpoch();
+    runtime.size = info.size();
+
+    // "    java.version = 17.0.9"
+    for (const QByteArray& rawLine : properties.split('\n')) {
+        const QByteArray line = rawLine.trimmed();
+        const qsizetype equals = line.indexOf(" = ");
+        if (equals < 0) {
+            continue;
+        }
+        const QByteArray key = line.left(equals);
+        const QString value = QString::fromUtf8(line.mid(equals + 3));
+        if (key == "java.version") {
+            runtime.version = value;
+        } else if (key == "java.vendor") {
+            runtime.vendor = value;
+        } else if (key == "os.arch") {
+            runtime.arch = value;
+        }
+    }
+    runtime.majorVersion = parseMajorVersion(runtime.version);
+
+    // "     bool UseZGC      = false      {product} {default}"; Java 8 prints
+    // ":=" for flags set on the command line or by ergonomics
+    const QStringList wanted = JvmTuning::tunedFlagNames();
+    for (const QByteArray& rawLine : flags.split('\n')) {
+        const QList<QByteArray> fields = rawLine.simplified().split(' ');
+        if (fields.size() >= 3 && (fields.at(2) == "=" || fields.at(2) == ":=")) {
+            const QString name = QString::fromLatin1(fields.at(1));
+            if (wanted.contains(name) && !runtime.supportedFlags.contains(name)) {
+                runtime.supportedFlags.append(name);
+            }
+        }
+    }
+    return runtime;
+}
+
+bool JavaRuntimeDiscovery::isUnchanged(const JavaRuntime& runtime)
+{
+    const QFileInfo info(runtime.path);
+    return info.exists() && info.size() == runtime.size
+           && info.lastModified().toMSecsSinceEpoch() == runtime.modified;
+}
+
+QString JavaRuntimeDiscovery::getCacheFilePath() const
+{
+    QString appDataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    return QDir(appDataPath).filePath("cache/java-runtimes.json");
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QStringList>
+#include <QVariantList>
+
+class QProcess;
+
+struct JavaRuntime
+{
+    QString path;          // canonical path of bin/java
+    qint64 modified = 0;   // mtime of the binary when probed, ms since epoch
+    qint64 size = 0;
+    int majorVersion = 0;
+    QString version;       // java.version, e.g. "17.0.9" or "1.8.0_392"
+    QString vendor;
+    QString arch;          // os.arch, e.g. "amd64" or "aarch64"
+    QStringList supportedFlags; // JvmTuning flag names this runtime accepts
+
+    bool isValid() const { return majorVersion > 0; }
+};
+
+// Finds installed Java runtimes and remembers what they are. Candidates come
+// from the usual JDK locations, SDKMAN, JAVA_HOME, PATH and the runtimes the
+// official launcher leaves in the game directory. Each one is probed once in
+// its own process, in parallel; results are cached by path, size and mtime in
+// cache/java-runtimes.json, so later starts only probe binaries that changed.
+class JavaRuntimeDiscovery : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(QVariantList runtimes READ runtimesVariant NOTIFY runtimesChanged)
+    Q_PROPERTY(bool isScanning READ isScanning NOTIFY scanningChanged)
+
+public:
+    static JavaRuntimeDiscovery& instance();
+
+    void initialize();
+    void save();
+
+    void setGameDirectory(const QString& directory) { m_gameDirectory = directory; }
+
+    Q_INVOKABLE void scan();
+    bool isScanning() const { return m_running > 0 || !m_queue.isEmpty(); }
+
+    QList<JavaRuntime> runtimes() const;
+    QVariantList runtimesVariant() const;
+
+    // Probe result for an executable, if it is known and unchanged on disk
+    JavaRuntime runtime(const QString& javaExecutable) const;
+
+    // Closest runtime for a manifest's javaVersion.majorVersion: the exact
+    // major if installed, otherwise the oldest newer one. Invalid if none.
+    JavaRuntime bestFor(int requiredMajor) const;
+
+    // "java" or empty means pick a runtime per version
+    static bool isAutomatic(const QString& javaPath);
+    static int parseMajorVersion(const QString& version);
+
+signals:
+    void runtimesChanged();
+    void scanningChanged();
+    void scanFinished();
+
+private:
+    explicit JavaRuntimeDiscovery(QObject *parent = nullptr);
+    ~JavaRuntimeDiscovery() = default;
+
+    QStringList findCandidates() const;
+    void startNextProbes();
+    void startProbe(const QString& path);
+    void finishProbe(QProcess* process, const QString& path, bool success);
+    static JavaRuntime parseProbe(const QString& path, const QByteArray& properties, const QByteArray& flags);
+    static bool isUnchanged(const JavaRuntime& runtime);
+    QString getCacheFilePath() const;
+
+    static const int PROBE_TIMEOUT_MS = 15000;
+
+    QString m_gameDirectory;
+    QHash<QString, JavaRuntime> m_runtimes; // canonical path -> probe result
+    QStringList m_queue;
+    int m_running = 0;
+    bool m_dirty = false;
+};
\ No newline at end of file
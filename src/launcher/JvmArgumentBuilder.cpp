@@ -1,129 +1,163 @@
 #include "JvmArgumentBuilder.h"
+#include "JavaRuntimeDiscovery.h"
+#include "utils/CompiledManifest.h"
 #include <QLoggingCategory>
+#include <QCoreApplication>
 #include <QDir>
-#include <QTimer>
+#include <QFileInfo>
+#include <QSet>
 
 Q_LOGGING_CATEGORY(jvmArgumentBuilder, "cryovex.launcher.jvm")
 
-const QStringList JvmArgumentBuilder::DEFAULT_JVM_ARGS = {
-    "-XX:+UnlockExperimentalVMOptions",
-    "-XX:+UseG1GC",
-    "-XX:G1NewSizePercent=20",
-    "-XX:G1ReservePercent=20",
-    "-XX:MaxGCPauseMillis=50",
-    "-XX:G1HeapRegionSize=32M"
-};
+namespace {
+// RuleEngine::Feature bits; no profile option enables demo mode, a custom
+// resolution or quick play yet
+constexpr quint32 LAUNCH_FEATURES = 0;
+}
 
 JvmArgumentBuilder::JvmArgumentBuilder(QObject *parent)
     : QObject(parent)
 {
 }
 
-QStringList JvmArgumentBuilder::buildArguments(const QJsonObject& versionManifest,
-                                              const QString& username,
-                                              const QString& uuid,
-                                              const QString& accessToken,
-                                              const QString& gameDirectory,
-                                              const QString& assetsDirectory,
-                                              const QString& versionName,
-                                              int memoryMB,
-                                              const QString& javaPath)
+JvmArgumentBuilder::LaunchTemplates JvmArgumentBuilder::launchTemplates(const QJsonObject& versionManifest,
+                                                                       quint32 features)
 {
-    qCInfo(jvmArgumentBuilder) << "Building JVM arguments for version:" << versionName << "(stub)";
+    // Tokenised once per manifest and feature set
+    const QSharedPointer<const CompiledManifest> compiled = CompiledManifest::get(versionManifest);
+    const QString key = compiled->key + ":" + QString::number(features);
     
-    Q_UNUSED(versionManifest)
-    Q_UNUSED(gameDirectory)
-    Q_UNUSED(assetsDirectory)
-    Q_UNUSED(javaPath)
+    QMutexLocker locker(&m_templatesMutex);
+    auto cached = m_templates.constFind(key);
+    if (cached != m_templates.constEnd()) {
+        return cached.value();
+    }
     
-    QStringList args;
+    LaunchTemplates templates;
+    templates.mainClass = compiled->mainClass;
+    templates.jvm = ArgumentTemplate::compile(compiled->jvmArgumentsFor(features));
+    templates.game = ArgumentTemplate::compile(compiled->gameArgumentsFor(features));
+    return m_templates.insert(key, templates).value();
+}
+
+LaunchPlan JvmArgumentBuilder::buildLaunchPlan(const QJsonObject& versionManifest,
+                                              const LaunchSettings& settings,
+                                              const QString& javaExecutable,
+                                              const JavaRuntime& runtime)
+{
+    const QSharedPointer<const CompiledManifest> compiled = CompiledManifest::get(versionManifest);
+    const QString versionName = compiled->id;
+    const QString librariesDirectory = QDir(settings.gameDirectory).filePath("libraries");
     
-    // Memory settings
-    args << QString("-Xmx%1m").arg(memoryMB);
-    args << QString("-Xms%1m").arg(memoryMB / 2);
+    LaunchPlan plan;
+    plan.versionId = versionName;
+    plan.javaExecutable = javaExecutable;
+    plan.workingDirectory = settings.gameDirectory;
+    plan.variables = launchVariables(versionManifest, settings.gameDirectory,
+                                     QDir(settings.gameDirectory).filePath("assets"), versionName,
+                                     LAUNCH_FEATURES);
     
-    // Add default JVM arguments
-    args << DEFAULT_JVM_ARGS;
+    // What the runtime itself reports beats the manifest's minimum
+    int javaMajor = runtime.isValid() ? runtime.majorVersion : JvmTuning::detectJavaMajor(javaExecutable);
+    if (javaMajor <= 0) {
+        javaMajor = compiled->javaMajorVersion;
+    }
+    const JvmTuning tuning = JvmTuning::compute(settings.jvmProfile, settings.memoryMB, javaMajor,
+                                                runtime.supportedFlags);
+    plan.tuning = tuning.toJson();
     
-    // Main class (stub)
-    args << "-cp" << "minecraft.jar" << "net.minecraft.client.main.Main";
+    plan.arguments << tuning.flags();
+    plan.arguments << compiled->jvmArgumentsFor(LAUNCH_FEATURES);
+    plan.arguments << compiled->mainClass;
+    plan.arguments << compiled->gameArgumentsFor(LAUNCH_FEATURES);
     
-    // Game arguments (stub)
-    args << "--username" << username;
-    args << "--version" << versionName;
-    args << "--gameDir" << gameDirectory;
-    args << "--assetsDir" << assetsDirectory;
-    args << "--assetIndex" << "1.20";
-    args << "--uuid" << uuid;
-    args << "--accessToken" << accessToken;
-    args << "--userType" << "msa";
-    args << "--versionType" << "release";
+    // Only the tuning flags vary between plans of one manifest
+    const LaunchTemplates templates = launchTemplates(versionManifest, LAUNCH_FEATURES);
+    plan.templates = ArgumentTemplate::compile(tuning.flags());
+    plan.templates << templates.jvm;
+    plan.templates << ArgumentTemplate::compile({templates.mainClass});
+    plan.templates << templates.game;
     
-    return args;
-}
-
-QString JvmArgumentBuilder::replacePlaceholders(const QString& argument,
-                                               const QString& username,
-                                               const QString& uuid,
-                                               const QString& accessToken,
-                                               const QString& gameDirectory,
-                                               const QString& assetsDirectory,
-                                               const QString& versionName,
-                                               const QString& libraryDirectory,
-                                               const QString& classpath)
-{
-    QString result = argument;
-    result.replace("${auth_player_name}", username);
-    result.replace("${auth_uuid}", uuid);
-    result.replace("${auth_access_token}", accessToken);
-    result.replace("${game_directory}", gameDirectory);
-    result.replace("${assets_root}", assetsDirectory);
-    result.replace("${version_name}", versionName);
-    result.replace("${library_directory}", libraryDirectory);
-    result.replace("${classpath}", classpath);
-    return result;
-}
-
-QString JvmArgumentBuilder::buildClasspath(const QJsonObject& versionManifest, 
-                                          const QString& gameDirectory,
-                                          const QString& versionName)
-{
-    Q_UNUSED(versionManifest)
-    Q_UNUSED(gameDirectory)
-    Q_UNUSED(versionName)
+    // Everything the command line points at
+    const QString clientJar = plan.variables[ArgumentTemplate::PrimaryJar];
+    // Sizes come from the manifest, never from disk, or a truncated jar would pass
+    const QJsonObject client = versionManifest["downloads"].toObject()["client"].toObject();
+    plan.files.append(LaunchPlan::CheckedFile{QFileInfo(clientJar).absoluteFilePath(),
+                                              client["size"].toInteger(-1), client["sha1"].toString()});
+    for (const CompiledLibrary* library : compiled->librariesFor(LAUNCH_FEATURES)) {
+        if (library->hasArtifact()) {
+            plan.files.append(LaunchPlan::CheckedFile{
+                QFileInfo(librariesDirectory + "/" + library->path).absoluteFilePath(), library->size, library->sha1});
+        }
+        if (library->hasNative()) {
+            const QString nativePath = QFileInfo(librariesDirectory + "/" + library->nativePath).absoluteFilePath();
+            plan.files.append(LaunchPlan::CheckedFile{nativePath, library->nativeSize, library->nativeSha1});
+            plan.natives.append(NativeJar{nativePath, library->nativeSha1, library->extractExclude});
+        }
+    }
     
-    // Stub implementation
-    return "minecraft.jar";
+    qCInfo(jvmArgumentBuilder) << "Built launch plan for" << versionName << ":" << plan.arguments.size()
+                               << "arguments," << plan.files.size() << "files";
+    return plan;
 }
 
-QStringList JvmArgumentBuilder::getJvmArguments(const QJsonObject& versionManifest, int memoryMB)
+ArgumentTemplate::Variables JvmArgumentBuilder::launchVariables(const QJsonObject& versionManifest,
+                                                                const QString& gameDirectory,
+                                                                const QString& assetsDirectory,
+                                                                const QString& versionName,
+                                                                quint32 features)
 {
-    Q_UNUSED(versionManifest)
+    const QSharedPointer<const CompiledManifest> compiled = CompiledManifest::get(versionManifest);
     
-    QStringList args;
-    args << QString("-Xmx%1m").arg(memoryMB);
-    args << QString("-Xms%1m").arg(memoryMB / 2);
-    args << DEFAULT_JVM_ARGS;
-    return args;
+    ArgumentTemplate::Variables variables;
+    variables[ArgumentTemplate::UserType] = "msa";
+    variables[ArgumentTemplate::UserProperties] = "{}";
+    variables[ArgumentTemplate::VersionName] = versionName;
+    variables[ArgumentTemplate::VersionType] = compiled->type;
+    variables[ArgumentTemplate::GameDirectory] = gameDirectory;
+    variables[ArgumentTemplate::AssetsRoot] = assetsDirectory;
+    variables[ArgumentTemplate::GameAssets] = assetsDirectory;
+    variables[ArgumentTemplate::AssetsIndexName] = compiled->assetIndexId;
+    variables[ArgumentTemplate::NativesDirectory] = getNativesDirectory(gameDirectory, versionName);
+    variables[ArgumentTemplate::LibraryDirectory] = QDir(gameDirectory).filePath("libraries");
+    variables[ArgumentTemplate::Classpath] = buildClasspath(versionManifest, gameDirectory, versionName, features);
+    variables[ArgumentTemplate::ClasspathSeparator] = QString(QDir::listSeparator());
+    variables[ArgumentTemplate::LauncherName] = "cryovex";
+    variables[ArgumentTemplate::LauncherVersion] = QCoreApplication::applicationVersion();
+    variables[ArgumentTemplate::PrimaryJar] = QDir(gameDirectory).filePath("versions/" + versionName + "/" + versionName + ".jar");
+    return variables;
 }
 
-QStringList JvmArgumentBuilder::getGameArguments(const QJsonObject& versionManifest)
+QString JvmArgumentBuilder::buildClasspath(const QJsonObject& versionManifest,
+                                          const QString& gameDirectory,
+                                          const QString& versionName,
+                                          quint32 features)
 {
-    Q_UNUSED(versionManifest)
+    const QSharedPointer<const CompiledManifest> compiled = CompiledManifest::get(versionManifest);
+    const QString librariesDirectory = QDir(gameDirectory).filePath("libraries");
     
-    // Stub implementation
-    return QStringList();
-}
-
-bool JvmArgumentBuilder::checkRule(const QJsonObject& rule)
-{
-    Q_UNUSED(rule)
+    // Libraries first, client jar last; the first occurrence of a path wins
+    QStringList entries;
+    QSet<QString> seen;
+    for (const CompiledLibrary* library : compiled->librariesFor(features)) {
+        if (!library->hasArtifact()) {
+            continue;
+        }
+        const QString path = librariesDirectory + "/" + library->path;
+        if (!seen.contains(path)) {
+            seen.insert(path);
+            entries.append(QDir::toNativeSeparators(path));
+        }
+    }
+    entries.append(QDir::toNativeSeparators(
+        QDir(gameDirectory).filePath("versions/" + versionName + "/" + versionName + ".jar")));
     
-    // Stub implementation - always return true
-    return true;
+    return entries.join(QDir::listSeparator());
 }
 
 QString JvmArgumentBuilder::getNativesDirectory(const QString& gameDirectory, const QString& versionName)
 {
-    return QDir(gameDirectory).filePath("versions/" + versionName + "/natives");
+    // Stable, so cached plans match; each launch links into its own
+    // "-<instance>" sibling of it
+    return QDir(gameDirectory).filePath("natives/" + versionName);
 }
\ No newline at end of file
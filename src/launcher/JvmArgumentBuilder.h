@@ -4,6 +4,11 @@
 #include <QJsonObject>
 #include <QStringList>
 #include <QDir>
+#include <QHash>
+#include <QMutex>
+#include "ArgumentTemplate.h"
+#include "LaunchPlanCache.h"
+#include "JavaRuntimeDiscovery.h"
 
 class JvmArgumentBuilder : public QObject
 {
@@ -12,36 +17,36 @@ class JvmArgumentBuilder : public QObject
 public:
     explicit JvmArgumentBuilder(QObject *parent = nullptr);
     
-    QStringList buildArguments(const QJsonObject& versionManifest,
-                              const QString& username,
-                              const QString& uuid,
-                              const QString& accessToken,
-                              const QString& gameDirectory,
-                              const QString& assetsDirectory,
-                              const QString& versionName,
-                              int memoryMB = 2048,
-                              const QString& javaPath = "java");
+    // Resolves everything but the account values, for LaunchPlanCache. Safe
+    // on any thread; runtime is what JavaRuntimeDiscovery knows about
+    // javaExecutable, invalid if it was never probed.
+    LaunchPlan buildLaunchPlan(const QJsonObject& versionManifest,
+                               const LaunchSettings& settings,
+                               const QString& javaExecutable,
+                               const JavaRuntime& runtime);
+    
+    static QString getNativesDirectory(const QString& gameDirectory, const QString& versionName);
 
 private:
-    QString replacePlaceholders(const QString& argument,
-                               const QString& username,
-                               const QString& uuid,
-                               const QString& accessToken,
-                               const QString& gameDirectory,
-                               const QString& assetsDirectory,
-                               const QString& versionName,
-                               const QString& libraryDirectory,
-                               const QString& classpath);
+    struct LaunchTemplates {
+        QString mainClass;
+        QVector<ArgumentTemplate> jvm;
+        QVector<ArgumentTemplate> game;
+    };
     
-    QString buildClasspath(const QJsonObject& versionManifest, 
-                          const QString& gameDirectory,
-                          const QString& versionName);
+    LaunchTemplates launchTemplates(const QJsonObject& versionManifest, quint32 features);
     
-    QStringList getJvmArguments(const QJsonObject& versionManifest, int memoryMB);
-    QStringList getGameArguments(const QJsonObject& versionManifest);
+    ArgumentTemplate::Variables launchVariables(const QJsonObject& versionManifest,
+                                                const QString& gameDirectory,
+                                                const QString& assetsDirectory,
+                                                const QString& versionName,
+                                                quint32 features);
     
-    bool checkRule(const QJsonObject& rule);
-    QString getNativesDirectory(const QString& gameDirectory, const QString& versionName);
+    QString buildClasspath(const QJsonObject& versionManifest,
+                          const QString& gameDirectory,
+                          const QString& versionName,
+                          quint32 features);
     
-    static const QStringList DEFAULT_JVM_ARGS;
+    QMutex m_templatesMutex;
+    QHash<QString, LaunchTemplates> m_templates;
 };
\ No newline at end of file
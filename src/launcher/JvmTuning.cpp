@@ -0,0 +1,365 @@
+#include "JvmTuning.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QJsonArray>
+#include <QThread>
+#include <QLoggingCategory>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#elif defined(Q_OS_UNIX)
+#include <unistd.h>
+#endif
+
+Q_LOGGING_CATEGORY(jvmTuning, "cryovex.launcher.tuning")
+
+namespace {
+
+struct FlagRequirement {
+    const char* prefix;
+    int minJava;
+    int maxJava;    // 0 = no upper bound
+    bool linuxOnly;
+};
+
+// Flags we emit that some runtimes refuse with "Unrecognized VM option"
+const FlagRequirement FLAG_REQUIREMENTS[] = {
+    { "-XX:+UseZGC", 15, 0, false },
+    { "-XX:+ZGenerational", 21, 23, false },
+    { "-XX:G1PeriodicGCInterval=", 12, 0, false },
+    { "-XX:+UseTransparentHugePages", 7, 0, true },
+};
+
+// Only accepted after -XX:+UnlockExperimentalVMOptions
+const char* EXPERIMENTAL_FLAGS[] = {
+    "-XX:G1NewSizePercent=",
+};
+
+// Left for the OS, the game's native allocations and the launcher itself
+const qint64 MIN_RESERVED_MB = 1536;
+const int MIN_HEAP_MB = 512;
+
+qint64 meminfoValue(const QByteArray& meminfo, const char* key)
+{
+    const qsizetype start = meminfo.indexOf(key);
+    if (start < 0) {
+        return 0;
+    }
+    const qsizetype end = meminfo.indexOf('\n', start);
+    QByteArray value = meminfo.mid(start + qstrlen(key), end - start - qstrlen(key)).trimmed();
+    if (value.endsWith("kB")) {
+        value.chop(2);
+    }
+    return value.trimmed().toLongLong();
+}
+
+}
+
+HostInfo HostInfo::detect()
+{
+    HostInfo host;
+    host.cpuCount = qMax(1, QThread::idealThreadCount());
+
+#if defined(Q_OS_LINUX)
+    QFile meminfo("/proc/meminfo");
+    if (meminfo.open(QIODevice::ReadOnly)) {
+        const QByteArray data = meminfo.readAll();
+        host.totalMemoryMB = meminfoValue(data, "MemTotal:") / 1024;
+        host.availableMemoryMB = meminfoValue(data, "MemAvailable:") / 1024;
+        host.hugePagesFree = meminfoValue(data, "HugePages_Free:");
+        host.hugePageSizeKB = meminfoValue(data, "Hugepagesize:");
+    }
+
+    QFile thp("/sys/kernel/mm/transparent_hugepage/enabled");
+    if (thp.open(QIODevice::ReadOnly)) {
+        const QByteArray mode = thp.readAll();
+        host.transparentHugePages = mode.contains("[always]") || mode.contains("[madvise]");
+    }
+#elif defined(Q_OS_WIN)
+    MEMORYSTATUSEX status;
+    status.dwLength = sizeof(status);
+    if (GlobalMemoryStatusEx(&status)) {
+        host.totalMemoryMB = qint64(status.ullTotalPhys / (1024 * 1024));
+        host.availableMemoryMB = qint64(status.ullAvailPhys / (1024 * 1024));
+    }
+#elif defined(Q_OS_UNIX)
+    const long pages = sysconf(_SC_PHYS_PAGES);
+    const long pageSize = sysconf(_SC_PAGESIZE);
+    if (pages > 0 && pageSize > 0) {
+        host.totalMemoryMB = qint64(pages) * pageSize / (1024 * 1024);
+        host.availableMemoryMB = host.totalMemoryMB;
+    }
+#endif
+
+    return host;
+}
+
+JvmTuning JvmTuning::compute(Profile profile, int requestedHeapMB, int javaMajor,
+                             const QStringList& supportedFlags, const HostInfo& host)
+{
+    JvmTuning tuning;
+    tuning.m_javaMajor = javaMajor > 0 ? javaMajor : 8;
+
+    if (profile == Auto) {
+        profile = (host.totalMemoryMB > 0 && host.totalMemoryMB < 4096) ? LowMemory : LowLatency;
+    }
+    if (profile == GenerationalZgc && tuning.m_javaMajor < 21) {
+        qCInfo(jvmTuning) << "Generational ZGC needs Java 21, runtime is" << tuning.m_javaMajor << "- using G1";
+        profile = LowLatency;
+    }
+    tuning.m_profile = profile;
+
+    // Never hand the heap more than the machine can back
+    qint64 heapMB = qMax(requestedHeapMB, MIN_HEAP_MB);
+    if (host.totalMemoryMB > 0) {
+        const qint64 reserved = qMax(MIN_RESERVED_MB, host.totalMemoryMB / 4);
+        heapMB = qMin(heapMB, qMax<qint64>(MIN_HEAP_MB, host.totalMemoryMB - reserved));
+        if (profile == LowMemory) {
+            heapMB = qMin(heapMB, qMax<qint64>(MIN_HEAP_MB, host.totalMemoryMB / 4));
+        }
+    }
+    tuning.m_heapMB = int(heapMB);
+    if (tuning.m_heapMB != requestedHeapMB) {
+        qCInfo(jvmTuning) << "Heap clamped from" << requestedHeapMB << "to" << tuning.m_heapMB
+                          << "MB for" << host.totalMemoryMB << "MB of RAM";
+    }
+
+    switch (profile) {
+    case Throughput:
+        tuning.buildThroughput(host);
+        break;
+    case GenerationalZgc:
+        tuning.buildGenerationalZgc(host);
+        break;
+    case LowMemory:
+        tuning.buildLowMemory(host);
+        break;
+    case LowLatency:
+    case Auto:
+        tuning.buildLowLatency(host);
+        break;
+    }
+    if (profile != LowMemory) {
+        tuning.addLargePages(host);
+    }
+
+    tuning.m_flags.prepend(QString("-Xms%1m").arg(tuning.m_initialHeapMB));
+    tuning.m_flags.prepend(QString("-Xmx%1m").arg(tuning.m_heapMB));
+    tuning.m_flags = filterFlags(tuning.m_flags, tuning.m_javaMajor, supportedFlags, &tuning.m_rejected);
+    if (!tuning.m_rejected.isEmpty()) {
+        qCInfo(jvmTuning) << "Dropped flags unsupported by Java" << tuning.m_javaMajor << ":" << tuning.m_rejected;
+    }
+    return tuning;
+}
+
+void JvmTuning::buildThroughput(const HostInfo& host)
+{
+    // Fixed-size heap, so no time is spent growing it during world load
+    m_initialHeapMB = m_heapMB;
+    m_flags << "-XX:+UseParallelGC"
+            << QString("-XX:ParallelGCThreads=%1").arg(parallelGcThreads(host.cpuCount));
+}
+
+void JvmTuning::buildLowLatency(const HostInfo& host)
+{
+    const int parallel = parallelGcThreads(host.cpuCount);
+    m_initialHeapMB = m_heapMB / 2;
+    m_flags << "-XX:+UnlockExperimentalVMOptions"
+            << "-XX:+UseG1GC"
+            << "-XX:G1NewSizePercent=20"
+            << "-XX:G1ReservePercent=20"
+            << "-XX:MaxGCPauseMillis=50"
+            << QString("-XX:G1HeapRegionSize=%1M").arg(g1RegionSizeMB(m_heapMB))
+            << QString("-XX:ParallelGCThreads=%1").arg(parallel)
+            << QString("-XX:ConcGCThreads=%1").arg(qMax(1, parallel / 4))
+            << "-XX:+ParallelRefProcEnabled"
+            << "-XX:+DisableExplicitGC";
+}
+
+void JvmTuning::buildGenerationalZgc(const HostInfo& host)
+{
+    m_initialHeapMB = m_heapMB / 2;
+    m_flags << "-XX:+UseZGC"
+            << "-XX:+ZGenerational"
+            << QString("-XX:ConcGCThreads=%1").arg(qMax(1, host.cpuCount / 4))
+            << "-XX:+DisableExplicitGC";
+}
+
+void JvmTuning::buildLowMemory(const HostInfo& host)
+{
+    m_initialHeapMB = qMin(256, m_heapMB);
+    if (m_heapMB <= 1024 || host.cpuCount <= 2) {
+        m_flags << "-XX:+UseSerialGC";
+        return;
+    }
+
+    // G1 that hands unused heap back to the OS
+    m_flags << "-XX:+UseG1GC"
+            << "-XX:MaxGCPauseMillis=100"
+            << QString("-XX:G1HeapRegionSize=%1M").arg(g1RegionSizeMB(m_heapMB))
+            << QString("-XX:ParallelGCThreads=%1").arg(qMax(1, host.cpuCount / 2))
+            << "-XX:+UseStringDeduplication"
+            << "-XX:G1PeriodicGCInterval=15000";
+}
+
+void JvmTuning::addLargePages(const HostInfo& host)
+{
+    const qint64 hugePagesMB = host.hugePagesFree * host.hugePageSizeKB / 1024;
+    if (hugePagesMB >= m_heapMB) {
+        m_flags << "-XX:+UseLargePages";
+    } else if (host.transparentHugePages) {
+        m_flags << "-XX:+UseTransparentHugePages";
+    }
+}
+
+int JvmTuning::g1RegionSizeMB(int heapMB)
+{
+    // G1 aims for about 2048 regions; sizes are powers of two from 1 to 32 MB
+    int region = 1;
+    while (region < 32 && region * 2048 < heapMB) {
+        region *= 2;
+    }
+    return region;
+}
+
+int JvmTuning::parallelGcThreads(int cpuCount)
+{
+    // The JVM's own default, minus one core kept free for the render thread
+    const int threads = cpuCount <= 8 ? cpuCount : 8 + (cpuCount - 8) * 5 / 8;
+    return qMax(1, threads - 1);
+}
+
+QStringList JvmTuning::filterFlags(const QStringList& flags, int javaMajor,
+                                   const QStringList& supportedFlags, QStringList* rejected)
+{
+    const QStringList probed = supportedFlags.isEmpty() ? QStringList() : tunedFlagNames();
+
+    QStringList accepted;
+    accepted.reserve(flags.size());
+    bool unlocked = false;
+    for (const QString& flag : flags) {
+        bool supported = true;
+
+        // The JVM refuses to start on an experimental flag it was not unlocked for
+        for (const char* prefix : EXPERIMENTAL_FLAGS) {
+            if (!unlocked && flag.startsWith(QLatin1String(prefix))) {
+                supported = false;
+            }
+        }
+
+        // A probed runtime's own flag list wins over the table
+        if (!probed.isEmpty() && flag.startsWith(QLatin1String("-XX:"))) {
+            QString name = flag.mid(4).section('=', 0, 0);
+            if (name.startsWith('+') || name.startsWith('-')) {
+                name.remove(0, 1);
+            }
+            if (probed.contains(name) && !supportedFlags.contains(name)) {
+                supported = false;
+            }
+        }
+
+        for (const FlagRequirement& requirement : FLAG_REQUIREMENTS) {
+            if (!flag.startsWith(QLatin1String(requirement.prefix))) {
+                continue;
+            }
+            if (javaMajor < requirement.minJava || (requirement.maxJava > 0 && javaMajor > requirement.maxJava)) {
+                supported = false;
+            }
+#ifndef Q_OS_LINUX
+            if (requirement.linuxOnly) {
+                supported = false;
+            }
+#endif
+        }
+
+        if (supported) {
+            accepted.append(flag);
+            if (flag == QLatin1String("-XX:+UnlockExperimentalVMOptions")) {
+                unlocked = true;
+            }
+        } else if (rejected) {
+            rejected->append(flag);
+        }
+    }
+    return accepted;
+}
+
+QStringList JvmTuning::tunedFlagNames()
+{
+    return {
+        "UnlockExperimentalVMOptions", "UseG1GC", "UseParallelGC", "UseSerialGC", "UseZGC",
+        "ZGenerational", "G1NewSizePercent", "G1ReservePercent", "MaxGCPauseMillis",
+        "G1HeapRegionSize", "ParallelGCThreads", "ConcGCThreads", "ParallelRefProcEnabled",
+        "DisableExplicitGC", "UseStringDeduplication", "G1PeriodicGCInterval",
+        "UseLargePages", "UseTransparentHugePages"
+    };
+}
+
+int JvmTuning::detectJavaMajor(const QString& javaExecutable)
+{
+    // <home>/bin/java -> <home>/release: JAVA_VERSION="21.0.2" or "1.8.0_392"
+    const QDir home = QFileInfo(QFileInfo(javaExecutable).canonicalFilePath()).dir().filePath("..");
+    QFile release(home.filePath("release"));
+    if (!release.open(QIODevice::ReadOnly)) {
+        return 0;
+    }
+
+    while (!release.atEnd()) {
+        const QByteArray line = release.readLine().trimmed();
+        if (!line.startsWith("JAVA_VERSION=")) {
+            continue;
+        }
+        QByteArray version = line.mid(qstrlen("JAVA_VERSION="));
+        version.replace('"', "");
+        const QList<QByteArray> parts = version.split('.');
+        const int first = parts.value(0).toInt();
+        return first == 1 ? parts.value(1).toInt() : first;
+    }
+    return 0;
+}
+
+QString JvmTuning::profileName(Profile profile)
+{
+    switch (profile) {
+    case Auto: return "auto";
+    case Throughput: return "throughput";
+    case LowLatency: return "low-latency";
+    case GenerationalZgc: return "zgc";
+    case LowMemory: return "low-memory";
+    }
+    return "auto";
+}
+
+JvmTuning::Profile JvmTuning::profileFromName(const QString& name)
+{
+    for (int i = Auto; i <= LowMemory; ++i) {
+        if (profileName(Profile(i)) == name) {
+            return Profile(i);
+        }
+    }
+    return Auto;
+}
+
+QStringList JvmTuning::profileNames()
+{
+    QStringList names;
+    for (int i = Auto; i <= LowMemory; ++i) {
+        names.append(profileName(Profile(i)));
+    }
+    return names;
+}
+
+QJsonObject JvmTuning::toJson() const
+{
+    QJsonObject object;
+    object["profile"] = profileName(m_profile);
+    object["javaMajor"] = m_javaMajor;
+    object["heapMB"] = m_heapMB;
+    object["initialHeapMB"] = m_initialHeapMB;
+    object["flags"] = QJsonArray::fromStringList(m_flags);
+    if (!m_rejected.isEmpty()) {
+        object["rejected"] = QJsonArray::fromStringList(m_rejected);
+    }
+    return object;
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QJsonObject>
+
+// What the launcher knows about the machine when sizing the JVM
+struct HostInfo
+{
+    qint64 totalMemoryMB = 0;
+    qint64 availableMemoryMB = 0;
+    int cpuCount = 1;
+    qint64 hugePageSizeKB = 0;   // 0 if the kernel reports none
+    qint64 hugePagesFree = 0;    // preallocated, usable by -XX:+UseLargePages
+    bool transparentHugePages = false;
+
+    // /proc/meminfo on Linux, GlobalMemoryStatusEx on Windows. Cheap
+    // enough to call per launch, so the available figure is current.
+    static HostInfo detect();
+};
+
+// Heap and GC flags for one launch, derived from a profile, the host and the
+// Java runtime's major version. Replaces the fixed G1 defaults.
+class JvmTuning
+{
+public:
+    enum Profile {
+        Auto,
+        Throughput,
+        LowLatency,     // G1 with a short pause target
+        GenerationalZgc, // Java 21+, falls back to LowLatency
+        LowMemory
+    };
+
+    // supportedFlags: names a probe of the runtime reported (JavaRuntime),
+    // empty to rely on the version table alone
+    static JvmTuning compute(Profile profile, int requestedHeapMB, int javaMajor,
+                             const QStringList& supportedFlags = QStringList(),
+                             const HostInfo& host = HostInfo::detect());
+
+    // Major version from <java home>/release, 0 if it cannot be read
+    static int detectJavaMajor(const QString& javaExecutable);
+
+    static QString profileName(Profile profile);
+    static Profile profileFromName(const QString& name);
+    static QStringList profileNames();
+
+    // Drops flags the given runtime or OS would refuse to start with
+    static QStringList filterFlags(const QStringList& flags, int javaMajor,
+                                   const QStringList& supportedFlags = QStringList(),
+                                   QStringList* rejected = nullptr);
+
+    // -XX option names any profile may emit, for probing a runtime
+    static QStringList tunedFlagNames();
+
+    Profile profile() const { return m_profile; }
+    int javaMajor() const { return m_javaMajor; }
+    int heapMB() const { return m_heapMB; }
+    QStringList flags() const { return m_flags; }
+    QStringList rejectedFlags() const { return m_rejected; }
+
+    QJsonObject toJson() const;
+
+private:
+    void buildThroughput(const HostInfo& host);
+    void buildLowLatency(const HostInfo& host);
+    void buildGenerationalZgc(const HostInfo& host);
+    void buildLowMemory(const HostInfo& host);
+    void addLargePages(const HostInfo& host);
+
+    static int g1RegionSizeMB(int heapMB);
+    static int parallelGcThreads(int cpuCount);
+
+    Profile m_profile = Auto;
+    int m_javaMajor = 8;
+    int m_heapMB = 2048;
+    int m_initialHeapMB = 1024;
+    QStringList m_flags;
+    QStringList m_rejected;
+};
\ No newline at end of file
@@ -0,0 +1,253 @@
+#include "LaunchMetrics.h"
+#include <QStandardPaths>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QVariantMap>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QLoggingCategory>
+
+Q_LOGGING_CATEGORY(launchMetrics, "cryovex.launcher.metrics")
+
+namespace {
+
+struct Milestone {
+    const char* name;
+    const char* marker;
+};
+
+// Lines the vanilla client logs on its way to the title screen
+const Milestone MILESTONES[] = {
+    { "lwjgl", "Backend library: LWJGL" },
+    { "soundEngine", "Sound engine started" },
+    { "resourceReload", "Reloading ResourceManager" },
+};
+
+const char* const LAST_MILESTONE = "resourceReload";
+
+}
+
+LaunchMetrics::LaunchMetrics(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void LaunchMetrics::begin(const QString& versionId)
+{
+    for (PhaseTiming& phase : m_phases) {
+        // Phases recorded ahead of the click belong to this launch
+        if (phase.start >= 0) {
+            phase = PhaseTiming();
+        }
+    }
+    m_milestones.clear();
+    m_details = QJsonObject();
+    m_versionId = versionId;
+    m_success = false;
+    m_active = true;
+    m_startedAt = QDateTime::currentDateTimeUtc();
+    m_timer.start();
+    emit timelineChanged();
+}
+
+void LaunchMetrics::beginPhase(Phase phase)
+{
+    if (!m_active) {
+        return;
+    }
+    // Keep time recorded before the click, e.g. a verify pass by the installer
+    m_phases[phase].carried = qMax<qint64>(m_phases[phase].duration, 0);
+    m_phases[phase].start = m_timer.elapsed();
+    m_phases[phase].duration = -1;
+}
+
+void LaunchMetrics::endPhase(Phase phase)
+{
+    if (!m_active || m_phases[phase].start < 0) {
+        return;
+    }
+    m_phases[phase].duration = m_phases[phase].carried + m_timer.elapsed() - m_phases[phase].start;
+    emit timelineChanged();
+}
+
+void LaunchMetrics::recordPhase(Phase phase, qint64 milliseconds)
+{
+    // No start offset: the work happened outside the launch timer
+    PhaseTiming& timing = m_phases[phase];
+    timing.start = -1;
+    timing.duration = qMax<qint64>(timing.duration, 0) + milliseconds;
+    if (m_active) {
+        emit timelineChanged();
+    }
+}
+
+bool LaunchMetrics::scanLine(const QString& line)
+{
+    if (!m_active) {
+        return false;
+    }
+
+    for (const Milestone& milestone : MILESTONES) {
+        if (line.contains(QLatin1String(milestone.marker))) {
+            markMilestone(QString::fromLatin1(milestone.name));
+            return qstrcmp(milestone.name, LAST_MILESTONE) == 0;
+        }
+    }
+    return false;
+}
+
+void LaunchMetrics::markMilestone(const QString& name)
+{
+    if (!m_active) {
+        return;
+    }
+    for (const auto& milestone : std::as_const(m_milestones)) {
+        if (milestone.first == name) {
+            return; // first occurrence only
+        }
+    }
+    m_milestones.append(qMakePair(name, m_timer.elapsed()));
+    emit timelineChanged();
+}
+
+void LaunchMetrics::setDetail(const QString& key, const QJsonValue& value)
+{
+    if (m_active) {
+        m_details.insert(key, value);
+    }
+}
+
+void LaunchMetrics::finish(bool success)
+{
+    if (!m_active) {
+        return;
+    }
+
+    // Close anything still open, e.g. the JVM start of a process that died silently
+    for (int i = 0; i < PhaseCount; ++i) {
+        if (phaseRunning(Phase(i))) {
+            endPhase(Phase(i));
+        }
+    }
+
+    m_success = success;
+    const QJsonObject record = toJson();
+
+    qCInfo(launchMetrics) << "Launch of" << m_versionId << (success ? "completed" : "failed")
+                          << "after" << record["totalMs"].toInteger() << "ms";
+
+    m_lastTimeline = buildTimeline();
+    m_active = false;
+    for (PhaseTiming& phase : m_phases) {
+        phase = PhaseTiming();
+    }
+    m_milestones.clear();
+
+    appendToHistory(record);
+    emit timelineChanged();
+    emit launchRecorded(record);
+}
+
+QJsonObject LaunchMetrics::toJson() const
+{
+    QJsonObject record;
+    record["version"] = m_versionId;
+    record["startedAt"] = m_startedAt.toString(Qt::ISODateWithMs);
+    record["success"] = m_success;
+    record["totalMs"] = elapsed();
+
+    QJsonArray phases;
+    for (int i = 0; i < PhaseCount; ++i) {
+        const PhaseTiming& timing = m_phases[i];
+        if (timing.duration < 0) {
+            continue;
+        }
+        QJsonObject phase;
+        phase["name"] = phaseName(Phase(i));
+        phase["durationMs"] = timing.duration;
+        if (timing.start >= 0) {
+            phase["startMs"] = timing.start;
+        }
+        phases.append(phase);
+    }
+    record["phases"] = phases;
+
+    QJsonArray milestones;
+    for (const auto& milestone : m_milestones) {
+        milestones.append(QJsonObject{{"name", milestone.first}, {"atMs", milestone.second}});
+    }
+    record["milestones"] = milestones;
+
+    for (auto it = m_details.constBegin(); it != m_details.constEnd(); ++it) {
+        record.insert(it.key(), it.value());
+    }
+
+    return record;
+}
+
+QVariantList LaunchMetrics::timeline() const
+{
+    return m_active ? buildTimeline() : m_lastTimeline;
+}
+
+QVariantList LaunchMetrics::buildTimeline() const
+{
+    QVariantList entries;
+    for (int i = 0; i < PhaseCount; ++i) {
+        const PhaseTiming& timing = m_phases[i];
+        if (timing.duration < 0) {
+            continue;
+        }
+        QVariantMap entry;
+        entry["name"] = phaseName(Phase(i));
+        entry["kind"] = "phase";
+        entry["startMs"] = timing.start;
+        entry["durationMs"] = timing.duration;
+        entries.append(entry);
+    }
+    for (const auto& milestone : m_milestones) {
+        QVariantMap entry;
+        entry["name"] = milestone.first;
+        entry["kind"] = "milestone";
+        entry["startMs"] = milestone.second;
+        entry["durationMs"] = 0;
+        entries.append(entry);
+    }
+    return entries;
+}
+
+QString LaunchMetrics::phaseName(Phase phase)
+{
+    switch (phase) {
+    case Validate: return "validate";
+    case Plan: return "plan";
+    case Verify: return "verify";
+    case Download: return "download";
+    case Natives: return "natives";
+    case ArgvBuild: return "argvBuild";
+    case Spawn: return "spawn";
+    case JvmStart: return "jvmStart";
+    case PhaseCount: break;
+    }
+    return QString();
+}
+
+QString LaunchMetrics::historyFilePath()
+{
+    QString appDataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    return QDir(appDataPath).filePath("launch-history.jsonl");
+}
+
+void LaunchMetrics::appendToHistory(const QJsonObject& record) const
+{
+    const QString path = historyFilePath();
+    QDir().mkpath(QFileInfo(path).absolutePath());
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qCWarning(launchMetrics) << "Failed to append launch history:" << file.errorString();
+        return;
+    }
+    file.write(QJsonDocument(record).toJson(QJsonDocument::Compact) + '\n');
+}
\ No newline at end of file
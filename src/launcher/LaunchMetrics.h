@@ -0,0 +1,86 @@
+#pragma once
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QDateTime>
+#include <QJsonObject>
+#include <QVariantList>
+#include <QList>
+#include <QPair>
+
+// Timeline of one launch, from the click on Play to the game window: named
+// phases measured by the launcher plus milestones spotted in the game's
+// stdout. Each finished launch is appended to launch-history.jsonl.
+class LaunchMetrics : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Phase {
+        Validate,
+        Plan,
+        Verify,
+        Download,
+        Natives,
+        ArgvBuild,
+        Spawn,
+        JvmStart,
+        PhaseCount
+    };
+    Q_ENUM(Phase)
+
+    explicit LaunchMetrics(QObject *parent = nullptr);
+
+    void begin(const QString& versionId);
+    void beginPhase(Phase phase);
+    void endPhase(Phase phase);
+    // For phases measured elsewhere, e.g. an install that ran before launchGame()
+    void recordPhase(Phase phase, qint64 milliseconds);
+
+    // Checks one line of game output for a known milestone; true once the
+    // last one (first resource reload) has been seen
+    bool scanLine(const QString& line);
+    void markMilestone(const QString& name);
+
+    // Extra context stored with the record, e.g. the JVM flags in use
+    void setDetail(const QString& key, const QJsonValue& value);
+
+    // Ends the record; success is false if the game never got to a window
+    void finish(bool success);
+
+    bool isActive() const { return m_active; }
+    qint64 elapsed() const { return m_timer.isValid() ? m_timer.elapsed() : 0; }
+    bool hasPhase(Phase phase) const { return m_phases[phase].duration >= 0; }
+    bool phaseRunning(Phase phase) const { return m_phases[phase].start >= 0 && m_phases[phase].duration < 0; }
+
+    QJsonObject toJson() const;
+    // Live timeline while a launch runs, otherwise the last finished one
+    QVariantList timeline() const;
+
+    static QString phaseName(Phase phase);
+    static QString historyFilePath();
+
+signals:
+    void timelineChanged();
+    void launchRecorded(const QJsonObject& record);
+
+private:
+    QVariantList buildTimeline() const;
+    void appendToHistory(const QJsonObject& record) const;
+
+    struct PhaseTiming {
+        qint64 start = -1;
+        qint64 duration = -1;
+        qint64 carried = 0;
+    };
+
+    bool m_active = false;
+    bool m_success = false;
+    QString m_versionId;
+    QDateTime m_startedAt;
+    QElapsedTimer m_timer;
+    PhaseTiming m_phases[PhaseCount];
+    QList<QPair<QString, qint64>> m_milestones;
+    QJsonObject m_details;
+    QVariantList m_lastTimeline;
+};
\ No newline at end of file
@@ -0,0 +1,305 @@
+#include "LaunchPlanCache.h"
+#include "utils/FileStateIndex.h"
+#include <QStandardPaths>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QCryptographicHash>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QDateTime>
+#include <QLoggingCategory>
+
+Q_LOGGING_CATEGORY(launchPlanCache, "cryovex.launcher.plans")
+
+QString LaunchSettings::fingerprint() const
+{
+    return QString("%1|%2|%3|%4").arg(QDir::cleanPath(gameDirectory), javaPath)
+                                 .arg(memoryMB).arg(JvmTuning::profileName(jvmProfile));
+}
+
+LaunchSettings::Verification LaunchSettings::verificationFromName(const QString& name)
+{
+    if (name == "stat") {
+        return VerifyStat;
+    }
+    if (name == "before") {
+        return VerifyBefore;
+    }
+    return VerifyParallel;
+}
+
+QString LaunchPlan::assetIndexPath() const
+{
+    return QDir(variables[ArgumentTemplate::AssetsRoot])
+        .filePath("indexes/" + variables[ArgumentTemplate::AssetsIndexName] + ".json");
+}
+
+LaunchPlanCache& LaunchPlanCache::instance()
+{
+    static LaunchPlanCache instance;
+    return instance;
+}
+
+LaunchPlanCache::LaunchPlanCache(QObject *parent)
+    : QObject(parent)
+{
+    connect(&FileStateIndex::instance(), &FileStateIndex::fileInvalidated,
+            this, &LaunchPlanCache::onFileInvalidated);
+}
+
+void LaunchPlanCache::initialize()
+{
+    QFile file(getCacheFilePath());
+    if (!file.exists()) {
+        return;
+    }
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCWarning(launchPlanCache) << "Failed to open launch plan cache:" << file.errorString();
+        return;
+    }
+
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &error);
+    if (error.error != QJsonParseError::NoError) {
+        qCWarning(launchPlanCache) << "Failed to parse launch plan cache:" << error.errorString();
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    const QJsonObject plans = doc.object();
+    for (auto it = plans.constBegin(); it != plans.constEnd(); ++it) {
+        const QJsonObject entry = it.value().toObject();
+
+        LaunchPlan plan;
+        plan.key = it.key();
+        plan.versionId = entry["versionId"].toString();
+        plan.javaExecutable = entry["java"].toString();
+        plan.workingDirectory = entry["workingDirectory"].toString();
+        for (const QJsonValue& argument : entry["arguments"].toArray()) {
+            plan.arguments.append(argument.toString());
+        }
+
+        const QJsonObject variables = entry["variables"].toObject();
+        for (auto variable = variables.constBegin(); variable != variables.constEnd(); ++variable) {
+            const int index = ArgumentTemplate::variableFromName(variable.key());
+            if (index >= 0) {
+                plan.variables[index] = variable.value().toString();
+            }
+        }
+
+        for (const QJsonValue& value : entry["files"].toArray()) {
+            const QJsonArray pair = value.toArray();
+            plan.files.append(LaunchPlan::CheckedFile{pair.at(0).toString(), pair.at(1).toInteger(-1),
+                                                      pair.at(2).toString()});
+        }
+
+        for (const QJsonValue& value : entry["natives"].toArray()) {
+            const QJsonObject native = value.toObject();
+            NativeJar jar;
+            jar.path = native["path"].toString();
+            jar.sha1 = native["sha1"].toString();
+            for (const QJsonValue& exclude : native["exclude"].toArray()) {
+                jar.exclude.append(exclude.toString());
+            }
+            plan.natives.append(jar);
+        }
+
+        plan.tuning = entry["tuning"].toObject();
+        plan.templates = ArgumentTemplate::compile(plan.arguments);
+        insertLocked(plan);
+    }
+    m_dirty = false;
+
+    qCInfo(launchPlanCache) << "Loaded" << m_plans.size() << "launch plans";
+}
+
+void LaunchPlanCache::save()
+{
+    QJsonObject plans;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_dirty) {
+            return;
+        }
+
+        for (const LaunchPlan& plan : std::as_const(m_plans)) {
+            QJsonObject entry;
+            entry["versionId"] = plan.versionId;
+            entry["java"] = plan.javaExecutable;
+            entry["workingDirectory"] = plan.workingDirectory;
+            entry["arguments"] = QJsonArray::fromStringList(plan.arguments);
+
+            QJsonObject variables;
+            for (int i = 0; i < ArgumentTemplate::VariableCount; ++i) {
+                if (!plan.variables[i].isEmpty()) {
+                    variables[ArgumentTemplate::variableName(ArgumentTemplate::Variable(i))] = plan.variables[i];
+                }
+            }
+            entry["variables"] = variables;
+
+            QJsonArray files;
+            for (const LaunchPlan::CheckedFile& checked : plan.files) {
+                files.append(QJsonArray{checked.path, checked.size, checked.sha1});
+            }
+            entry["files"] = files;
+
+            QJsonArray natives;
+            for (const NativeJar& jar : plan.natives) {
+                QJsonObject native;
+                native["path"] = jar.path;
+                native["sha1"] = jar.sha1;
+                native["exclude"] = QJsonArray::fromStringList(jar.exclude);
+                natives.append(native);
+            }
+            entry["natives"] = natives;
+            entry["tuning"] = plan.tuning;
+
+            plans.insert(plan.key, entry);
+        }
+        m_dirty = false;
+    }
+
+    const QString cachePath = getCacheFilePath();
+    QDir().mkpath(QFileInfo(cachePath).absolutePath());
+
+    QFile file(cachePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(launchPlanCache) << "Failed to save launch plan cache:" << file.errorString();
+        return;
+    }
+
+    file.write(QJsonDocument(plans).toJson(QJsonDocument::Compact));
+}
+
+QString LaunchPlanCache::planKey(const QString& manifestKey, const LaunchSettings& settings,
+                                 const QString& javaIdentity)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(manifestKey.toUtf8());
+    hash.addData("\n");
+    hash.addData(settings.fingerprint().toUtf8());
+    hash.addData("\n");
+    hash.addData(javaIdentity.toUtf8());
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+QString LaunchPlanCache::javaIdentity(const QString& javaPath, QString* executable)
+{
+    QString resolved = javaPath;
+    if (!QFileInfo(javaPath).isAbsolute()) {
+        resolved = QStandardPaths::findExecutable(javaPath);
+    }
+
+    const QFileInfo info(resolved);
+    if (!info.exists()) {
+        if (executable) *executable = QString();
+        return QString();
+    }
+
+    const QString canonical = info.canonicalFilePath();
+    if (executable) *executable = canonical;
+    return QString("%1|%2|%3").arg(canonical).arg(info.size()).arg(info.lastModified().toMSecsSinceEpoch());
+}
+
+bool LaunchPlanCache::lookup(const QString& key, LaunchPlan* plan)
+{
+    LaunchPlan cached;
+    {
+        QMutexLocker locker(&m_mutex);
+        auto it = m_plans.constFind(key);
+        if (it == m_plans.constEnd()) {
+            return false;
+        }
+        cached = it.value();
+    }
+
+    // Stat only: anything deeper is the FileStateIndex's job
+    if (!filesUnchanged(cached)) {
+        qCInfo(launchPlanCache) << "Launch plan for" << cached.versionId << "is stale, rebuilding";
+        invalidate(key);
+        return false;
+    }
+
+    if (plan) {
+        *plan = cached;
+    }
+    return true;
+}
+
+void LaunchPlanCache::insert(const LaunchPlan& plan)
+{
+    QMutexLocker locker(&m_mutex);
+    removeLocked(plan.key);
+    insertLocked(plan);
+    m_dirty = true;
+}
+
+void LaunchPlanCache::invalidate(const QString& key)
+{
+    QMutexLocker locker(&m_mutex);
+    removeLocked(key);
+}
+
+void LaunchPlanCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_plans.clear();
+    m_plansByFile.clear();
+    m_dirty = true;
+}
+
+void LaunchPlanCache::onFileInvalidated(const QString& filePath)
+{
+    QMutexLocker locker(&m_mutex);
+    const QStringList keys = m_plansByFile.values(filePath);
+    for (const QString& key : keys) {
+        qCInfo(launchPlanCache) << "Dropping launch plan, file changed:" << filePath;
+        removeLocked(key);
+    }
+}
+
+void LaunchPlanCache::insertLocked(const LaunchPlan& plan)
+{
+    m_plans.insert(plan.key, plan);
+    for (const LaunchPlan::CheckedFile& checked : plan.files) {
+        m_plansByFile.insert(checked.path, plan.key);
+    }
+}
+
+void LaunchPlanCache::removeLocked(const QString& key)
+{
+    auto it = m_plans.find(key);
+    if (it == m_plans.end()) {
+        return;
+    }
+
+    for (const LaunchPlan::CheckedFile& checked : it->files) {
+        m_plansByFile.remove(checked.path, key);
+    }
+    m_plans.erase(it);
+    m_dirty = true;
+}
+
+bool LaunchPlanCache::filesUnchanged(const LaunchPlan& plan)
+{
+    if (!QFileInfo::exists(plan.javaExecutable)) {
+        return false;
+    }
+
+    for (const LaunchPlan::CheckedFile& checked : plan.files) {
+        const QFileInfo info(checked.path);
+        if (!info.exists() || (checked.size >= 0 && info.size() != checked.size)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+QString LaunchPlanCache::getCacheFilePath() const
+{
+    QString appDataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    return QDir(appDataPath).filePath("cache/launch-plans.json");
+}
\ No newline at end of file
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <QObject>
+#include <QHash>
+#include <QMutex>
+#include <QStringList>
+#include "ArgumentTemplate.h"
+#include "JvmTuning.h"
+#include "ProcessPlacement.h"
+#include "utils/NativesCache.h"
+
+// Profile settings that shape the command line
+struct LaunchSettings
+{
+    enum Verification {
+        VerifyStat,    // sizes only, as the plan lookup does
+        VerifyBefore,  // hash the classpath before spawning
+        VerifyParallel // trusted plans boot while the hashes are checked
+    };
+
+    QString gameDirectory;
+    QString javaPath = "java";
+    int memoryMB = 2048;
+    JvmTuning::Profile jvmProfile = JvmTuning::Auto;
+    bool appCds = true; // per launch, not part of the fingerprint
+    ProcessPlacement placement; // likewise
+    Verification verification = VerifyParallel; // likewise
+    bool detach = false; // likewise; the game outlives the launcher
+
+    QString fingerprint() const;
+    static Verification verificationFromName(const QString& name);
+};
+
+// Everything needed to spawn a version, resolved ahead of time. Only the
+// account variables are filled in per launch.
+struct LaunchPlan
+{
+    struct CheckedFile {
+        QString path;
+        qint64 size = -1;
+        QString sha1; // empty for files generated locally
+    };
+
+    QString key;
+    QString versionId;
+    QString javaExecutable;
+    QString workingDirectory;
+    QStringList arguments;                 // argv after java, rules applied, placeholders kept
+    ArgumentTemplate::Variables variables; // all but the auth_* / clientid values
+    QList<CheckedFile> files;              // must be unchanged for the plan to stay valid
+    QList<NativeJar> natives;              // linked into a fresh directory per launch
+    QJsonObject tuning;                    // JvmTuning::toJson() of the heap/GC flags
+
+    QVector<ArgumentTemplate> templates;   // tokenised arguments, not persisted
+
+    QString classpath() const { return variables[ArgumentTemplate::Classpath]; }
+    QString assetIndexPath() const;
+    bool isValid() const { return !key.isEmpty(); }
+};
+
+// Fully resolved launch plans keyed by manifest, profile settings and Java
+// runtime. A plan is dropped as soon as one of the files it relies on is
+// invalidated in the FileStateIndex or no longer matches on disk.
+class LaunchPlanCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    static LaunchPlanCache& instance();
+
+    void initialize();
+    void save();
+
+    static QString planKey(const QString& manifestKey, const LaunchSettings& settings,
+                           const QString& javaIdentity);
+
+    // Resolved executable plus size/mtime, so a Java update changes the key
+    static QString javaIdentity(const QString& javaPath, QString* executable = nullptr);
+
+    bool lookup(const QString& key, LaunchPlan* plan);
+    void insert(const LaunchPlan& plan);
+    void invalidate(const QString& key);
+    void clear();
+
+private slots:
+    void onFileInvalidated(const QString& filePath);
+
+private:
+    explicit LaunchPlanCache(QObject *parent = nullptr);
+    ~LaunchPlanCache() = default;
+
+    void insertLocked(const LaunchPlan& plan);
+    void removeLocked(const QString& key);
+    static bool filesUnchanged(const LaunchPlan& plan);
+    QString getCacheFilePath() const;
+
+    QMutex m_mutex;
+    QHash<QString, LaunchPlan> m_plans;
+    QMultiHash<QString, QString> m_plansByFile; // file path -> plan keys
+    bool m_dirty = false;
+};
\ No newline at end of file
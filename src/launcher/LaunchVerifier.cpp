@@ -0,0 +1,203 @@
+#include "LaunchVerifier.h"
+#include "utils/FileStateIndex.h"
+#include "utils/FileUtils.h"
+#include "utils/BackgroundGovernor.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QSemaphore>
+#include <QVector>
+#include <QElapsedTimer>
+#include <QLoggingCategory>
+
+Q_LOGGING_CATEGORY(launchVerifier, "cryovex.launcher.verifier")
+
+namespace {
+
+const int BATCH_SIZE = 32;
+
+}
+
+QJsonObject LaunchVerifier::Result::toJson() const
+{
+    QJsonObject json;
+    json["passed"] = passed();
+    json["filesChecked"] = filesChecked;
+    json["filesHashed"] = filesHashed;
+    json["hashedBytes"] = hashedBytes;
+    json["elapsedMs"] = elapsedMs;
+    json["failed"] = QJsonArray::fromStringList(failed);
+    if (cancelled) {
+        json["cancelled"] = true;
+    }
+    return json;
+}
+
+LaunchVerifier::LaunchVerifier(QObject *parent)
+    : QObject(parent)
+{
+    m_coordinator.setMaxThreadCount(1);
+    BackgroundGovernor::instance().registerPool(&m_pool);
+}
+
+LaunchVerifier::~LaunchVerifier()
+{
+    for (const CancelFlag& cancelled : std::as_const(m_running)) {
+        *cancelled = true;
+    }
+    m_coordinator.waitForDone();
+    m_pool.waitForDone();
+}
+
+bool LaunchVerifier::isTrusted(const LaunchPlan& plan)
+{
+    FileStateIndex& index = FileStateIndex::instance();
+    for (const LaunchPlan::CheckedFile& file : plan.files) {
+        if (!file.sha1.isEmpty() && !index.isVerified(QFileInfo(file.path), file.sha1)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+LaunchVerifier::Result LaunchVerifier::verify(const LaunchPlan& plan, bool includeAssets)
+{
+    return run(plan, includeAssets, CancelFlag::create(false));
+}
+
+int LaunchVerifier::verifyAsync(const LaunchPlan& plan, bool includeAssets)
+{
+    const int ticket = m_nextTicket++;
+    const CancelFlag cancelled = CancelFlag::create(false);
+    m_running.insert(ticket, cancelled);
+
+    m_coordinator.start([this, plan, includeAssets, ticket, cancelled]() {
+        const Result result = run(plan, includeAssets, cancelled);
+        QMetaObject::invokeMethod(this, [this, ticket, result]() {
+            if (m_running.remove(ticket)) {
+                emit finished(ticket, result);
+            }
+        }, Qt::QueuedConnection);
+    });
+    return ticket;
+}
+
+void LaunchVerifier::cancel(int ticket)
+{
+    if (CancelFlag cancelled = m_running.take(ticket)) {
+        *cancelled = true;
+    }
+}
+
+QList<LaunchVerifier::Item> LaunchVerifier::collectItems(const LaunchPlan& plan, bool includeAssets)
+{
+    QList<Item> items;
+    for (const LaunchPlan::CheckedFile& file : plan.files) {
+        items.append(Item{file.path, file.size, file.sha1, true});
+    }
+    if (!includeAssets) {
+        return items;
+    }
+
+    // Objects are named by their sha1
+    const QString indexPath = plan.assetIndexPath();
+    QFile file(indexPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return items;
+    }
+    const QJsonObject objects = QJsonDocument::fromJson(file.readAll()).object()["objects"].toObject();
+    const QString objectsDirectory = plan.variables[ArgumentTemplate::AssetsRoot] + "/objects/";
+    items.reserve(items.size() + objects.size());
+    for (auto it = objects.constBegin(); it != objects.constEnd(); ++it) {
+        const QJsonObject object = it.value().toObject();
+        const QString hash = object["hash"].toString();
+        if (hash.size() < 2) {
+            continue;
+        }
+        items.append(Item{objectsDirectory + hash.left(2) + "/" + hash,
+                          object["size"].toInteger(-1), hash, false});
+    }
+    return items;
+}
+
+bool LaunchVerifier::checkItem(const Item& item, bool* hashed)
+{
+    QFileInfo info(item.path);
+    if (!info.exists() || (item.size >= 0 && info.size() != item.size)) {
+        return false;
+    }
+    if (item.sha1.isEmpty()) {
+        return true;
+    }
+
+    FileStateIndex& index = FileStateIndex::instance();
+    if (!item.always && index.isVerified(info, item.sha1)) {
+        return true;
+    }
+
+    *hashed = true;
+    if (!FileUtils::verifySha1(item.path, item.sha1)) {
+        index.invalidate(item.path);
+        return false;
+    }
+    index.recordVerified(info, item.sha1);
+    return true;
+}
+
+LaunchVerifier::Result LaunchVerifier::run(const LaunchPlan& plan, bool includeAssets, const CancelFlag& cancelled)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    Result result;
+    result.versionId = plan.versionId;
+
+    const QList<Item> items = collectItems(plan, includeAssets);
+    const int count = items.size();
+    QVector<char> failedFlags(count, 0);
+    char* flags = failedFlags.data();
+    const Item* data = items.constData();
+    std::atomic<int> filesHashed{0};
+    std::atomic<qint64> hashedBytes{0};
+
+    // Each batch writes only its own flags
+    QSemaphore done;
+    int batches = 0;
+    for (int begin = 0; begin < count; begin += BATCH_SIZE, ++batches) {
+        const int end = qMin(begin + BATCH_SIZE, count);
+        m_pool.start([flags, data, begin, end, cancelled, &done, &filesHashed, &hashedBytes]() {
+            BackgroundGovernor::applyThreadPriority();
+            for (int i = begin; i < end && !*cancelled; ++i) {
+                bool hashed = false;
+                flags[i] = checkItem(data[i], &hashed) ? 0 : 1;
+                if (hashed) {
+                    ++filesHashed;
+                    hashedBytes += qMax<qint64>(0, data[i].size);
+                }
+            }
+            done.release();
+        });
+    }
+    done.acquire(batches);
+
+    for (int i = 0; i < count; ++i) {
+        if (flags[i]) {
+            result.failed.append(items.at(i).path);
+        }
+    }
+    result.filesChecked = count;
+    result.filesHashed = filesHashed;
+    result.hashedBytes = hashedBytes;
+    result.cancelled = *cancelled;
+    result.elapsedMs = timer.elapsed();
+
+    if (!result.failed.isEmpty()) {
+        qCWarning(launchVerifier) << result.failed.size() << "files of" << plan.versionId << "failed verification, first:"
+                                  << result.failed.first();
+    }
+    qCInfo(launchVerifier) << "Verified" << count << "files of" << plan.versionId << "in" << result.elapsedMs << "ms,"
+                           << result.filesHashed << "hashed";
+    return result;
+}
\ No newline at end of file
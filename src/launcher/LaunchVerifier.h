@@ -0,0 +1,69 @@
+#pragma once
+
+#include <QObject>
+#include <QThreadPool>
+#include <QHash>
+#include <QSharedPointer>
+#include <QStringList>
+#include <QJsonObject>
+#include <atomic>
+#include "LaunchPlanCache.h"
+
+// Checks the files a launch plan relies on against their sha1s on a worker
+// pool. Classpath jars and natives are always hashed; assets only when they
+// changed since their last check, as there are thousands of them. A plan
+// whose files all passed before and are unchanged on disk is trusted, and
+// can boot while the check runs instead of waiting for it.
+class LaunchVerifier : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Result {
+        QString versionId;
+        int filesChecked = 0;
+        int filesHashed = 0;
+        qint64 hashedBytes = 0;
+        qint64 elapsedMs = 0;
+        QStringList failed; // missing, wrong size or wrong sha1
+        bool cancelled = false;
+
+        bool passed() const { return !cancelled && failed.isEmpty(); }
+        QJsonObject toJson() const;
+    };
+
+    explicit LaunchVerifier(QObject *parent = nullptr);
+    ~LaunchVerifier();
+
+    // Stat only: every file with a known sha1 is unchanged since it last passed
+    static bool isTrusted(const LaunchPlan& plan);
+
+    // Blocks until done, using the pool. Without includeAssets only the
+    // plan's own files are checked, e.g. while assets are still downloading.
+    Result verify(const LaunchPlan& plan, bool includeAssets = true);
+    // Returns a ticket; the result arrives through finished()
+    int verifyAsync(const LaunchPlan& plan, bool includeAssets = true);
+    void cancel(int ticket);
+
+signals:
+    void finished(int ticket, const LaunchVerifier::Result& result);
+
+private:
+    struct Item {
+        QString path;
+        qint64 size = -1;
+        QString sha1;
+        bool always = true; // hash even if recorded as verified
+    };
+
+    using CancelFlag = QSharedPointer<std::atomic<bool>>;
+
+    static QList<Item> collectItems(const LaunchPlan& plan, bool includeAssets);
+    static bool checkItem(const Item& item, bool* hashed);
+    Result run(const LaunchPlan& plan, bool includeAssets, const CancelFlag& cancelled);
+
+    QThreadPool m_pool;        // hashing
+    QThreadPool m_coordinator; // one task per asynchronous verification
+    QHash<int, CancelFlag> m_running;
+    int m_nextTicket = 1;
+};
\ No newline at end of file
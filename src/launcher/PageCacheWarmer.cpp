@@ -0,0 +1,238 @@
+#include "PageCacheWarmer.h"
+#include "ProcessPlacement.h"
+#include "utils/AssetClassifier.h"
+#include "utils/BackgroundGovernor.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QJsonDocument>
+#include <QElapsedTimer>
+#include <QLoggingCategory>
+#include <vector>
+
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+Q_LOGGING_CATEGORY(pageCache, "cryovex.launcher.pagecache")
+
+namespace {
+
+#ifdef Q_OS_LINUX
+// Only affects the calling thread, i.e. the warmer's worker
+void setIdleIoPriority()
+{
+    if (!ProcessPlacement::setIoPriority(ProcessPlacement::IoIdle, 0)) {
+        qCDebug(pageCache) << "Could not lower I/O priority, warming at normal priority";
+    }
+}
+
+qint64 residentBytes(int fd, qint64 size, std::vector<unsigned char>& pages)
+{
+    void* map = mmap(nullptr, size_t(size), PROT_READ, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        return 0;
+    }
+
+    const qint64 pageSize = sysconf(_SC_PAGESIZE);
+    const size_t count = size_t((size + pageSize - 1) / pageSize);
+    pages.resize(count);
+
+    qint64 resident = 0;
+    if (mincore(map, size_t(size), pages.data()) == 0) {
+        for (size_t i = 0; i < count; ++i) {
+            if (pages[i] & 1) {
+                resident += pageSize;
+            }
+        }
+    }
+    munmap(map, size_t(size));
+    return qMin(resident, size);
+}
+#endif
+
+}
+
+QJsonObject PageCacheWarmer::Result::toJson() const
+{
+    QJsonObject object;
+    object["files"] = files;
+    object["totalBytes"] = totalBytes;
+    object["residentBytes"] = residentBytes;
+    object["elapsedMs"] = elapsedMs;
+    if (cancelled) {
+        object["cancelled"] = true;
+    }
+    return object;
+}
+
+PageCacheWarmer::PageCacheWarmer(QObject *parent)
+    : QObject(parent)
+{
+    // One reader is enough to keep an idle-class queue busy
+    m_pool.setMaxThreadCount(1);
+
+    // A game reading its own files comes first
+    connect(&BackgroundGovernor::instance(), &BackgroundGovernor::throttledChanged, this, [this](bool throttled) {
+        if (throttled) {
+            cancel();
+        }
+    });
+}
+
+PageCacheWarmer::~PageCacheWarmer()
+{
+    cancel();
+    m_pool.waitForDone();
+}
+
+bool PageCacheWarmer::isSupported()
+{
+#ifdef Q_OS_LINUX
+    return true;
+#else
+    return false;
+#endif
+}
+
+void PageCacheWarmer::warm(const QString& versionId, const QStringList& files, const QString& assetIndexPath)
+{
+    if (!isSupported()) {
+        return;
+    }
+    if (BackgroundGovernor::instance().isThrottled()) {
+        qCDebug(pageCache) << "Game running, not warming" << versionId;
+        return;
+    }
+
+    // A new generation also cancels whatever the worker is still reading
+    const int generation = ++m_generation;
+    if (m_pending++ == 0) {
+        emit runningChanged();
+    }
+
+    m_pool.start([this, versionId, files, assetIndexPath, generation]() {
+        const Result result = run(versionId, files, assetIndexPath, generation);
+        QMetaObject::invokeMethod(this, [this, result]() {
+            deliver(result);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void PageCacheWarmer::cancel()
+{
+    ++m_generation;
+}
+
+void PageCacheWarmer::deliver(const Result& result)
+{
+    m_lastResult = result;
+    qCInfo(pageCache) << (result.cancelled ? "Cancelled warmup of" : "Warmed") << result.versionId << ":"
+                      << result.files << "files," << result.totalBytes / (1024 * 1024) << "MB,"
+                      << result.residentBytes / (1024 * 1024) << "MB already resident, in"
+                      << result.elapsedMs << "ms";
+
+    emit finished(result);
+    if (--m_pending == 0) {
+        emit runningChanged();
+    }
+}
+
+PageCacheWarmer::Result PageCacheWarmer::run(const QString& versionId, QStringList files,
+                                             const QString& assetIndexPath, int generation)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    Result result;
+    result.versionId = versionId;
+
+#ifdef Q_OS_LINUX
+    setIdleIoPriority();
+
+    if (!assetIndexPath.isEmpty() && !isCancelled(generation)) {
+        files += hotAssets(assetIndexPath);
+    }
+
+    std::vector<unsigned char> pages;
+    for (const QString& path : std::as_const(files)) {
+        if (isCancelled(generation)) {
+            result.cancelled = true;
+            break;
+        }
+
+        const int fd = ::open(QFile::encodeName(path).constData(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            continue;
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+            const qint64 size = st.st_size;
+            const qint64 resident = residentBytes(fd, size, pages);
+            ++result.files;
+            result.totalBytes += size;
+            result.residentBytes += resident;
+
+            // readahead() returns once the reads are queued, so chunks keep cancellation prompt
+            for (qint64 offset = 0; resident < size && offset < size; offset += CHUNK_BYTES) {
+                if (isCancelled(generation)) {
+                    result.cancelled = true;
+                    break;
+                }
+                const size_t length = size_t(qMin(CHUNK_BYTES, size - offset));
+                if (::readahead(fd, offset, length) != 0) {
+                    // Not every filesystem implements readahead()
+                    ::posix_fadvise(fd, offset, off_t(length), POSIX_FADV_WILLNEED);
+                }
+            }
+        }
+        ::close(fd);
+    }
+#else
+    Q_UNUSED(files)
+    Q_UNUSED(assetIndexPath)
+    Q_UNUSED(generation)
+#endif
+
+    result.elapsedMs = timer.elapsed();
+    return result;
+}
+
+QStringList PageCacheWarmer::hotAssets(const QString& assetIndexPath)
+{
+    QStringList files;
+
+    QFile file(assetIndexPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return files;
+    }
+
+    QJsonParseError error;
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &error);
+    if (error.error != QJsonParseError::NoError) {
+        qCWarning(pageCache) << "Failed to parse asset index:" << error.errorString();
+        return files;
+    }
+
+    // <assets>/indexes/<id>.json -> <assets>/objects
+    QDir assetsDirectory = QFileInfo(assetIndexPath).dir();
+    assetsDirectory.cdUp();
+    const QString objectsDirectory = assetsDirectory.filePath("objects");
+    const QString systemLanguage = AssetClassifier::systemLanguage();
+
+    const QJsonObject objects = doc.object()["objects"].toObject();
+    for (auto it = objects.constBegin(); it != objects.constEnd(); ++it) {
+        if (!AssetClassifier::isNeededAtStartup(it.key(), systemLanguage)) {
+            continue;
+        }
+        const QString hash = it.value().toObject()["hash"].toString();
+        if (!hash.isEmpty()) {
+            files.append(objectsDirectory + "/" + hash.left(2) + "/" + hash);
+        }
+    }
+    return files;
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <QObject>
+#include <QJsonObject>
+#include <QStringList>
+#include <QThreadPool>
+#include <atomic>
+
+// Pulls the files a launch is about to read into the page cache while the
+// player is still on the main screen, so a cold start does not stall on
+// major faults. Runs on one worker thread at idle I/O priority and stops
+// between chunks when cancelled, or when a game starts. Linux only;
+// elsewhere it does nothing.
+class PageCacheWarmer : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(bool isRunning READ isRunning NOTIFY runningChanged)
+
+public:
+    struct Result {
+        QString versionId;
+        int files = 0;
+        qint64 totalBytes = 0;
+        qint64 residentBytes = 0; // already cached before the warmup, per mincore()
+        qint64 elapsedMs = 0;
+        bool cancelled = false;
+
+        QJsonObject toJson() const;
+    };
+
+    explicit PageCacheWarmer(QObject *parent = nullptr);
+    ~PageCacheWarmer();
+
+    // Replaces any warmup in progress. Hot objects are picked from the asset
+    // index on the worker, so the index is never parsed on the GUI thread.
+    void warm(const QString& versionId, const QStringList& files, const QString& assetIndexPath = QString());
+    Q_INVOKABLE void cancel();
+
+    bool isRunning() const { return m_pending > 0; }
+    Result lastResult() const { return m_lastResult; }
+
+    // Objects the game reads while loading: everything but sounds, music and
+    // languages other than en_us and the system locale
+    static QStringList hotAssets(const QString& assetIndexPath);
+
+    static bool isSupported();
+
+signals:
+    void runningChanged();
+    void finished(const PageCacheWarmer::Result& result);
+
+private:
+    Result run(const QString& versionId, QStringList files, const QString& assetIndexPath, int generation);
+    bool isCancelled(int generation) const { return m_generation.load() != generation; }
+    void deliver(const Result& result);
+
+    static constexpr qint64 CHUNK_BYTES = 4 * 1024 * 1024;
+
+    QThreadPool m_pool;
+    std::atomic<int> m_generation{0};
+    int m_pending = 0;
+    Result m_lastResult;
+};
\ No newline at end of file
@@ -0,0 +1,300 @@
+#include "ProcessPlacement.h"
+#include <QFile>
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonValue>
+#include <QLoggingCategory>
+
+#ifdef Q_OS_UNIX
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+#ifdef Q_OS_LINUX
+#include <sys/syscall.h>
+#endif
+
+Q_LOGGING_CATEGORY(processPlacement, "cryovex.launcher.placement")
+
+namespace {
+
+const int BACKGROUND_NICE = 10;
+
+#ifdef Q_OS_LINUX
+const int CPU_PERIOD_US = 100000;
+
+// From <linux/ioprio.h>, which glibc does not wrap
+const int IOPRIO_WHO_PROCESS = 1;
+const int IOPRIO_CLASS_BE = 2;
+const int IOPRIO_CLASS_IDLE = 3;
+const int IOPRIO_CLASS_SHIFT = 13;
+
+const char* CGROUP_ROOT = "/sys/fs/cgroup";
+
+// Our own cgroup v2 path, e.g. "/user.slice/user-1000.slice/user@1000.service/app.slice/x.scope"
+QString ownCgroup()
+{
+    QFile file("/proc/self/cgroup");
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QString();
+    }
+    for (const QByteArray& line : file.readAll().split('\n')) {
+        if (line.startsWith("0::")) {
+            return QString::fromUtf8(line.mid(3)).trimmed();
+        }
+    }
+    return QString(); // v1 only
+}
+
+bool writeControl(const QString& path, const QByteArray& value)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Unbuffered)) {
+        return false;
+    }
+    return file.write(value) == value.size();
+}
+#endif
+
+}
+
+bool ProcessPlacement::isDefault() const
+{
+    return cpus.trimmed().isEmpty() && !background && ioClass == IoDefault && !wantsCgroup();
+}
+
+QJsonObject ProcessPlacement::toJson() const
+{
+    QJsonObject json;
+    json["cpus"] = cpus;
+    json["background"] = background;
+    json["ioClass"] = ioClassName(ioClass);
+    json["ioLevel"] = ioLevel;
+    json["memoryLimitMB"] = memoryLimitMB;
+    json["cpuLimitPercent"] = cpuLimitPercent;
+    return json;
+}
+
+ProcessPlacement ProcessPlacement::fromJson(const QJsonObject& json)
+{
+    ProcessPlacement placement;
+    placement.cpus = json["cpus"].toString();
+    placement.background = json["background"].toBool();
+    placement.ioClass = ioClassFromName(json["ioClass"].toString());
+    placement.ioLevel = qBound(0, json["ioLevel"].toInt(placement.ioLevel), 7);
+    placement.memoryLimitMB = qMax(0, json["memoryLimitMB"].toInt());
+    placement.cpuLimitPercent = qMax(0, json["cpuLimitPercent"].toInt());
+    return placement;
+}
+
+QList<int> ProcessPlacement::parseCpuList(const QString& list)
+{
+    QList<int> result;
+    for (const QString& part : list.split(',', Qt::SkipEmptyParts)) {
+        const QStringList range = part.trimmed().split('-');
+        bool firstOk = false;
+        bool lastOk = true;
+        const int first = range.at(0).toInt(&firstOk);
+        const int last = range.size() == 2 ? range.at(1).toInt(&lastOk) : first;
+        if (range.size() > 2 || !firstOk || !lastOk || first < 0 || last < first) {
+            return QList<int>();
+        }
+        for (int cpu = first; cpu <= last; ++cpu) {
+            if (!result.contains(cpu)) {
+                result.append(cpu);
+            }
+        }
+    }
+    return result;
+}
+
+QString ProcessPlacement::ioClassName(IoClass ioClass)
+{
+    switch (ioClass) {
+    case IoBestEffort:
+        return "best-effort";
+    case IoIdle:
+        return "idle";
+    case IoDefault:
+        break;
+    }
+    return "default";
+}
+
+ProcessPlacement::IoClass ProcessPlacement::ioClassFromName(const QString& name)
+{
+    if (name == "best-effort") {
+        return IoBestEffort;
+    }
+    if (name == "idle") {
+        return IoIdle;
+    }
+    return IoDefault;
+}
+
+bool ProcessPlacement::setIoPriority(IoClass ioClass, int level)
+{
+#ifdef Q_OS_LINUX
+    int value = 0; // IOPRIO_CLASS_NONE: follow the CPU nice level
+    if (ioClass == IoBestEffort) {
+        value = (IOPRIO_CLASS_BE << IOPRIO_CLASS_SHIFT) | level;
+    } else if (ioClass == IoIdle) {
+        value = IOPRIO_CLASS_IDLE << IOPRIO_CLASS_SHIFT;
+    }
+    return syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, 0, value) == 0;
+#else
+    Q_UNUSED(ioClass)
+    Q_UNUSED(level)
+    return false;
+#endif
+}
+
+PreparedPlacement PreparedPlacement::prepare(const ProcessPlacement& placement, const QString& cgroupName)
+{
+    PreparedPlacement prepared;
+    prepared.m_background = placement.background;
+    prepared.m_ioClass = placement.ioClass;
+    prepared.m_ioLevel = placement.ioLevel;
+
+#ifdef Q_OS_LINUX
+    CPU_ZERO(&prepared.m_cpus);
+    if (!placement.cpus.trimmed().isEmpty()) {
+        const QList<int> cpus = ProcessPlacement::parseCpuList(placement.cpus);
+        for (int cpu : cpus) {
+            if (cpu < CPU_SETSIZE) {
+                CPU_SET(cpu, &prepared.m_cpus);
+            }
+        }
+        // An empty mask would make sched_setaffinity() fail in the child anyway
+        prepared.m_setAffinity = CPU_COUNT(&prepared.m_cpus) > 0;
+        if (!prepared.m_setAffinity) {
+            qCWarning(processPlacement) << "Ignoring CPU list" << placement.cpus;
+        }
+    }
+
+    if (placement.wantsCgroup() && !prepared.setupCgroup(placement, cgroupName)) {
+        qCWarning(processPlacement) << "No writable cgroup v2 hierarchy, running without resource limits";
+    }
+#else
+    Q_UNUSED(cgroupName)
+#endif
+    return prepared;
+}
+
+bool PreparedPlacement::isEmpty() const
+{
+    return !m_setAffinity && !m_background && m_ioClass == ProcessPlacement::IoDefault && m_cgroupProcsFd < 0;
+}
+
+bool PreparedPlacement::setupCgroup(const ProcessPlacement& placement, const QString& name)
+{
+#ifdef Q_OS_LINUX
+    const QString own = ownCgroup();
+    if (own.isEmpty()) {
+        return false;
+    }
+
+    // Our own cgroup holds the launcher, and a cgroup with processes cannot
+    // hand controllers to children, so the game goes next to it. Under a
+    // systemd user session that is the delegated app.slice.
+    QString parent = QDir::cleanPath(QString(CGROUP_ROOT) + own);
+    if (own != "/") {
+        parent = QFileInfo(parent).path();
+    }
+    if (::access(QFile::encodeName(parent + "/cgroup.procs").constData(), W_OK) != 0) {
+        return false;
+    }
+
+    QByteArray enable;
+    if (placement.memoryLimitMB > 0) {
+        enable += "+memory ";
+    }
+    if (placement.cpuLimitPercent > 0) {
+        enable += "+cpu";
+    }
+    // Usually already on; fails harmlessly when a sibling holds processes
+    writeControl(parent + "/cgroup.subtree_control", enable.trimmed());
+
+    const QString path = parent + "/cryovex-" + name;
+    if (!QDir().mkpath(path)) {
+        return false;
+    }
+    m_cgroupPath = path;
+
+    if (placement.memoryLimitMB > 0
+        && !writeControl(path + "/memory.max", QByteArray::number(qint64(placement.memoryLimitMB) * 1024 * 1024))) {
+        qCWarning(processPlacement) << "Memory controller not available in" << parent;
+    }
+    if (placement.cpuLimitPercent > 0) {
+        const qint64 quota = qint64(placement.cpuLimitPercent) * CPU_PERIOD_US / 100;
+        if (!writeControl(path + "/cpu.max", QByteArray::number(quota) + ' ' + QByteArray::number(CPU_PERIOD_US))) {
+            qCWarning(processPlacement) << "CPU controller not available in" << parent;
+        }
+    }
+
+    // Closed on exec; the child writes itself in before that
+    m_cgroupProcsFd = ::open(QFile::encodeName(path + "/cgroup.procs").constData(), O_WRONLY | O_CLOEXEC);
+    if (m_cgroupProcsFd < 0) {
+        removeCgroup();
+        return false;
+    }
+    qCInfo(processPlacement) << "Game will run in cgroup" << path;
+    return true;
+#else
+    Q_UNUSED(placement)
+    Q_UNUSED(name)
+    return false;
+#endif
+}
+
+void PreparedPlacement::applyInChild() const
+{
+    // Between fork and exec: system calls only, no allocation, no locks.
+    // Failures leave the game with the launcher's placement.
+#ifdef Q_OS_LINUX
+    if (m_cgroupProcsFd >= 0) {
+        // "0" means the writing process
+        [[maybe_unused]] ssize_t written = ::write(m_cgroupProcsFd, "0", 1);
+    }
+    if (m_setAffinity) {
+        sched_setaffinity(0, sizeof(m_cpus), &m_cpus);
+    }
+    if (m_background) {
+        // Keeps the nice level; only the wakeup preemption changes
+        sched_param param = {};
+        sched_setscheduler(0, SCHED_BATCH, &param);
+    }
+    if (m_ioClass != ProcessPlacement::IoDefault) {
+        ProcessPlacement::setIoPriority(m_ioClass, m_ioLevel);
+    }
+#endif
+#ifdef Q_OS_UNIX
+    if (m_background) {
+        setpriority(PRIO_PROCESS, 0, BACKGROUND_NICE);
+    }
+#endif
+}
+
+void PreparedPlacement::closeDescriptors()
+{
+#ifdef Q_OS_UNIX
+    if (m_cgroupProcsFd >= 0) {
+        ::close(m_cgroupProcsFd);
+        m_cgroupProcsFd = -1;
+    }
+#endif
+}
+
+void PreparedPlacement::removeCgroup()
+{
+    closeDescriptors();
+    if (m_cgroupPath.isEmpty()) {
+        return;
+    }
+#ifdef Q_OS_UNIX
+    if (::rmdir(QFile::encodeName(m_cgroupPath).constData()) != 0) {
+        qCDebug(processPlacement) << "Cgroup" << m_cgroupPath << "still populated, leaving it";
+    }
+#endif
+    m_cgroupPath.clear();
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <QString>
+#include <QList>
+#include <QJsonObject>
+
+#ifdef Q_OS_LINUX
+#include <sched.h>
+#endif
+
+// Where and how a game process runs: the CPUs it may use, its scheduling
+// and I/O class, and optional cgroup v2 limits. Stored per profile.
+struct ProcessPlacement
+{
+    enum IoClass {
+        IoDefault,    // inherit the launcher's
+        IoBestEffort, // with ioLevel 0 (first) .. 7 (last)
+        IoIdle        // only when nobody else uses the disk
+    };
+
+    QString cpus;             // affinity list like "0-7,16"; empty = all CPUs
+    bool background = false;  // nice 10 and SCHED_BATCH
+    IoClass ioClass = IoDefault;
+    int ioLevel = 4;
+    int memoryLimitMB = 0;    // cgroup memory.max, 0 = no limit
+    int cpuLimitPercent = 0;  // cgroup cpu.max, 100 = one core, 0 = no limit
+
+    bool isDefault() const;
+    bool wantsCgroup() const { return memoryLimitMB > 0 || cpuLimitPercent > 0; }
+
+    QJsonObject toJson() const;
+    static ProcessPlacement fromJson(const QJsonObject& json);
+
+    // "0-3,8" -> 0 1 2 3 8; empty on a malformed list
+    static QList<int> parseCpuList(const QString& list);
+    static QString ioClassName(IoClass ioClass);
+    static IoClass ioClassFromName(const QString& name);
+
+    // ioprio_set() for the calling thread; async-signal-safe
+    static bool setIoPriority(IoClass ioClass, int level);
+};
+
+// A placement resolved before spawning: the CPU mask parsed and the cgroup
+// created with its cgroup.procs opened, so that applyInChild() - which runs
+// between fork and exec - makes only async-signal-safe system calls.
+class PreparedPlacement
+{
+public:
+    // cgroupName must be unique among running games
+    static PreparedPlacement prepare(const ProcessPlacement& placement, const QString& cgroupName);
+
+    bool isEmpty() const;
+    QString cgroupPath() const { return m_cgroupPath; }
+
+    void applyInChild() const;
+    // Parent side, once the child has exec'd or failed to
+    void closeDescriptors();
+    // Once the process has exited; a populated cgroup cannot be removed
+    void removeCgroup();
+
+private:
+    bool setupCgroup(const ProcessPlacement& placement, const QString& name);
+
+#ifdef Q_OS_LINUX
+    cpu_set_t m_cpus;
+#endif
+    bool m_setAffinity = false;
+    bool m_background = false;
+    ProcessPlacement::IoClass m_ioClass = ProcessPlacement::IoDefault;
+    int m_ioLevel = 4;
+    int m_cgroupProcsFd = -1;
+    QString m_cgroupPath;
+};
\ No newline at end of file
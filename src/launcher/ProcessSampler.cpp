@@ -0,0 +1,393 @@
+#include "ProcessSampler.h"
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QLoggingCategory>
+#include <cstdio>
+#include <cstring>
+
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+Q_LOGGING_CATEGORY(processSampler, "cryovex.launcher.sampler")
+
+namespace {
+
+// Parses the unsigned number at p, leaving p just past it
+qint64 parseNumber(const char*& p)
+{
+    while (*p == ' ' || *p == '\t') {
+        ++p;
+    }
+    qint64 value = 0;
+    while (*p >= '0' && *p <= '9') {
+        value = value * 10 + (*p - '0');
+        ++p;
+    }
+    return value;
+}
+
+// Value of a "Key:   123 kB" line; key includes the leading newline and colon
+qint64 parseKeyedValue(const char* buffer, const char* key)
+{
+    const char* p = std::strstr(buffer, key);
+    if (!p) {
+        return 0;
+    }
+    p += std::strlen(key);
+    return parseNumber(p);
+}
+
+// Fields of /proc/<pid>/stat we need, counted as in proc(5)
+const int STAT_MAJFLT = 12;
+const int STAT_UTIME = 14;
+const int STAT_STIME = 15;
+const int STAT_NUM_THREADS = 20;
+
+}
+
+QVariantMap ProcessSample::toVariant() const
+{
+    QVariantMap map;
+    map["timestamp"] = timestampMs;
+    map["cpuPercent"] = cpuPercent;
+    map["cpuMs"] = cpuMs;
+    map["rss"] = rssBytes;
+    map["peakRss"] = peakRssBytes;
+    map["threads"] = threads;
+    map["processes"] = processes;
+    map["majorFaults"] = majorFaults;
+    map["majorFaultRate"] = majorFaultsPerSecond;
+    map["readRate"] = readBytesPerSecond;
+    map["writeRate"] = writeBytesPerSecond;
+    return map;
+}
+
+ProcessSampler::ProcessSampler(QObject *parent)
+    : QObject(parent)
+    , m_timer(new QTimer(this))
+{
+    m_timer->setInterval(m_intervalMs);
+    connect(m_timer, &QTimer::timeout, this, &ProcessSampler::sampleAll);
+    m_clock.start();
+
+#ifdef Q_OS_LINUX
+    m_pageSize = sysconf(_SC_PAGESIZE);
+    m_ticksPerSecond = sysconf(_SC_CLK_TCK);
+#endif
+}
+
+ProcessSampler::~ProcessSampler()
+{
+    for (Tree& tree : m_trees) {
+        for (ProcFiles& files : tree.processes) {
+            closeFiles(files);
+        }
+    }
+}
+
+bool ProcessSampler::isSupported()
+{
+#ifdef Q_OS_LINUX
+    return true;
+#else
+    return false;
+#endif
+}
+
+void ProcessSampler::setIntervalMs(int intervalMs)
+{
+    m_intervalMs = qMax(0, intervalMs);
+    if (m_intervalMs > 0) {
+        m_timer->setInterval(m_intervalMs);
+    }
+    updateTimer();
+}
+
+void ProcessSampler::track(qint64 pid)
+{
+    if (!isSupported() || pid <= 0 || m_trees.contains(pid)) {
+        return;
+    }
+
+    ProcFiles root;
+    if (!openFiles(pid, &root)) {
+        qCWarning(processSampler) << "Cannot sample process" << pid;
+        return;
+    }
+
+    // Everything a sample touches is allocated here, not per sample
+    Tree tree;
+    tree.processes.reserve(8);
+    tree.processes.append(root);
+    tree.ring.resize(HISTORY_SIZE);
+    m_trees.insert(pid, tree);
+    updateTimer();
+}
+
+void ProcessSampler::untrack(qint64 pid)
+{
+    auto it = m_trees.find(pid);
+    if (it == m_trees.end()) {
+        return;
+    }
+    for (ProcFiles& files : it->processes) {
+        closeFiles(files);
+    }
+    m_trees.erase(it);
+    updateTimer();
+}
+
+ProcessSample ProcessSampler::latest(qint64 pid) const
+{
+    auto it = m_trees.constFind(pid);
+    if (it == m_trees.constEnd() || it->count == 0) {
+        return ProcessSample();
+    }
+    return it->ring.at((it->head + HISTORY_SIZE - 1) % HISTORY_SIZE);
+}
+
+QVector<ProcessSample> ProcessSampler::history(qint64 pid) const
+{
+    QVector<ProcessSample> samples;
+    auto it = m_trees.constFind(pid);
+    if (it == m_trees.constEnd()) {
+        return samples;
+    }
+    samples.reserve(it->count);
+    const int oldest = (it->head + HISTORY_SIZE - it->count) % HISTORY_SIZE;
+    for (int i = 0; i < it->count; ++i) {
+        samples.append(it->ring.at((oldest + i) % HISTORY_SIZE));
+    }
+    return samples;
+}
+
+void ProcessSampler::updateTimer()
+{
+    if (m_intervalMs > 0 && !m_trees.isEmpty()) {
+        if (!m_timer->isActive()) {
+            m_timer->start();
+        }
+    } else {
+        m_timer->stop();
+    }
+}
+
+void ProcessSampler::sampleAll()
+{
+    const qint64 now = m_clock.elapsed();
+    for (auto it = m_trees.begin(); it != m_trees.end(); ++it) {
+        sampleTree(it.value(), now);
+    }
+    emit sampled();
+}
+
+void ProcessSampler::sampleTree(Tree& tree, qint64 monotonicMs)
+{
+    if (tree.processes.isEmpty()) {
+        return;
+    }
+
+    bool membershipChanged = false;
+    if (--tree.samplesSinceScan < 0) {
+        const int before = tree.processes.size();
+        scanChildren(tree);
+        membershipChanged = tree.processes.size() != before;
+        tree.samplesSinceScan = CHILD_SCAN_INTERVAL;
+    }
+
+    ProcessSample sample;
+    Counters counters;
+    for (int i = 0; i < tree.processes.size(); ) {
+        if (readProcess(tree.processes.at(i), i == 0, &counters, &sample)) {
+            ++sample.processes;
+            ++i;
+        } else if (i == 0) {
+            // Exited; the owner untracks it once QProcess reports the exit
+            return;
+        } else {
+            closeFiles(tree.processes[i]);
+            tree.processes.remove(i);
+            membershipChanged = true;
+        }
+    }
+
+    sample.timestampMs = QDateTime::currentMSecsSinceEpoch();
+    sample.cpuMs = counters.ticks * 1000 / m_ticksPerSecond;
+    sample.majorFaults = counters.majorFaults;
+
+    // Rates need the same set of processes on both ends; otherwise keep the last ones
+    const qint64 elapsedMs = monotonicMs - tree.previousMs;
+    if (tree.previousMs >= 0 && elapsedMs > 0 && !membershipChanged) {
+        const double seconds = elapsedMs / 1000.0;
+        sample.cpuPercent = qMax<qint64>(0, counters.ticks - tree.previous.ticks) * 100.0 / m_ticksPerSecond / seconds;
+        sample.majorFaultsPerSecond = qMax<qint64>(0, counters.majorFaults - tree.previous.majorFaults) / seconds;
+        sample.readBytesPerSecond = qMax<qint64>(0, counters.readBytes - tree.previous.readBytes) / seconds;
+        sample.writeBytesPerSecond = qMax<qint64>(0, counters.writeBytes - tree.previous.writeBytes) / seconds;
+    } else if (tree.count > 0) {
+        const ProcessSample& last = tree.ring.at((tree.head + HISTORY_SIZE - 1) % HISTORY_SIZE);
+        sample.cpuPercent = last.cpuPercent;
+        sample.majorFaultsPerSecond = last.majorFaultsPerSecond;
+        sample.readBytesPerSecond = last.readBytesPerSecond;
+        sample.writeBytesPerSecond = last.writeBytesPerSecond;
+    }
+    tree.previous = counters;
+    tree.previousMs = monotonicMs;
+
+    tree.ring[tree.head] = sample;
+    tree.head = (tree.head + 1) % HISTORY_SIZE;
+    tree.count = qMin(tree.count + 1, HISTORY_SIZE);
+}
+
+bool ProcessSampler::readProcess(const ProcFiles& files, bool root, Counters* counters, ProcessSample* sample)
+{
+    // The command name is parenthesised and may contain spaces, so count from the last ')'
+    if (readFile(files.stat) <= 0) {
+        return false;
+    }
+    const char* p = std::strrchr(m_buffer, ')');
+    if (!p) {
+        return false;
+    }
+    p += 2; // ") "
+    while (*p && *p != ' ') {
+        ++p; // state
+    }
+
+    qint64 majorFaults = 0;
+    qint64 ticks = 0;
+    int threads = 0;
+    for (int field = 4; field <= STAT_NUM_THREADS && *p; ++field) {
+        const qint64 value = parseNumber(++p);
+        if (field == STAT_MAJFLT) {
+            majorFaults = value;
+        } else if (field == STAT_UTIME || field == STAT_STIME) {
+            ticks += value;
+        } else if (field == STAT_NUM_THREADS) {
+            threads = int(value);
+        }
+        while (*p && *p != ' ') {
+            ++p; // negative values, e.g. priority
+        }
+    }
+
+    counters->ticks += ticks;
+    counters->majorFaults += majorFaults;
+    sample->threads += threads;
+
+    // statm: size resident shared ... in pages
+    if (readFile(files.statm) > 0) {
+        const char* statm = m_buffer;
+        parseNumber(statm);
+        sample->rssBytes += parseNumber(statm) * m_pageSize;
+    }
+
+    if (root && readFile(files.status) > 0) {
+        sample->peakRssBytes = parseKeyedValue(m_buffer, "\nVmHWM:") * 1024;
+    }
+
+    // Bytes that actually hit storage, not page cache reads
+    if (readFile(files.io) > 0) {
+        counters->readBytes += parseKeyedValue(m_buffer, "\nread_bytes:");
+        counters->writeBytes += parseKeyedValue(m_buffer, "\nwrite_bytes:");
+    }
+
+    return true;
+}
+
+void ProcessSampler::scanChildren(Tree& tree)
+{
+#ifdef Q_OS_LINUX
+    // Children are listed per thread, and the JVM forks from whichever thread
+    // asked. The list grows while scanning, so grandchildren are found too.
+    for (int i = 0; i < tree.processes.size(); ++i) {
+        const QString taskDirectory = QString("/proc/%1/task").arg(tree.processes.at(i).pid);
+        const QStringList tasks = QDir(taskDirectory).entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+        for (const QString& task : tasks) {
+            QFile file(taskDirectory + "/" + task + "/children");
+            if (!file.open(QIODevice::ReadOnly)) {
+                continue;
+            }
+            for (const QByteArray& token : file.readAll().split(' ')) {
+                const qint64 child = token.trimmed().toLongLong();
+                if (child <= 0) {
+                    continue;
+                }
+                bool known = false;
+                for (const ProcFiles& files : std::as_const(tree.processes)) {
+                    if (files.pid == child) {
+                        known = true;
+                        break;
+                    }
+                }
+                ProcFiles files;
+                if (!known && openFiles(child, &files)) {
+                    tree.processes.append(files);
+                }
+            }
+        }
+    }
+#else
+    Q_UNUSED(tree)
+#endif
+}
+
+int ProcessSampler::readFile(int fd)
+{
+#ifdef Q_OS_LINUX
+    if (fd < 0) {
+        return -1;
+    }
+    // /proc files regenerate on every read from offset 0
+    const ssize_t length = pread(fd, m_buffer, sizeof(m_buffer) - 1, 0);
+    if (length < 0) {
+        return -1;
+    }
+    m_buffer[length] = '\0';
+    return int(length);
+#else
+    Q_UNUSED(fd)
+    return -1;
+#endif
+}
+
+bool ProcessSampler::openFiles(qint64 pid, ProcFiles* files)
+{
+#ifdef Q_OS_LINUX
+    char path[64];
+    auto openProc = [&path, pid](const char* name) {
+        std::snprintf(path, sizeof(path), "/proc/%lld/%s", static_cast<long long>(pid), name);
+        return ::open(path, O_RDONLY | O_CLOEXEC);
+    };
+
+    files->pid = pid;
+    files->stat = openProc("stat");
+    if (files->stat < 0) {
+        return false;
+    }
+    files->statm = openProc("statm");
+    files->status = openProc("status");
+    files->io = openProc("io");
+    return true;
+#else
+    Q_UNUSED(pid)
+    Q_UNUSED(files)
+    return false;
+#endif
+}
+
+void ProcessSampler::closeFiles(ProcFiles& files)
+{
+#ifdef Q_OS_LINUX
+    for (int* fd : {&files.stat, &files.statm, &files.status, &files.io}) {
+        if (*fd >= 0) {
+            ::close(*fd);
+            *fd = -1;
+        }
+    }
+#else
+    Q_UNUSED(files)
+#endif
+}
\ No newline at end of file
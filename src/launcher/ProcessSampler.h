@@ -0,0 +1,106 @@
+#pragma once
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QVector>
+#include <QVariantMap>
+
+// One reading of a process and its children
+struct ProcessSample
+{
+    qint64 timestampMs = 0;          // ms since epoch
+    double cpuPercent = 0;           // 100 = one core busy
+    qint64 cpuMs = 0;                // user + system time so far
+    qint64 rssBytes = 0;
+    qint64 peakRssBytes = 0;         // VmHWM of the root process
+    int threads = 0;
+    int processes = 0;
+    qint64 majorFaults = 0;          // so far
+    double majorFaultsPerSecond = 0;
+    double readBytesPerSecond = 0;   // storage I/O
+    double writeBytesPerSecond = 0;
+
+    QVariantMap toVariant() const;
+};
+
+// Samples CPU, memory, threads, major faults and I/O of game processes and
+// their children from /proc/<pid>/{stat,statm,status,io}. Every file is
+// opened once and re-read with pread() into a fixed buffer, and history
+// rings are allocated when a process is tracked, so a sample is a handful
+// of syscalls and no allocations. One timer serves all tracked processes
+// and only runs while there are any. Linux only.
+class ProcessSampler : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ProcessSampler(QObject *parent = nullptr);
+    ~ProcessSampler();
+
+    static bool isSupported();
+
+    int intervalMs() const { return m_intervalMs; }
+    // 0 stops sampling
+    void setIntervalMs(int intervalMs);
+
+    void track(qint64 pid);
+    void untrack(qint64 pid);
+    bool isTracked(qint64 pid) const { return m_trees.contains(pid); }
+
+    ProcessSample latest(qint64 pid) const;
+    // Oldest first
+    QVector<ProcessSample> history(qint64 pid) const;
+
+signals:
+    void sampled();
+
+private slots:
+    void sampleAll();
+
+private:
+    struct ProcFiles {
+        qint64 pid = 0;
+        int stat = -1;
+        int statm = -1;
+        int status = -1;
+        int io = -1; // needs ptrace access, may stay closed
+    };
+
+    struct Counters {
+        qint64 ticks = 0;
+        qint64 majorFaults = 0;
+        qint64 readBytes = 0;
+        qint64 writeBytes = 0;
+    };
+
+    struct Tree {
+        QVector<ProcFiles> processes; // [0] is the tracked process
+        Counters previous;
+        qint64 previousMs = -1;       // monotonic
+        QVector<ProcessSample> ring;
+        int head = 0;                 // next slot to write
+        int count = 0;
+        int samplesSinceScan = 0;
+    };
+
+    void updateTimer();
+    void sampleTree(Tree& tree, qint64 monotonicMs);
+    bool readProcess(const ProcFiles& files, bool root, Counters* counters, ProcessSample* sample);
+    void scanChildren(Tree& tree);
+    int readFile(int fd);
+    static bool openFiles(qint64 pid, ProcFiles* files);
+    static void closeFiles(ProcFiles& files);
+
+    static constexpr int HISTORY_SIZE = 300;
+    static const int CHILD_SCAN_INTERVAL = 10; // samples between child lookups
+
+    QTimer* m_timer;
+    QElapsedTimer m_clock;
+    QHash<qint64, Tree> m_trees;
+    int m_intervalMs = 1000;
+    qint64 m_pageSize = 4096;
+    qint64 m_ticksPerSecond = 100;
+    char m_buffer[4096];
+};
\ No newline at end of file
@@ -0,0 +1,166 @@
+#include "ProcessSpawn.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QVector>
+#include <QLoggingCategory>
+#include <algorithm>
+
+Q_LOGGING_CATEGORY(processSpawn, "cryovex.launcher.spawn")
+
+namespace {
+
+// Argument file syntax: quoted, with backslash escapes as the java launcher reads them
+QString quoteArgument(const QString& argument)
+{
+    QString quoted;
+    quoted.reserve(argument.size() + 2);
+    quoted += '"';
+    for (const QChar c : argument) {
+        if (c == '\\' || c == '"') {
+            quoted += '\\';
+            quoted += c;
+        } else if (c == '\n') {
+            quoted += "\\n";
+        } else if (c == '\r') {
+            quoted += "\\r";
+        } else if (c == '\t') {
+            quoted += "\\t";
+        } else {
+            quoted += c;
+        }
+    }
+    quoted += '"';
+    return quoted;
+}
+
+// VmRSS and VmPTE: how much a fork() of this process has to copy
+QString memoryFootprint()
+{
+#ifdef Q_OS_LINUX
+    QFile file("/proc/self/status");
+    if (file.open(QIODevice::ReadOnly)) {
+        QStringList parts;
+        for (const QByteArray& line : file.readAll().split('\n')) {
+            if (line.startsWith("VmRSS:") || line.startsWith("VmPTE:")) {
+                parts << QString::fromLatin1(line.simplified());
+            }
+        }
+        return parts.join(", ");
+    }
+#endif
+    return QString();
+}
+
+}
+
+void ProcessSpawn::configure(QProcess* process)
+{
+#if defined(Q_OS_UNIX) && QT_VERSION >= QT_VERSION_CHECK(6, 7, 0)
+    QProcess::UnixProcessParameters parameters = process->unixProcessParameters();
+    parameters.flags |= QProcess::UnixProcessFlag::UseVFork;
+    process->setUnixProcessParameters(parameters);
+#else
+    Q_UNUSED(process)
+#endif
+}
+
+bool ProcessSpawn::usesVFork()
+{
+#if defined(Q_OS_UNIX) && QT_VERSION >= QT_VERSION_CHECK(6, 7, 0)
+    return true;
+#else
+    return false;
+#endif
+}
+
+QStringList ProcessSpawn::withArgumentFile(const QStringList& arguments, int mainClassIndex, const QString& path)
+{
+    if (mainClassIndex < 0 || mainClassIndex >= arguments.size()) {
+        return arguments;
+    }
+
+    qsizetype length = 0;
+    for (const QString& argument : arguments) {
+        length += argument.size() + 1;
+    }
+    if (length <= ARGUMENT_FILE_THRESHOLD) {
+        return arguments;
+    }
+
+    QString content;
+    content.reserve(length + 3 * (mainClassIndex + 1));
+    for (int i = 0; i <= mainClassIndex; ++i) {
+        content += quoteArgument(arguments.at(i));
+        content += '\n';
+    }
+
+    // The java launcher reads argument files in the platform encoding
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(content.toLocal8Bit()) < 0) {
+        qCWarning(processSpawn) << "Cannot write argument file" << path << ", passing arguments directly";
+        return arguments;
+    }
+
+    QStringList result;
+    result.reserve(arguments.size() - mainClassIndex);
+    result << "@" + QDir::toNativeSeparators(path);
+    result << arguments.mid(mainClassIndex + 1);
+    return result;
+}
+
+void ProcessSpawn::runBenchmark(const QString& label, int iterations)
+{
+#ifdef Q_OS_WIN
+    const QString program = "cmd.exe";
+    const QStringList arguments = {"/c", "exit"};
+#else
+    const QString program = QFileInfo::exists("/bin/true") ? "/bin/true" : "/usr/bin/true";
+    const QStringList arguments;
+#endif
+
+    auto measure = [&](bool vfork) {
+        QVector<qint64> samples;
+        samples.reserve(iterations);
+        QElapsedTimer timer;
+        for (int i = 0; i < iterations; ++i) {
+            QProcess process;
+            process.setProgram(program);
+            process.setArguments(arguments);
+            if (vfork) {
+                configure(&process);
+            }
+            timer.start();
+            process.start();
+            if (!process.waitForFinished(5000)) {
+                qCWarning(processSpawn) << "Benchmark child did not finish:" << process.errorString();
+                return QVector<qint64>();
+            }
+            samples.append(timer.nsecsElapsed());
+        }
+        std::sort(samples.begin(), samples.end());
+        return samples;
+    };
+
+    qCInfo(processSpawn) << "Spawn latency" << label << "," << iterations << "runs of" << program;
+    const QString footprint = memoryFootprint();
+    if (!footprint.isEmpty()) {
+        qCInfo(processSpawn) << "  launcher:" << footprint;
+    }
+
+    auto report = [](const char* name, const QVector<qint64>& samples) {
+        if (samples.isEmpty()) {
+            return;
+        }
+        qCInfo(processSpawn) << "  " << name << ": median" << samples.at(samples.size() / 2) / 1000 << "us, p90"
+                             << samples.at(samples.size() * 9 / 10) / 1000 << "us";
+    };
+    report("default", measure(false));
+    if (usesVFork()) {
+        report("vfork", measure(true));
+    } else {
+        qCInfo(processSpawn) << "  vfork: needs Qt 6.7 on Unix";
+    }
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <QProcess>
+#include <QStringList>
+
+// Starting children from a launcher whose address space carries QML and
+// WebEngine. With fork() every game launch and Java probe copies the page
+// tables of all of that; with vfork() the child borrows them until exec.
+class ProcessSpawn
+{
+public:
+    // Command lines longer than this, in characters, use an argument file
+    static const int ARGUMENT_FILE_THRESHOLD = 8 * 1024;
+
+    // Starts the process with vfork semantics where Qt supports it (6.7+).
+    // A child process modifier must then only make system calls.
+    static void configure(QProcess* process);
+    static bool usesVFork();
+
+    // Moves everything up to and including the main class into an argument
+    // file at path, returning "@path" followed by the game arguments, which
+    // keeps the session token out of the file. Needs Java 9+. Returns the
+    // arguments unchanged when they are short or the file cannot be written.
+    static QStringList withArgumentFile(const QStringList& arguments, int mainClassIndex, const QString& path);
+
+    // Start-to-exit latency of a trivial child, with and without vfork
+    static void runBenchmark(const QString& label, int iterations = 200);
+};
\ No newline at end of file
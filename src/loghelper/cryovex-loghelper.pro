@@ -0,0 +1,25 @@
+# Log-capture helper for detached games; qmake builds it separately:
+#   qmake src/loghelper/cryovex-loghelper.pro && make
+QT = core
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = cryovex-loghelper
+TEMPLATE = app
+
+# Next to the launcher, where it looks for the helper
+DESTDIR = $$PWD/../../build
+OBJECTS_DIR = $$PWD/../../build/obj/loghelper
+MOC_DIR = $$PWD/../../build/moc/loghelper
+
+INCLUDEPATH += $$PWD/..
+
+SOURCES += \
+    main.cpp \
+    ../utils/RotatingLogFile.cpp \
+    ../utils/DetachedGameState.cpp
+
+HEADERS += \
+    ../utils/RotatingLogFile.h \
+    ../utils/DetachedGameState.h
\ No newline at end of file
@@ -0,0 +1,105 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QProcess>
+#include <QDir>
+#include "utils/RotatingLogFile.h"
+#include "utils/DetachedGameState.h"
+
+#ifdef Q_OS_UNIX
+#include <csignal>
+#include <unistd.h>
+#endif
+
+// cryovex-loghelper: runs one game on behalf of a launcher that may exit
+// before it does. The game's output goes into its rotating log, its pid and
+// exit status into a DetachedGameState file. Qt Core only, so it stays small.
+int main(int argc, char *argv[])
+{
+#ifdef Q_OS_UNIX
+    // A session of our own: the launcher's terminal or process group going away leaves the game alone
+    setsid();
+    signal(SIGHUP, SIG_IGN);
+#endif
+
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("cryovex-loghelper");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Runs a game, capturing its output and exit status for the Cryovex Launcher.");
+    parser.addHelpOption();
+    parser.addOption({"state", "State file to maintain.", "file"});
+    parser.addOption({"log", "Log file for the game's output.", "file"});
+    parser.addOption({"version", "Version id recorded in the state file.", "id"});
+    parser.addOption({"cleanup", "Directory to remove once the game has exited.", "directory"});
+    parser.addPositionalArgument("command", "Game program and its arguments, after --.", "-- program [arguments...]");
+    parser.process(app);
+
+    const QStringList command = parser.positionalArguments();
+    const QString statePath = parser.value("state");
+    const QString logPath = parser.value("log");
+    if (command.isEmpty() || statePath.isEmpty() || logPath.isEmpty()) {
+        parser.showHelp(2);
+    }
+    const QString cleanupDirectory = parser.value("cleanup");
+
+    // The log first: once the state file exists, the launcher reads the log
+    RotatingLogFile log;
+    log.open(logPath);
+
+    DetachedGameState state;
+    state.versionId = parser.value("version");
+    state.logFile = logPath;
+    state.helperPid = QCoreApplication::applicationPid();
+    state.helperStartTime = DetachedGameState::processStartTime(state.helperPid);
+    state.startedAt = QDateTime::currentDateTimeUtc();
+    state.save(statePath);
+
+    // Flushed per read so the launcher can follow the file
+    QProcess game;
+    game.setProcessChannelMode(QProcess::MergedChannels);
+    game.setProgram(command.first());
+    game.setArguments(command.mid(1));
+    QObject::connect(&game, &QProcess::readyReadStandardOutput, &app, [&]() {
+        log.write(game.readAllStandardOutput());
+        log.flush();
+    });
+    QObject::connect(&game, &QProcess::started, &app, [&]() {
+        state.phase = DetachedGameState::Running;
+        state.gamePid = game.processId();
+        state.gameStartTime = DetachedGameState::processStartTime(state.gamePid);
+        state.save(statePath);
+    });
+
+    bool ended = false;
+    auto end = [&](int exitCode, bool crashed, const QString& error) {
+        if (ended) {
+            return;
+        }
+        ended = true;
+        log.write(game.readAllStandardOutput());
+        log.close();
+        if (!cleanupDirectory.isEmpty()) {
+            QDir(cleanupDirectory).removeRecursively();
+        }
+
+        state.phase = DetachedGameState::Ended;
+        state.endedAt = QDateTime::currentDateTimeUtc();
+        state.exitCode = exitCode;
+        state.crashed = crashed;
+        state.error = error;
+        state.save(statePath);
+        QMetaObject::invokeMethod(&app, &QCoreApplication::quit, Qt::QueuedConnection);
+    };
+    QObject::connect(&game, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), &app,
+                     [&](int exitCode, QProcess::ExitStatus exitStatus) {
+        end(exitCode, exitStatus != QProcess::NormalExit || exitCode != 0, QString());
+    });
+    QObject::connect(&game, &QProcess::errorOccurred, &app, [&](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart) {
+            end(-1, true, game.errorString());
+        }
+    });
+
+    game.start();
+    return app.exec();
+}
\ No newline at end of file
@@ -8,11 +8,29 @@
 #include <QLoggingCategory>
 #include <QFile>
 #include <QTextStream>
+#include <QEventLoop>
+#include <QWebEngineView>
 
 // Module headers
 #include "auth/AuthManager.h"
+#include "auth/MicrosoftAuth.h"
 #include "config/ConfigManager.h"
+#include "version/VersionManager.h"
+#include "version/ManifestCache.h"
+#include "download/DownloadManager.h"
+#include "download/InstallPlanner.h"
+#include "download/AssetIndexStreamer.h"
 #include "utils/Logger.h"
+#include "utils/FileStateIndex.h"
+#include "utils/BackgroundGovernor.h"
+#include "launcher/ArgumentTemplate.h"
+#include "launcher/GameLauncher.h"
+#include "launcher/LaunchPlanCache.h"
+#include "launcher/JavaRuntimeDiscovery.h"
+#include "launcher/AppCdsManager.h"
+#include "launcher/ProcessSpawn.h"
+#include "launcher/ProcessPlacement.h"
+#include "InGameMode.h"
 
 Q_LOGGING_CATEGORY(appMain, "cryovex.main")
 
@@ -109,6 +127,35 @@ int main(int argc, char *argv[])
     
     qCInfo(appMain) << "Starting Cryovex Launcher v1.0.0";
     
+    // Micro-benchmarks, run instead of the UI
+    if (app.arguments().contains("--benchmark-arguments")) {
+        ArgumentTemplate::runBenchmark();
+        return 0;
+    }
+    if (app.arguments().contains("--benchmark-spawn")) {
+        ProcessSpawn::runBenchmark("without WebEngine");
+        
+        // What the sign-in page leaves behind in the launcher process
+        QWebEngineView view;
+        QEventLoop loop;
+        QObject::connect(&view, &QWebEngineView::loadFinished, &loop, &QEventLoop::quit);
+        view.setHtml("<html><body>benchmark</body></html>");
+        loop.exec();
+        
+        ProcessSpawn::runBenchmark("with WebEngine loaded");
+        return 0;
+    }
+    if (app.arguments().contains("--benchmark-auth")) {
+        MicrosoftAuth::runBenchmark();
+        return 0;
+    }
+    const qsizetype assetsBenchmark = app.arguments().indexOf("--benchmark-assets");
+    if (assetsBenchmark >= 0) {
+        // Takes <game directory>/assets/indexes/<id>.json
+        AssetIndexStreamer::runBenchmark(app.arguments().value(assetsBenchmark + 1));
+        return 0;
+    }
+    
     // Create application data directory
     QString appDataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
     QDir().mkpath(appDataPath);
@@ -117,9 +164,159 @@ int main(int argc, char *argv[])
     // Initialize configuration manager
     ConfigManager::instance().initialize();
     
+    // Load the record of already verified game files
+    FileStateIndex::instance().initialize();
+    QObject::connect(&app, &QCoreApplication::aboutToQuit, []() {
+        FileStateIndex::instance().save();
+    });
+    
+    // Resolved launch plans from earlier sessions
+    LaunchPlanCache::instance().initialize();
+    QObject::connect(&app, &QCoreApplication::aboutToQuit, []() {
+        LaunchPlanCache::instance().save();
+    });
+    
+    // Class data sharing archives recorded by earlier launches
+    AppCdsManager::instance().initialize();
+    QObject::connect(&app, &QCoreApplication::aboutToQuit, []() {
+        AppCdsManager::instance().save();
+    });
+    
+    // Installed Java runtimes: cached probes first, then a background rescan
+    JavaRuntimeDiscovery::instance().initialize();
+    JavaRuntimeDiscovery::instance().setGameDirectory(ConfigManager::instance().gameDirectory());
+    JavaRuntimeDiscovery::instance().scan();
+    QObject::connect(&ConfigManager::instance(), &ConfigManager::gameDirectoryChanged, []() {
+        JavaRuntimeDiscovery::instance().setGameDirectory(ConfigManager::instance().gameDirectory());
+        JavaRuntimeDiscovery::instance().scan();
+    });
+    QObject::connect(&app, &QCoreApplication::aboutToQuit, []() {
+        JavaRuntimeDiscovery::instance().save();
+    });
+    
     // Initialize authentication manager
     AuthManager::instance().initialize();
     
+    // Parsed manifests are kept within a configurable memory budget
+    ManifestCache::instance().setBudgetBytes(qint64(ConfigManager::instance().manifestCacheMB()) * 1024 * 1024);
+    QObject::connect(&ConfigManager::instance(), &ConfigManager::manifestCacheMBChanged, []() {
+        ManifestCache::instance().setBudgetBytes(qint64(ConfigManager::instance().manifestCacheMB()) * 1024 * 1024);
+    });
+    
+    // Version catalogue: show the cached list right away, refresh in the background
+    VersionManager* versionManager = new VersionManager(&app);
+    versionManager->setGameDirectory(ConfigManager::instance().gameDirectory());
+    QObject::connect(&ConfigManager::instance(), &ConfigManager::gameDirectoryChanged, versionManager, [versionManager]() {
+        versionManager->setGameDirectory(ConfigManager::instance().gameDirectory());
+    });
+    versionManager->loadCachedCatalogue();
+    versionManager->refreshVersions();
+    
+    // Game launcher follows the configured game directory, Java and memory
+    GameLauncher* gameLauncher = new GameLauncher(&app);
+    auto applyLaunchSettings = [gameLauncher]() {
+        ConfigManager& config = ConfigManager::instance();
+        LaunchSettings settings;
+        settings.gameDirectory = config.gameDirectory();
+        settings.javaPath = config.javaPath();
+        settings.memoryMB = config.memoryMB();
+        settings.jvmProfile = JvmTuning::profileFromName(config.jvmProfile());
+        settings.appCds = config.appCdsEnabled();
+        settings.verification = LaunchSettings::verificationFromName(config.launchVerification());
+        settings.detach = config.detachGames();
+        if (config.currentProfile()) {
+            settings.placement = ProcessPlacement::fromJson(config.currentProfile()->placement());
+        }
+        gameLauncher->setLaunchSettings(settings);
+    };
+    applyLaunchSettings();
+    QObject::connect(&ConfigManager::instance(), &ConfigManager::gameDirectoryChanged, gameLauncher, applyLaunchSettings);
+    QObject::connect(&ConfigManager::instance(), &ConfigManager::javaPathChanged, gameLauncher, applyLaunchSettings);
+    QObject::connect(&ConfigManager::instance(), &ConfigManager::memoryMBChanged, gameLauncher, applyLaunchSettings);
+    QObject::connect(&ConfigManager::instance(), &ConfigManager::jvmProfileChanged, gameLauncher, applyLaunchSettings);
+    QObject::connect(&ConfigManager::instance(), &ConfigManager::appCdsEnabledChanged, gameLauncher, applyLaunchSettings);
+    QObject::connect(&ConfigManager::instance(), &ConfigManager::placementChanged, gameLauncher, applyLaunchSettings);
+    QObject::connect(&ConfigManager::instance(), &ConfigManager::launchVerificationChanged, gameLauncher, applyLaunchSettings);
+    QObject::connect(&ConfigManager::instance(), &ConfigManager::detachGamesChanged, gameLauncher, applyLaunchSettings);
+    
+    // The launcher does not link auth; Play reads the signed-in account through this
+    gameLauncher->setCredentialsProvider([]() {
+        const AuthManager& auth = AuthManager::instance();
+        return GameLauncher::Credentials{auth.username(), auth.uuid(), auth.accessToken()};
+    });
+    
+    // Installs ahead of a launch: the game starts once the files it reads
+    // before the title screen are in, the rest streams in while it boots
+    DownloadManager* installDownloads = new DownloadManager(&app);
+    InstallPlanner* installPlanner = new InstallPlanner(&app);
+    // Planning stats and hashes every file, so it runs off the GUI thread
+    QObject::connect(gameLauncher, &GameLauncher::installRequired, &app,
+                     [installPlanner](const QString& versionId, const QJsonObject& versionManifest) {
+        qCInfo(appMain) << "Planning install of" << versionId;
+        installPlanner->planAsync(versionId, versionManifest, ConfigManager::instance().gameDirectory());
+    });
+    QObject::connect(installPlanner, &InstallPlanner::planReady, &app,
+                     [installDownloads, installPlanner](const InstallPlan& plan) {
+        qCInfo(appMain) << "Installing" << plan.versionId << ":" << plan.missing.size() << "files to download";
+        installPlanner->submit(plan, installDownloads);
+    });
+    QObject::connect(installPlanner, &InstallPlanner::criticalFilesReady, gameLauncher, &GameLauncher::installReady);
+    QObject::connect(installPlanner, &InstallPlanner::criticalFilesFailed, gameLauncher, &GameLauncher::installFailed);
+    QObject::connect(installDownloads, &DownloadManager::allDownloadsCompleted, gameLauncher, &GameLauncher::assetsStreamed);
+    
+    // Files that fail a launch verification were dropped from the FileStateIndex,
+    // so a plan of the version hashes them again and downloads the bad ones
+    QObject::connect(gameLauncher, &GameLauncher::repairRequired, &app,
+                     [versionManager, installPlanner](const QString& versionId) {
+        qCInfo(appMain) << "Repairing" << versionId;
+        installPlanner->planAsync(versionId, versionManager->resolvedManifest(versionId),
+                                  ConfigManager::instance().gameDirectory());
+    });
+    
+    // Side-by-side clients, e.g. bots for server load tests
+    gameLauncher->instances()->setMaxInstances(ConfigManager::instance().maxInstances());
+    QObject::connect(&ConfigManager::instance(), &ConfigManager::maxInstancesChanged, gameLauncher, [gameLauncher]() {
+        gameLauncher->instances()->setMaxInstances(ConfigManager::instance().maxInstances());
+    });
+    
+    // Manifests of running versions stay in memory whatever the cache budget,
+    // so in-game trims and evictions never force a re-parse
+    QObject::connect(gameLauncher->instances(), &InstanceManager::instanceStarted, versionManager,
+                     [versionManager](GameInstance* instance) {
+        versionManager->pinVersion(instance->versionId());
+        // The next state after Running is the end
+        QObject::connect(instance, &GameInstance::stateChanged, versionManager, [versionManager, instance]() {
+            versionManager->unpinVersion(instance->versionId());
+        }, Qt::SingleShotConnection);
+    });
+    
+    // CPU, memory and I/O of running games, sampled from /proc
+    gameLauncher->instances()->setSampleIntervalMs(ConfigManager::instance().monitorIntervalMs());
+    QObject::connect(&ConfigManager::instance(), &ConfigManager::monitorIntervalMsChanged, gameLauncher, [gameLauncher]() {
+        gameLauncher->instances()->setSampleIntervalMs(ConfigManager::instance().monitorIntervalMs());
+    });
+    
+    // Downloads, hashing and extraction back off while a game runs
+    BackgroundGovernor& governor = BackgroundGovernor::instance();
+    auto applyGovernorSettings = [&governor]() {
+        const ConfigManager& config = ConfigManager::instance();
+        governor.setEnabled(config.throttleWhilePlaying());
+        governor.setThrottledBandwidth(qint64(config.playingBandwidthKBps()) * 1024);
+    };
+    applyGovernorSettings();
+    QObject::connect(&ConfigManager::instance(), &ConfigManager::throttleWhilePlayingChanged, &governor, applyGovernorSettings);
+    QObject::connect(&ConfigManager::instance(), &ConfigManager::playingBandwidthKBpsChanged, &governor, applyGovernorSettings);
+    BackgroundGovernor::setThreadPriorityFunction([](bool idle) {
+        return ProcessPlacement::setIoPriority(idle ? ProcessPlacement::IoIdle : ProcessPlacement::IoDefault, 0);
+    });
+    // Only once booted: verification, natives and downloads are part of a launch
+    QObject::connect(gameLauncher->instances(), &InstanceManager::bootedCountChanged, &governor, [gameLauncher, &governor]() {
+        governor.setGameRunning(gameLauncher->instances()->bootedCount() > 0);
+    });
+    
+    // Games an earlier session left running detached
+    gameLauncher->instances()->reattachDetached();
+    
     // Set up QML engine
     QQmlApplicationEngine engine;
     
@@ -134,6 +331,29 @@ int main(int argc, char *argv[])
             return &ConfigManager::instance();
         });
     
+    qmlRegisterSingletonInstance("CryovexLauncher", 1, 0, "VersionManager", versionManager);
+    qmlRegisterSingletonInstance("CryovexLauncher", 1, 0, "GameLauncher", gameLauncher);
+    qmlRegisterUncreatableType<GameOutputModel>("CryovexLauncher", 1, 0, "GameOutputModel",
+                                                "Game output is owned by GameInstance");
+    qmlRegisterUncreatableType<GameInstance>("CryovexLauncher", 1, 0, "GameInstance",
+                                             "Instances are created by GameLauncher");
+    qmlRegisterUncreatableType<InstanceManager>("CryovexLauncher", 1, 0, "InstanceManager",
+                                                "Instances are owned by GameLauncher");
+    
+    qmlRegisterSingletonType<ManifestCache>("CryovexLauncher", 1, 0, "ManifestCache",
+        [](QQmlEngine*, QJSEngine*) -> QObject* {
+            return &ManifestCache::instance();
+        });
+    
+    qmlRegisterSingletonType<JavaRuntimeDiscovery>("CryovexLauncher", 1, 0, "JavaRuntimes",
+        [](QQmlEngine*, QJSEngine*) -> QObject* {
+            return &JavaRuntimeDiscovery::instance();
+        });
+    
+    // Lean launcher while a game runs
+    InGameMode* inGameMode = new InGameMode(&engine, gameLauncher, versionManager, &app);
+    qmlRegisterSingletonInstance("CryovexLauncher", 1, 0, "InGameMode", inGameMode);
+    
     // Load the main QML file
     const QUrl url(QStringLiteral("qrc:/qml/main.qml"));
     QObject::connect(&engine, &QQmlApplicationEngine::objectCreated,
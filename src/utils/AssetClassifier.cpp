@@ -0,0 +1,20 @@
+#include "AssetClassifier.h"
+#include <QLocale>
+
+bool AssetClassifier::isNeededAtStartup(const QString& name, const QString& language)
+{
+    if (name.contains(QLatin1String("sounds/")) || name.contains(QLatin1String("sound/"))
+        || name.contains(QLatin1String("music/")) || name.contains(QLatin1String("records/"))) {
+        return false;
+    }
+    if (name.startsWith(QLatin1String("minecraft/lang/")) || name.startsWith(QLatin1String("lang/"))) {
+        const QString file = name.section('/', -1).toLower();
+        return file == QLatin1String("en_us.json") || file == QLatin1String("en_us.lang") || file.startsWith(language);
+    }
+    return true;
+}
+
+QString AssetClassifier::systemLanguage()
+{
+    return QLocale::system().name().toLower();
+}
\ No newline at end of file
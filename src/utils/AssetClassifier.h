@@ -0,0 +1,16 @@
+#pragma once
+
+#include <QString>
+
+// Which asset objects the game reads before its title screen. Sounds and
+// music stream in afterwards, and only English plus the system language are
+// loaded from lang/, so the rest can arrive after the game has started.
+class AssetClassifier
+{
+public:
+    // name is the asset index key, e.g. "minecraft/sounds/ambient/cave/cave1.ogg"
+    static bool isNeededAtStartup(const QString& name, const QString& language = systemLanguage());
+
+    // Lower-case locale name as the game spells it, e.g. "de_de"
+    static QString systemLanguage();
+};
\ No newline at end of file
@@ -0,0 +1,108 @@
+#include "BackgroundGovernor.h"
+#include <QThreadPool>
+#include <QLoggingCategory>
+
+Q_LOGGING_CATEGORY(backgroundGovernor, "cryovex.utils.governor")
+
+std::atomic<BackgroundGovernor::ThreadPriorityFunction> BackgroundGovernor::s_threadPriority{nullptr};
+
+BackgroundGovernor& BackgroundGovernor::instance()
+{
+    static BackgroundGovernor instance;
+    return instance;
+}
+
+BackgroundGovernor::BackgroundGovernor(QObject *parent)
+    : QObject(parent)
+{
+    m_rampUpTimer.setSingleShot(true);
+    m_rampUpTimer.setInterval(RAMP_UP_DELAY_MS);
+    connect(&m_rampUpTimer, &QTimer::timeout, this, [this]() {
+        setThrottled(false);
+    });
+}
+
+void BackgroundGovernor::registerPool(QThreadPool* pool)
+{
+    m_pools.insert(pool, pool->maxThreadCount());
+    connect(pool, &QObject::destroyed, this, [this, pool]() {
+        m_pools.remove(pool);
+    });
+    if (isThrottled()) {
+        pool->setMaxThreadCount(THROTTLED_THREADS);
+    }
+}
+
+void BackgroundGovernor::setGameRunning(bool running)
+{
+    m_gameRunning = running;
+    update();
+}
+
+void BackgroundGovernor::setEnabled(bool enabled)
+{
+    m_enabled = enabled;
+    update();
+}
+
+void BackgroundGovernor::setThrottledBandwidth(qint64 bytesPerSecond)
+{
+    bytesPerSecond = qMax<qint64>(0, bytesPerSecond);
+    if (m_throttledBandwidth == bytesPerSecond) {
+        return;
+    }
+    m_throttledBandwidth = bytesPerSecond;
+    if (isThrottled()) {
+        emit bandwidthLimitChanged(bandwidthLimit());
+    }
+}
+
+void BackgroundGovernor::applyThreadPriority()
+{
+    const ThreadPriorityFunction setPriority = s_threadPriority.load();
+    if (!setPriority) {
+        return;
+    }
+    // Pool threads are reused, so only a change costs a system call
+    thread_local bool idle = false;
+    const bool throttled = instance().isThrottled();
+    if (idle != throttled && setPriority(throttled)) {
+        idle = throttled;
+    }
+}
+
+void BackgroundGovernor::setThreadPriorityFunction(ThreadPriorityFunction function)
+{
+    s_threadPriority = function;
+}
+
+void BackgroundGovernor::update()
+{
+    if (m_enabled && m_gameRunning) {
+        m_rampUpTimer.stop();
+        setThrottled(true);
+    } else if (!m_enabled) {
+        m_rampUpTimer.stop();
+        setThrottled(false);
+    } else if (isThrottled() && !m_rampUpTimer.isActive()) {
+        // The game is still writing its world to disk as it exits
+        m_rampUpTimer.start();
+    }
+}
+
+void BackgroundGovernor::setThrottled(bool throttled)
+{
+    if (isThrottled() == throttled) {
+        return;
+    }
+    m_throttled = throttled;
+
+    for (auto it = m_pools.constBegin(); it != m_pools.constEnd(); ++it) {
+        it.key()->setMaxThreadCount(throttled ? qMin(THROTTLED_THREADS, it.value()) : it.value());
+    }
+    qCInfo(backgroundGovernor) << (throttled ? "Game running, throttling" : "Restoring") << m_pools.size()
+                               << "background pools, bandwidth limit" << bandwidthLimit() << "B/s";
+
+    emit throttledChanged(throttled);
+    emit bandwidthLimitChanged(bandwidthLimit());
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <QObject>
+#include <QHash>
+#include <QTimer>
+#include <atomic>
+
+class QThreadPool;
+
+// Keeps downloads, hashing, extraction and prefetching out of a running
+// game's way. Background thread pools register here and drop to one thread
+// once a game has booted, never during its launch, which needs them. Their
+// jobs call applyThreadPriority() to move to the idle I/O class, and
+// downloads share a bandwidth ceiling. Everything ramps back up a few
+// seconds after the last game exits, once it has saved.
+class BackgroundGovernor : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(bool throttled READ isThrottled NOTIFY throttledChanged)
+
+public:
+    static constexpr int THROTTLED_THREADS = 1;
+    static constexpr int THROTTLED_DOWNLOADS = 2;
+
+    // Sets the calling thread's I/O priority, idle or back to normal
+    using ThreadPriorityFunction = bool (*)(bool idle);
+
+    static BackgroundGovernor& instance();
+
+    // The pool's current thread count is what it gets back after a game
+    void registerPool(QThreadPool* pool);
+
+    bool isThrottled() const { return m_throttled.load(); }
+    void setGameRunning(bool running);
+    // Off: background work runs at full speed alongside games
+    void setEnabled(bool enabled);
+
+    // Bytes per second all downloads share while throttled, 0 for no ceiling
+    void setThrottledBandwidth(qint64 bytesPerSecond);
+    qint64 bandwidthLimit() const { return isThrottled() ? m_throttledBandwidth : 0; }
+
+    // For a job on a worker thread: idle I/O class while throttled, normal
+    // otherwise. Cheap enough to call per batch; a no-op until the launcher
+    // installs its priority function.
+    static void applyThreadPriority();
+    static void setThreadPriorityFunction(ThreadPriorityFunction function);
+
+signals:
+    void throttledChanged(bool throttled);
+    void bandwidthLimitChanged(qint64 bytesPerSecond);
+
+private:
+    explicit BackgroundGovernor(QObject *parent = nullptr);
+
+    void update();
+    void setThrottled(bool throttled);
+
+    static constexpr int RAMP_UP_DELAY_MS = 5000;
+
+    QHash<QThreadPool*, int> m_pools; // normal thread counts
+    QTimer m_rampUpTimer;
+    std::atomic<bool> m_throttled{false};
+    static std::atomic<ThreadPriorityFunction> s_threadPriority;
+    bool m_gameRunning = false;
+    bool m_enabled = true;
+    qint64 m_throttledBandwidth = 0;
+};
\ No newline at end of file
@@ -0,0 +1,243 @@
+#include "CompiledManifest.h"
+#include "NetworkUtils.h"
+#include <QCache>
+#include <QMutex>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QCryptographicHash>
+#include <QSysInfo>
+#include <QLoggingCategory>
+
+Q_LOGGING_CATEGORY(compiledManifest, "cryovex.utils.manifest")
+
+namespace {
+QMutex s_cacheMutex;
+QCache<QString, QSharedPointer<const CompiledManifest>> s_cache(32);
+}
+
+const QString CompiledManifest::MANIFEST_KEY_FIELD = "cryovexManifestKey";
+
+QSharedPointer<const CompiledManifest> CompiledManifest::get(const QJsonObject& manifest)
+{
+    const QString key = cacheKey(manifest);
+    {
+        QMutexLocker locker(&s_cacheMutex);
+        if (QSharedPointer<const CompiledManifest>* cached = s_cache.object(key)) {
+            return *cached;
+        }
+    }
+
+    QSharedPointer<CompiledManifest> compiled = compile(manifest);
+    compiled->key = key;
+
+    QMutexLocker locker(&s_cacheMutex);
+    s_cache.insert(key, new QSharedPointer<const CompiledManifest>(compiled));
+    return compiled;
+}
+
+QString CompiledManifest::cacheKey(const QJsonObject& manifest)
+{
+    // Resolved manifests carry their inheritance chain key (see VersionResolver)
+    const QString key = manifest.value(MANIFEST_KEY_FIELD).toString();
+    if (!key.isEmpty()) {
+        return key;
+    }
+
+    return QString::fromLatin1(QCryptographicHash::hash(QJsonDocument(manifest).toJson(QJsonDocument::Compact),
+                                                        QCryptographicHash::Sha1).toHex());
+}
+
+void CompiledManifest::clearCache()
+{
+    QMutexLocker locker(&s_cacheMutex);
+    s_cache.clear();
+}
+
+QString CompiledManifest::libraryPathFromName(const QString& name)
+{
+    // group:artifact:version[:classifier][@ext]
+    QString coordinates = name;
+    QString extension = "jar";
+    const int at = coordinates.indexOf('@');
+    if (at != -1) {
+        extension = coordinates.mid(at + 1);
+        coordinates.truncate(at);
+    }
+
+    const QStringList parts = coordinates.split(':');
+    if (parts.size() < 3) {
+        return QString();
+    }
+
+    QString group = parts.at(0);
+    group.replace('.', '/');
+    const QString& artifact = parts.at(1);
+    const QString& version = parts.at(2);
+
+    QString fileName = artifact + "-" + version;
+    if (parts.size() > 3) {
+        fileName += "-" + parts.at(3);
+    }
+
+    return group + "/" + artifact + "/" + version + "/" + fileName + "." + extension;
+}
+
+QList<const CompiledLibrary*> CompiledManifest::librariesFor(quint32 features) const
+{
+    QList<const CompiledLibrary*> result;
+    result.reserve(libraries.size());
+    for (const CompiledLibrary& library : libraries) {
+        if (library.rule.evaluate(features)) {
+            result.append(&library);
+        }
+    }
+    return result;
+}
+
+QStringList CompiledManifest::jvmArgumentsFor(quint32 features) const
+{
+    return argumentsFor(jvmArguments, features);
+}
+
+QStringList CompiledManifest::gameArgumentsFor(quint32 features) const
+{
+    return argumentsFor(gameArguments, features);
+}
+
+QSharedPointer<CompiledManifest> CompiledManifest::compile(const QJsonObject& manifest)
+{
+    auto compiled = QSharedPointer<CompiledManifest>::create();
+    compiled->id = manifest["id"].toString();
+    compiled->type = manifest["type"].toString();
+    compiled->mainClass = manifest["mainClass"].toString();
+    compiled->assetIndexId = manifest["assetIndex"].toObject()["id"].toString(manifest["assets"].toString());
+    compiled->javaMajorVersion = manifest["javaVersion"].toObject()["majorVersion"].toInt();
+
+    const QJsonArray libraries = manifest["libraries"].toArray();
+    compiled->libraries.reserve(libraries.size());
+    int dropped = 0;
+    for (const QJsonValue& value : libraries) {
+        CompiledLibrary library = compileLibrary(value.toObject());
+        if (library.rule.isNeverAllowed()) {
+            ++dropped;
+            continue;
+        }
+        compiled->libraries.append(library);
+    }
+
+    const QJsonObject arguments = manifest["arguments"].toObject();
+    if (!arguments.isEmpty()) {
+        compiled->jvmArguments = compileArguments(arguments["jvm"].toArray());
+        compiled->gameArguments = compileArguments(arguments["game"].toArray());
+    } else {
+        // Pre-1.13 manifests: a single game argument string and implied JVM arguments
+        CompiledArgument jvm;
+        jvm.values << "-Djava.library.path=${natives_directory}" << "-cp" << "${classpath}";
+        compiled->jvmArguments.append(jvm);
+
+        CompiledArgument game;
+        game.values = manifest["minecraftArguments"].toString().split(' ', Qt::SkipEmptyParts);
+        compiled->gameArguments.append(game);
+    }
+
+    qCInfo(compiledManifest) << "Compiled" << compiled->id << ":" << compiled->libraries.size()
+                             << "libraries," << dropped << "skipped for this platform";
+    return compiled;
+}
+
+CompiledLibrary CompiledManifest::compileLibrary(const QJsonObject& library)
+{
+    CompiledLibrary compiled;
+    compiled.name = library["name"].toString();
+    compiled.rule = CompiledRule::compile(library["rules"].toArray());
+    if (compiled.rule.isNeverAllowed()) {
+        return compiled;
+    }
+
+    const QJsonObject downloads = library["downloads"].toObject();
+    const QJsonObject artifact = downloads["artifact"].toObject();
+
+    if (!artifact.isEmpty()) {
+        compiled.path = artifact["path"].toString(libraryPathFromName(compiled.name));
+        compiled.url = QUrl(artifact["url"].toString());
+        compiled.sha1 = artifact["sha1"].toString();
+        compiled.size = artifact["size"].toInteger(-1);
+    } else if (downloads.isEmpty() && !library.contains("natives") && !compiled.name.isEmpty()) {
+        // Maven-style entry (Fabric, Quilt): name plus repository url
+        QString repository = library["url"].toString(NetworkUtils::MINECRAFT_LIBRARIES_URL);
+        if (!repository.endsWith('/')) {
+            repository += '/';
+        }
+
+        compiled.path = libraryPathFromName(compiled.name);
+        compiled.url = QUrl(repository + compiled.path);
+        compiled.sha1 = library["sha1"].toString();
+        compiled.size = library["size"].toInteger(-1);
+    }
+
+    // Legacy natives: one classifier jar per OS, extracted before launch
+    const QJsonObject natives = library["natives"].toObject();
+    const QString osName = RuleEngine::hostOsName();
+    if (natives.contains(osName)) {
+        QString classifier = natives[osName].toString();
+        classifier.replace("${arch}", QSysInfo::WordSize == 64 ? "64" : "32");
+
+        const QJsonObject native = downloads["classifiers"].toObject()[classifier].toObject();
+        if (!native.isEmpty()) {
+            compiled.nativePath = native["path"].toString();
+            compiled.nativeUrl = QUrl(native["url"].toString());
+            compiled.nativeSha1 = native["sha1"].toString();
+            compiled.nativeSize = native["size"].toInteger(-1);
+        }
+
+        for (const QJsonValue& exclude : library["extract"].toObject()["exclude"].toArray()) {
+            compiled.extractExclude.append(exclude.toString());
+        }
+    }
+
+    return compiled;
+}
+
+QList<CompiledArgument> CompiledManifest::compileArguments(const QJsonArray& arguments)
+{
+    // Consecutive unconditional strings share one entry
+    QList<CompiledArgument> compiled;
+    for (const QJsonValue& value : arguments) {
+        if (value.isString()) {
+            if (compiled.isEmpty() || !compiled.last().rule.isConstant()) {
+                compiled.append(CompiledArgument());
+            }
+            compiled.last().values.append(value.toString());
+            continue;
+        }
+
+        const QJsonObject object = value.toObject();
+        CompiledArgument argument;
+        argument.rule = CompiledRule::compile(object["rules"].toArray());
+        if (argument.rule.isNeverAllowed()) {
+            continue;
+        }
+
+        const QJsonValue argumentValue = object["value"];
+        if (argumentValue.isArray()) {
+            for (const QJsonValue& part : argumentValue.toArray()) {
+                argument.values.append(part.toString());
+            }
+        } else {
+            argument.values.append(argumentValue.toString());
+        }
+        compiled.append(argument);
+    }
+    return compiled;
+}
+
+QStringList CompiledManifest::argumentsFor(const QList<CompiledArgument>& arguments, quint32 features)
+{
+    QStringList result;
+    for (const CompiledArgument& argument : arguments) {
+        if (argument.rule.evaluate(features)) {
+            result.append(argument.values);
+        }
+    }
+    return result;
+}
\ No newline at end of file
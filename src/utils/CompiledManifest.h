@@ -0,0 +1,75 @@
+#pragma once
+
+#include <QJsonObject>
+#include <QList>
+#include <QSharedPointer>
+#include <QStringList>
+#include <QUrl>
+#include "RuleEngine.h"
+
+struct CompiledLibrary
+{
+    QString name;
+    CompiledRule rule;
+
+    // Classpath artifact, path relative to the libraries directory
+    QString path;
+    QUrl url; // empty: generated locally (e.g. by the Forge installer)
+    QString sha1;
+    qint64 size = -1;
+
+    // Legacy native classifier already chosen for this host
+    QString nativePath;
+    QUrl nativeUrl;
+    QString nativeSha1;
+    qint64 nativeSize = -1;
+    QStringList extractExclude;
+
+    bool hasArtifact() const { return !path.isEmpty(); }
+    bool hasNative() const { return !nativePath.isEmpty(); }
+};
+
+struct CompiledArgument
+{
+    CompiledRule rule;
+    QStringList values;
+};
+
+// Everything launch and install need from a version manifest, with rules
+// compiled once. Libraries and arguments for other platforms are dropped
+// here, so nothing downstream walks the JSON or sees them again.
+class CompiledManifest
+{
+public:
+    // Compiled form of a resolved manifest, cached by manifest key
+    static QSharedPointer<const CompiledManifest> get(const QJsonObject& manifest);
+    // Stable identity of a manifest: the chain key VersionResolver stores in
+    // MANIFEST_KEY_FIELD, otherwise the sha1 of its compact JSON form
+    static QString cacheKey(const QJsonObject& manifest);
+    static void clearCache();
+
+    static const QString MANIFEST_KEY_FIELD;
+
+    static QString libraryPathFromName(const QString& name);
+
+    QString key;
+    QString id;
+    QString type;
+    QString mainClass;
+    QString assetIndexId;
+    int javaMajorVersion = 0; // javaVersion.majorVersion, 0 if unspecified
+
+    QList<CompiledLibrary> libraries;
+    QList<CompiledArgument> jvmArguments;
+    QList<CompiledArgument> gameArguments;
+
+    QList<const CompiledLibrary*> librariesFor(quint32 features) const;
+    QStringList jvmArgumentsFor(quint32 features) const;
+    QStringList gameArgumentsFor(quint32 features) const;
+
+private:
+    static QSharedPointer<CompiledManifest> compile(const QJsonObject& manifest);
+    static CompiledLibrary compileLibrary(const QJsonObject& library);
+    static QList<CompiledArgument> compileArguments(const QJsonArray& arguments);
+    static QStringList argumentsFor(const QList<CompiledArgument>& arguments, quint32 features);
+};
\ No newline at end of file
@@ -0,0 +1,124 @@
+#include "DetachedGameState.h"
+#include <QSaveFile>
+#include <QFile>
+#include <QJsonDocument>
+
+namespace {
+
+#ifdef Q_OS_LINUX
+// Field of /proc/<pid>/stat, counted as in proc(5)
+const int STAT_STARTTIME = 22;
+#endif
+
+QString phaseName(DetachedGameState::Phase phase)
+{
+    switch (phase) {
+    case DetachedGameState::Running:
+        return "running";
+    case DetachedGameState::Ended:
+        return "ended";
+    case DetachedGameState::Starting:
+        break;
+    }
+    return "starting";
+}
+
+DetachedGameState::Phase phaseFromName(const QString& name)
+{
+    if (name == "running") {
+        return DetachedGameState::Running;
+    }
+    if (name == "ended") {
+        return DetachedGameState::Ended;
+    }
+    return DetachedGameState::Starting;
+}
+
+}
+
+QJsonObject DetachedGameState::toJson() const
+{
+    QJsonObject json;
+    json["phase"] = phaseName(phase);
+    json["versionId"] = versionId;
+    json["logFile"] = logFile;
+    json["helperPid"] = helperPid;
+    json["gamePid"] = gamePid;
+    json["helperStartTime"] = helperStartTime;
+    json["gameStartTime"] = gameStartTime;
+    json["startedAt"] = startedAt.toString(Qt::ISODateWithMs);
+    if (phase == Ended) {
+        json["endedAt"] = endedAt.toString(Qt::ISODateWithMs);
+        json["exitCode"] = exitCode;
+        json["crashed"] = crashed;
+    }
+    if (!error.isEmpty()) {
+        json["error"] = error;
+    }
+    return json;
+}
+
+DetachedGameState DetachedGameState::fromJson(const QJsonObject& json)
+{
+    DetachedGameState state;
+    state.phase = phaseFromName(json["phase"].toString());
+    state.versionId = json["versionId"].toString();
+    state.logFile = json["logFile"].toString();
+    state.helperPid = json["helperPid"].toInteger();
+    state.gamePid = json["gamePid"].toInteger();
+    state.helperStartTime = json["helperStartTime"].toInteger();
+    state.gameStartTime = json["gameStartTime"].toInteger();
+    state.startedAt = QDateTime::fromString(json["startedAt"].toString(), Qt::ISODateWithMs);
+    state.endedAt = QDateTime::fromString(json["endedAt"].toString(), Qt::ISODateWithMs);
+    state.exitCode = json["exitCode"].toInt();
+    state.crashed = json["crashed"].toBool();
+    state.error = json["error"].toString();
+    return state;
+}
+
+qint64 DetachedGameState::processStartTime(qint64 pid)
+{
+#ifdef Q_OS_LINUX
+    QFile file(QString("/proc/%1/stat").arg(pid));
+    if (pid <= 0 || !file.open(QIODevice::ReadOnly)) {
+        return 0;
+    }
+    // The command name in field 2 may hold spaces and parentheses, so count
+    // from the last ')'; the field after it is field 3
+    const QByteArray stat = file.readAll();
+    const qsizetype nameEnd = stat.lastIndexOf(')');
+    if (nameEnd < 0) {
+        return 0;
+    }
+    const QList<QByteArray> fields = stat.mid(nameEnd + 1).simplified().split(' ');
+    const int index = STAT_STARTTIME - 3;
+    return fields.size() > index ? fields.at(index).toLongLong() : 0;
+#else
+    Q_UNUSED(pid)
+    return 0;
+#endif
+}
+
+bool DetachedGameState::save(const QString& path) const
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    file.write(QJsonDocument(toJson()).toJson(QJsonDocument::Compact));
+    return file.commit();
+}
+
+bool DetachedGameState::load(const QString& path, DetachedGameState* state)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    if (!doc.isObject()) {
+        return false;
+    }
+    *state = fromJson(doc.object());
+    return state->helperPid > 0;
+}
\ No newline at end of file
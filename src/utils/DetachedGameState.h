@@ -0,0 +1,42 @@
+#pragma once
+
+#include <QString>
+#include <QDateTime>
+#include <QJsonObject>
+
+// State file of a game run by the log-capture helper (cryovex-loghelper).
+// The helper rewrites it as the game starts and ends; the launcher that
+// started the game, or a later one, reads it back.
+struct DetachedGameState
+{
+    enum Phase {
+        Starting, // helper up, game not spawned yet
+        Running,
+        Ended
+    };
+
+    Phase phase = Starting;
+    QString versionId;
+    QString logFile;
+    qint64 helperPid = 0;
+    qint64 gamePid = 0;
+    // processStartTime() of each, so a reused pid is not taken for them
+    qint64 helperStartTime = 0;
+    qint64 gameStartTime = 0;
+    QDateTime startedAt;
+    QDateTime endedAt;
+    int exitCode = 0;
+    bool crashed = false;
+    QString error; // set when the game failed to start
+
+    QJsonObject toJson() const;
+    static DetachedGameState fromJson(const QJsonObject& json);
+
+    // Clock ticks after boot the process started at (/proc/<pid>/stat field
+    // 22); 0 if it is gone or unknown, as on systems without procfs
+    static qint64 processStartTime(qint64 pid);
+
+    // Atomic replace, so a reader never sees half a file
+    bool save(const QString& path) const;
+    static bool load(const QString& path, DetachedGameState* state);
+};
\ No newline at end of file
@@ -0,0 +1,143 @@
+#include "FileStateIndex.h"
+#include <QStandardPaths>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QFile>
+#include <QDir>
+#include <QDateTime>
+#include <QLoggingCategory>
+
+Q_LOGGING_CATEGORY(fileStateIndex, "cryovex.utils.filestate")
+
+FileStateIndex& FileStateIndex::instance()
+{
+    static FileStateIndex instance;
+    return instance;
+}
+
+FileStateIndex::FileStateIndex(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void FileStateIndex::initialize()
+{
+    QFile file(getIndexFilePath());
+    if (!file.exists()) {
+        qCInfo(fileStateIndex) << "No file state index found, starting empty";
+        return;
+    }
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCWarning(fileStateIndex) << "Failed to open file state index:" << file.errorString();
+        return;
+    }
+
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &error);
+    if (error.error != QJsonParseError::NoError) {
+        qCWarning(fileStateIndex) << "Failed to parse file state index:" << error.errorString();
+        return;
+    }
+
+    QWriteLocker locker(&m_lock);
+    const QJsonObject files = doc.object();
+    m_states.reserve(files.size());
+    for (auto it = files.constBegin(); it != files.constEnd(); ++it) {
+        const QJsonObject entry = it.value().toObject();
+        FileState state;
+        state.size = entry["size"].toInteger(-1);
+        state.lastModified = entry["mtime"].toInteger();
+        state.sha1 = entry["sha1"].toString();
+        m_states.insert(it.key(), state);
+    }
+
+    qCInfo(fileStateIndex) << "Loaded state for" << m_states.size() << "files";
+}
+
+void FileStateIndex::save()
+{
+    QJsonObject files;
+    {
+        QWriteLocker locker(&m_lock);
+        if (!m_dirty) {
+            return;
+        }
+        for (auto it = m_states.constBegin(); it != m_states.constEnd(); ++it) {
+            QJsonObject entry;
+            entry["size"] = it->size;
+            entry["mtime"] = it->lastModified;
+            entry["sha1"] = it->sha1;
+            files.insert(it.key(), entry);
+        }
+        m_dirty = false;
+    }
+
+    QString indexPath = getIndexFilePath();
+    QDir().mkpath(QFileInfo(indexPath).absolutePath());
+
+    QFile file(indexPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(fileStateIndex) << "Failed to save file state index:" << file.errorString();
+        return;
+    }
+
+    file.write(QJsonDocument(files).toJson(QJsonDocument::Compact));
+}
+
+bool FileStateIndex::isVerified(const QFileInfo& info, const QString& sha1) const
+{
+    QReadLocker locker(&m_lock);
+    auto it = m_states.constFind(info.absoluteFilePath());
+    if (it == m_states.constEnd()) {
+        return false;
+    }
+
+    return it->size == info.size()
+        && it->lastModified == info.lastModified().toMSecsSinceEpoch()
+        && it->sha1.compare(sha1, Qt::CaseInsensitive) == 0;
+}
+
+void FileStateIndex::recordVerified(const QFileInfo& info, const QString& sha1)
+{
+    FileState state;
+    state.size = info.size();
+    state.lastModified = info.lastModified().toMSecsSinceEpoch();
+    state.sha1 = sha1.toLower();
+
+    QWriteLocker locker(&m_lock);
+    m_states.insert(info.absoluteFilePath(), state);
+    m_dirty = true;
+}
+
+void FileStateIndex::invalidate(const QString& filePath)
+{
+    const QString absolutePath = QFileInfo(filePath).absoluteFilePath();
+    {
+        QWriteLocker locker(&m_lock);
+        if (m_states.remove(absolutePath) == 0) {
+            return;
+        }
+        m_dirty = true;
+    }
+    emit fileInvalidated(absolutePath);
+}
+
+bool FileStateIndex::lookup(const QString& filePath, FileState* state) const
+{
+    QReadLocker locker(&m_lock);
+    auto it = m_states.constFind(QFileInfo(filePath).absoluteFilePath());
+    if (it == m_states.constEnd()) {
+        return false;
+    }
+    if (state) {
+        *state = it.value();
+    }
+    return true;
+}
+
+QString FileStateIndex::getIndexFilePath() const
+{
+    QString appDataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    return QDir(appDataPath).filePath("cache/file-state.json");
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <QObject>
+#include <QHash>
+#include <QString>
+#include <QReadWriteLock>
+#include <QFileInfo>
+
+// Remembers the (size, mtime, sha1) of files that were last verified, so a
+// file that has not been touched since does not need to be hashed again.
+// Safe to use from worker threads.
+class FileStateIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct FileState {
+        qint64 size = -1;
+        qint64 lastModified = 0; // msecs since epoch
+        QString sha1;
+    };
+
+    static FileStateIndex& instance();
+
+    void initialize();
+    void save();
+
+    // True if the file is unchanged since it was last verified against sha1
+    bool isVerified(const QFileInfo& info, const QString& sha1) const;
+    void recordVerified(const QFileInfo& info, const QString& sha1);
+    void invalidate(const QString& filePath);
+
+    bool lookup(const QString& filePath, FileState* state) const;
+
+signals:
+    void fileInvalidated(const QString& filePath);
+
+private:
+    explicit FileStateIndex(QObject *parent = nullptr);
+    ~FileStateIndex() = default;
+
+    QString getIndexFilePath() const;
+
+    mutable QReadWriteLock m_lock;
+    QHash<QString, FileState> m_states;
+    bool m_dirty = false;
+};
\ No newline at end of file
@@ -0,0 +1,259 @@
+#include "NativesCache.h"
+#include "ZipReader.h"
+#include "BackgroundGovernor.h"
+#include "FileUtils.h"
+#include <QStandardPaths>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QUuid>
+#include <QElapsedTimer>
+#include <QLoggingCategory>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+Q_LOGGING_CATEGORY(nativesCache, "cryovex.utils.natives")
+
+NativesCache& NativesCache::instance()
+{
+    static NativesCache instance;
+    return instance;
+}
+
+NativesCache::NativesCache(QObject *parent)
+    : QObject(parent)
+{
+    BackgroundGovernor::instance().registerPool(&m_pool);
+}
+
+NativesCache::~NativesCache()
+{
+    m_pool.waitForDone();
+}
+
+bool NativesCache::isExtracted(const QString& sha1) const
+{
+    return !sha1.isEmpty() && QFileInfo::exists(storePath(sha1));
+}
+
+QStringList NativesCache::extractedFiles(const QString& sha1) const
+{
+    QStringList files;
+    if (sha1.isEmpty()) {
+        return files;
+    }
+    QDirIterator it(storePath(sha1), QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        files.append(it.next());
+    }
+    return files;
+}
+
+void NativesCache::extractAsync(const NativeJar& jar)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        if (jar.sha1.isEmpty() || m_pending.contains(jar.sha1) || isExtracted(jar.sha1)) {
+            return;
+        }
+        m_pending.insert(jar.sha1);
+    }
+
+    m_pool.start([this, jar]() {
+        BackgroundGovernor::applyThreadPriority();
+        const bool success = extract(jar);
+        {
+            QMutexLocker locker(&m_mutex);
+            m_pending.remove(jar.sha1);
+            m_pendingDone.wakeAll();
+        }
+        emit extracted(jar.sha1, success);
+    });
+}
+
+bool NativesCache::prepareLaunchDirectory(const QString& directory, const QList<NativeJar>& jars)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    for (const NativeJar& jar : jars) {
+        if (jar.sha1.isEmpty()) {
+            qCWarning(nativesCache) << "Natives jar without sha1 cannot be cached:" << jar.path;
+            return false;
+        }
+        if (!ensureExtracted(jar)) {
+            return false;
+        }
+    }
+
+    removeLaunchDirectory(directory);
+    if (!QDir().mkpath(directory)) {
+        qCWarning(nativesCache) << "Failed to create natives directory:" << directory;
+        return false;
+    }
+
+    int linked = 0;
+    for (const NativeJar& jar : jars) {
+        const QString source = storePath(jar.sha1);
+        QDirIterator it(source, QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            const QString sourceFile = it.next();
+            const QString target = QDir(directory).filePath(QDir(source).relativeFilePath(sourceFile));
+            if (QFileInfo::exists(target)) {
+                continue; // first jar providing a file wins
+            }
+
+            QDir().mkpath(QFileInfo(target).absolutePath());
+            if (!linkFile(sourceFile, target)) {
+                qCWarning(nativesCache) << "Failed to link native" << sourceFile << "into" << directory;
+                return false;
+            }
+            ++linked;
+        }
+    }
+
+    qCInfo(nativesCache) << "Prepared natives directory with" << linked << "files from" << jars.size()
+                         << "jars in" << timer.elapsed() << "ms";
+    return true;
+}
+
+void NativesCache::removeLaunchDirectory(const QString& directory)
+{
+    // Only removes the links, the store is untouched
+    if (!directory.isEmpty()) {
+        QDir(directory).removeRecursively();
+    }
+}
+
+bool NativesCache::ensureExtracted(const NativeJar& jar)
+{
+    QMutexLocker locker(&m_mutex);
+    while (m_pending.contains(jar.sha1)) {
+        m_pendingDone.wait(&m_mutex);
+    }
+    if (isExtracted(jar.sha1)) {
+        return true;
+    }
+
+    // Not queued yet: extract on the caller's thread
+    m_pending.insert(jar.sha1);
+    locker.unlock();
+
+    const bool success = extract(jar);
+
+    locker.relock();
+    m_pending.remove(jar.sha1);
+    m_pendingDone.wakeAll();
+    return success;
+}
+
+bool NativesCache::extract(const NativeJar& jar)
+{
+    if (isExtracted(jar.sha1)) {
+        return true;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    ZipReader reader(jar.path);
+    if (!reader.open()) {
+        qCWarning(nativesCache) << "Failed to open natives jar" << jar.path << ":" << reader.errorString();
+        return false;
+    }
+
+    // Extract next to the store entry, then publish it with a single rename
+    const QString target = storePath(jar.sha1);
+    const QString staging = target + ".tmp-" + QUuid::createUuid().toString(QUuid::WithoutBraces);
+    QDir().mkpath(staging);
+    const QDir stagingDir(staging);
+    const QString stagingRoot = QDir::cleanPath(stagingDir.absolutePath()) + '/';
+
+    int files = 0;
+    for (const ZipReader::Entry& entry : reader.entries()) {
+        if (entry.isDirectory()) {
+            continue;
+        }
+
+        // Resolved, an entry must stay inside the staging directory (zip slip);
+        // backslashes count as separators, as Windows would treat them
+        const QString name = QString(entry.name).replace('\\', '/');
+        const QString filePath = QDir::cleanPath(stagingDir.absoluteFilePath(name));
+        if (!filePath.startsWith(stagingRoot)) {
+            qCWarning(nativesCache) << "Skipping" << entry.name << "in" << jar.path << ": outside the natives directory";
+            continue;
+        }
+
+        bool excluded = false;
+        for (const QString& prefix : jar.exclude) {
+            if (entry.name.startsWith(prefix)) {
+                excluded = true;
+                break;
+            }
+        }
+        if (excluded) {
+            continue;
+        }
+
+        QByteArray data;
+        if (!reader.read(entry, &data)) {
+            qCWarning(nativesCache) << "Failed to extract" << jar.path << ":" << reader.errorString();
+            QDir(staging).removeRecursively();
+            return false;
+        }
+
+        QDir().mkpath(QFileInfo(filePath).absolutePath());
+        QFile file(filePath);
+        if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size()) {
+            qCWarning(nativesCache) << "Failed to write" << filePath << ":" << file.errorString();
+            QDir(staging).removeRecursively();
+            return false;
+        }
+        ++files;
+    }
+
+    // The store is keyed by sha1, so only a jar that matches it may be published
+    if (!FileUtils::verifySha1(jar.path, jar.sha1)) {
+        qCWarning(nativesCache) << "Checksum mismatch, not extracting" << jar.path;
+        QDir(staging).removeRecursively();
+        return false;
+    }
+
+    if (!QDir().rename(staging, target)) {
+        // Lost a race with another extraction of the same jar
+        QDir(staging).removeRecursively();
+        return isExtracted(jar.sha1);
+    }
+
+    qCInfo(nativesCache) << "Extracted" << files << "natives from" << QFileInfo(jar.path).fileName()
+                         << "in" << timer.elapsed() << "ms";
+    return true;
+}
+
+bool NativesCache::linkFile(const QString& source, const QString& target)
+{
+#ifdef Q_OS_WIN
+    if (CreateHardLinkW(reinterpret_cast<LPCWSTR>(QDir::toNativeSeparators(target).utf16()),
+                        reinterpret_cast<LPCWSTR>(QDir::toNativeSeparators(source).utf16()), nullptr)) {
+        return true;
+    }
+    return QFile::copy(source, target);
+#else
+    // Hardlinks fail across filesystems; fall back to a symlink
+    if (::link(QFile::encodeName(source).constData(), QFile::encodeName(target).constData()) == 0) {
+        return true;
+    }
+    return QFile::link(source, target) || QFile::copy(source, target);
+#endif
+}
+
+QString NativesCache::storePath(const QString& sha1) const
+{
+    QString appDataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    return QDir(appDataPath).filePath("cache/natives/" + sha1.toLower());
+}
\ No newline at end of file
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <QObject>
+#include <QMutex>
+#include <QSet>
+#include <QStringList>
+#include <QThreadPool>
+#include <QWaitCondition>
+
+struct NativeJar
+{
+    QString path;
+    QString sha1;
+    QStringList exclude; // extract.exclude prefixes, e.g. "META-INF/"
+};
+
+// Content-addressed store of extracted natives jars: every jar is unpacked
+// once into cache/natives/<sha1>, however many versions use it. Launches get
+// a throwaway directory of hardlinks (or symlinks) into the store.
+class NativesCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    static NativesCache& instance();
+
+    bool isExtracted(const QString& sha1) const;
+    // Files unpacked from a jar, empty if it is not in the store yet
+    QStringList extractedFiles(const QString& sha1) const;
+
+    // Queues extraction on the worker pool; no-op if already extracted or queued
+    void extractAsync(const NativeJar& jar);
+
+    // Blocks until every jar is in the store, then links them into directory;
+    // may extract on the calling thread, so keep it off the GUI thread
+    bool prepareLaunchDirectory(const QString& directory, const QList<NativeJar>& jars);
+    static void removeLaunchDirectory(const QString& directory);
+
+signals:
+    void extracted(const QString& sha1, bool success);
+
+private:
+    explicit NativesCache(QObject *parent = nullptr);
+    ~NativesCache();
+
+    bool extract(const NativeJar& jar);
+    bool ensureExtracted(const NativeJar& jar);
+    static bool linkFile(const QString& source, const QString& target);
+    QString storePath(const QString& sha1) const;
+
+    QThreadPool m_pool;
+    mutable QMutex m_mutex;
+    QWaitCondition m_pendingDone;
+    QSet<QString> m_pending;
+};
\ No newline at end of file
@@ -0,0 +1,37 @@
+#include "ProcessMemory.h"
+#include <QFile>
+#include <QList>
+
+#ifdef Q_OS_UNIX
+#include <unistd.h>
+#endif
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+qint64 ProcessMemory::residentBytes()
+{
+#ifdef Q_OS_LINUX
+    // "size resident shared text lib data dt", in pages
+    QFile file("/proc/self/statm");
+    if (!file.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+    const QList<QByteArray> fields = file.readAll().split(' ');
+    if (fields.size() < 2) {
+        return -1;
+    }
+    return fields.at(1).toLongLong() * sysconf(_SC_PAGESIZE);
+#else
+    return -1;
+#endif
+}
+
+bool ProcessMemory::releaseFreeHeap()
+{
+#ifdef __GLIBC__
+    return malloc_trim(0) != 0;
+#else
+    return false;
+#endif
+}
\ No newline at end of file
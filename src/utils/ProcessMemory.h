@@ -0,0 +1,15 @@
+#pragma once
+
+#include <QtGlobal>
+
+// The launcher's own memory footprint
+class ProcessMemory
+{
+public:
+    // Resident set size in bytes, -1 where it cannot be read
+    static qint64 residentBytes();
+
+    // Hands freed heap pages back to the system. glibc keeps them in its
+    // arenas otherwise, so RSS would not drop after large objects are freed.
+    static bool releaseFreeHeap();
+};
\ No newline at end of file
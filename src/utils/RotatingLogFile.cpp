@@ -0,0 +1,85 @@
+#include "RotatingLogFile.h"
+#include <QFileInfo>
+#include <QDir>
+#include <QLoggingCategory>
+
+Q_LOGGING_CATEGORY(rotatingLog, "cryovex.utils.rotatinglog")
+
+RotatingLogFile::RotatingLogFile(qint64 maxBytes, int keep)
+    : m_maxBytes(maxBytes)
+    , m_keep(keep)
+{
+}
+
+RotatingLogFile::~RotatingLogFile()
+{
+    close();
+}
+
+bool RotatingLogFile::open(const QString& filePath)
+{
+    close();
+
+    m_filePath = filePath;
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+
+    // Every session starts on a fresh file; the previous one becomes .1
+    if (QFileInfo::exists(filePath)) {
+        rotate();
+    }
+
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(rotatingLog) << "Failed to open log file" << filePath << ":" << m_file.errorString();
+        return false;
+    }
+    m_size = 0;
+    return true;
+}
+
+void RotatingLogFile::close()
+{
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+}
+
+void RotatingLogFile::write(const QByteArray& data)
+{
+    if (!m_file.isOpen() || data.isEmpty()) {
+        return;
+    }
+
+    if (m_size + data.size() > m_maxBytes && m_size > 0) {
+        m_file.close();
+        rotate();
+        m_file.setFileName(m_filePath);
+        if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            qCWarning(rotatingLog) << "Failed to reopen log file" << m_filePath << ":" << m_file.errorString();
+            return;
+        }
+        m_size = 0;
+    }
+
+    m_size += m_file.write(data);
+}
+
+void RotatingLogFile::flush()
+{
+    if (m_file.isOpen()) {
+        m_file.flush();
+    }
+}
+
+void RotatingLogFile::rotate()
+{
+    QFile::remove(QString("%1.%2").arg(m_filePath).arg(m_keep));
+    for (int i = m_keep - 1; i >= 1; --i) {
+        QFile::rename(QString("%1.%2").arg(m_filePath).arg(i), QString("%1.%2").arg(m_filePath).arg(i + 1));
+    }
+    if (m_keep > 0) {
+        QFile::rename(m_filePath, m_filePath + ".1");
+    } else {
+        QFile::remove(m_filePath);
+    }
+}
\ No newline at end of file
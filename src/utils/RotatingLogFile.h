@@ -0,0 +1,30 @@
+#pragma once
+
+#include <QFile>
+#include <QString>
+
+// Append-only log that rolls over to <path>.1 .. <path>.<keep> once it grows
+// past maxBytes. Not thread safe; owned by whoever produces the data.
+class RotatingLogFile
+{
+public:
+    explicit RotatingLogFile(qint64 maxBytes = 16 * 1024 * 1024, int keep = 3);
+    ~RotatingLogFile();
+
+    bool open(const QString& filePath);
+    void close();
+    bool isOpen() const { return m_file.isOpen(); }
+    QString filePath() const { return m_filePath; }
+
+    void write(const QByteArray& data);
+    void flush();
+
+private:
+    void rotate();
+
+    QFile m_file;
+    QString m_filePath;
+    qint64 m_maxBytes;
+    int m_keep;
+    qint64 m_size = 0;
+};
\ No newline at end of file
@@ -0,0 +1,130 @@
+#include "RuleEngine.h"
+#include <QHash>
+#include <QSysInfo>
+#include <QRegularExpression>
+
+CompiledRule CompiledRule::compile(const QJsonArray& rules)
+{
+    CompiledRule compiled;
+    if (rules.isEmpty()) {
+        return compiled;
+    }
+
+    // Last matching rule wins; nothing matching means disallowed
+    compiled.m_default = false;
+    for (const QJsonValue& value : rules) {
+        const QJsonObject rule = value.toObject();
+        const bool allow = rule["action"].toString() == "allow";
+
+        if (rule.contains("os") && !RuleEngine::matchesHost(rule["os"].toObject())) {
+            continue;
+        }
+
+        Term term{0, 0, allow};
+        bool satisfiable = true;
+        const QJsonObject features = rule["features"].toObject();
+        for (auto it = features.constBegin(); it != features.constEnd(); ++it) {
+            const quint32 bit = RuleEngine::featureBit(it.key());
+            const bool wanted = it.value().toBool();
+            if (bit == 0) {
+                // Features we never enable are always false
+                satisfiable = satisfiable && !wanted;
+                continue;
+            }
+            term.mask |= bit;
+            if (wanted) {
+                term.value |= bit;
+            }
+        }
+
+        if (!satisfiable) {
+            continue;
+        }
+
+        if (term.mask == 0) {
+            // Unconditional: earlier rules can no longer decide the result
+            compiled.m_terms.clear();
+            compiled.m_default = allow;
+        } else {
+            compiled.m_terms.append(term);
+        }
+    }
+
+    return compiled;
+}
+
+bool CompiledRule::evaluate(quint32 features) const
+{
+    for (int i = m_terms.size() - 1; i >= 0; --i) {
+        const Term& term = m_terms.at(i);
+        if ((features & term.mask) == term.value) {
+            return term.allow;
+        }
+    }
+    return m_default;
+}
+
+quint32 RuleEngine::featureBit(const QString& name)
+{
+    static const QHash<QString, quint32> bits = {
+        {"is_demo_user", IsDemoUser},
+        {"has_custom_resolution", HasCustomResolution},
+        {"has_quick_plays_support", HasQuickPlaysSupport},
+        {"is_quick_play_singleplayer", IsQuickPlaySingleplayer},
+        {"is_quick_play_multiplayer", IsQuickPlayMultiplayer},
+        {"is_quick_play_realms", IsQuickPlayRealms}
+    };
+    return bits.value(name, 0);
+}
+
+QString RuleEngine::hostOsName()
+{
+#if defined(Q_OS_WIN)
+    return "windows";
+#elif defined(Q_OS_MACOS)
+    return "osx";
+#else
+    return "linux";
+#endif
+}
+
+QString RuleEngine::hostArch()
+{
+    static const QString arch = normalizeArch(QSysInfo::currentCpuArchitecture());
+    return arch;
+}
+
+bool RuleEngine::matchesHost(const QJsonObject& os)
+{
+    if (os.contains("name") && os["name"].toString() != hostOsName()) {
+        return false;
+    }
+
+    if (os.contains("arch") && normalizeArch(os["arch"].toString()) != hostArch()) {
+        return false;
+    }
+
+    if (os.contains("version")) {
+        const QRegularExpression pattern(os["version"].toString());
+        if (!pattern.isValid() || !pattern.match(QSysInfo::productVersion()).hasMatch()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+QString RuleEngine::normalizeArch(const QString& arch)
+{
+    // Manifests use Java's os.arch names
+    if (arch == "x86" || arch == "i386" || arch == "i686") {
+        return "x86";
+    }
+    if (arch == "x86_64" || arch == "amd64") {
+        return "x86_64";
+    }
+    if (arch == "arm64" || arch == "aarch64") {
+        return "arm64";
+    }
+    return arch;
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QString>
+#include <QVarLengthArray>
+
+// A Mojang "rules" array compiled against this host. OS name, version and
+// arch cannot change while the launcher runs, so they are folded away during
+// compilation; what is left is a short list of feature bitmask tests.
+class CompiledRule
+{
+public:
+    CompiledRule() = default; // no rules: always allowed
+
+    static CompiledRule compile(const QJsonArray& rules);
+
+    bool evaluate(quint32 features) const;
+
+    // True if the result does not depend on features
+    bool isConstant() const { return m_terms.isEmpty(); }
+    bool isNeverAllowed() const { return m_terms.isEmpty() && !m_default; }
+
+private:
+    struct Term {
+        quint32 mask;
+        quint32 value;
+        bool allow;
+    };
+
+    bool m_default = true;
+    QVarLengthArray<Term, 2> m_terms;
+};
+
+class RuleEngine
+{
+public:
+    enum Feature : quint32 {
+        IsDemoUser = 1u << 0,
+        HasCustomResolution = 1u << 1,
+        HasQuickPlaysSupport = 1u << 2,
+        IsQuickPlaySingleplayer = 1u << 3,
+        IsQuickPlayMultiplayer = 1u << 4,
+        IsQuickPlayRealms = 1u << 5
+    };
+
+    // Bit for a manifest feature name, 0 if we never enable it
+    static quint32 featureBit(const QString& name);
+
+    static QString hostOsName();
+    static QString hostArch();
+    static bool matchesHost(const QJsonObject& os);
+
+private:
+    static QString normalizeArch(const QString& arch);
+};
\ No newline at end of file
@@ -0,0 +1,158 @@
+#include "ZipReader.h"
+#include <QtEndian>
+#include <zlib.h>
+
+namespace {
+const quint32 LOCAL_HEADER_SIGNATURE = 0x04034b50;
+const quint32 CENTRAL_HEADER_SIGNATURE = 0x02014b50;
+const quint32 END_OF_CENTRAL_DIRECTORY_SIGNATURE = 0x06054b50;
+const int END_OF_CENTRAL_DIRECTORY_SIZE = 22;
+const int MAX_COMMENT_SIZE = 0xffff;
+// Natives run to a few MB; anything claiming more is not worth a buffer
+const qint64 MAX_ENTRY_SIZE = 64 * 1024 * 1024;
+
+quint16 readUInt16(const char* data) { return qFromLittleEndian<quint16>(data); }
+quint32 readUInt32(const char* data) { return qFromLittleEndian<quint32>(data); }
+}
+
+ZipReader::ZipReader(const QString& filePath)
+    : m_file(filePath)
+{
+}
+
+bool ZipReader::open()
+{
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        return fail(m_file.errorString());
+    }
+    return readCentralDirectory();
+}
+
+bool ZipReader::read(const Entry& entry, QByteArray* data)
+{
+    // Both sizes come from the central directory and size the buffers below
+    if (entry.uncompressedSize > MAX_ENTRY_SIZE || entry.compressedSize > m_file.size()
+        || (entry.method == 0 && entry.compressedSize != entry.uncompressedSize)) {
+        return fail("Implausible size for " + entry.name);
+    }
+
+    char header[30];
+    if (!m_file.seek(entry.localHeaderOffset) || m_file.read(header, sizeof(header)) != sizeof(header)
+        || readUInt32(header) != LOCAL_HEADER_SIGNATURE) {
+        return fail("Bad local header for " + entry.name);
+    }
+
+    const qint64 dataOffset = entry.localHeaderOffset + sizeof(header)
+                            + readUInt16(header + 26) + readUInt16(header + 28);
+    if (!m_file.seek(dataOffset)) {
+        return fail("Truncated entry " + entry.name);
+    }
+
+    const QByteArray compressed = m_file.read(entry.compressedSize);
+    if (compressed.size() != entry.compressedSize) {
+        return fail("Truncated entry " + entry.name);
+    }
+
+    if (entry.method == 0) {
+        *data = compressed;
+    } else if (entry.method == 8) {
+        data->resize(entry.uncompressedSize);
+
+        z_stream stream = {};
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(compressed.constData()));
+        stream.avail_in = uInt(compressed.size());
+        stream.next_out = reinterpret_cast<Bytef*>(data->data());
+        stream.avail_out = uInt(data->size());
+
+        // Raw deflate: negative window bits, no zlib header
+        if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) {
+            return fail("inflateInit failed");
+        }
+        const int result = inflate(&stream, Z_FINISH);
+        inflateEnd(&stream);
+
+        if (result != Z_STREAM_END || stream.total_out != uLong(entry.uncompressedSize)) {
+            return fail("Corrupt deflate data in " + entry.name);
+        }
+    } else {
+        return fail(QString("Unsupported compression method %1 for %2").arg(entry.method).arg(entry.name));
+    }
+
+    const uLong crc = crc32(crc32(0L, Z_NULL, 0), reinterpret_cast<const Bytef*>(data->constData()), uInt(data->size()));
+    if (crc != entry.crc) {
+        return fail("CRC mismatch in " + entry.name);
+    }
+
+    return true;
+}
+
+bool ZipReader::readCentralDirectory()
+{
+    // The end record sits within the last 22 + 64K bytes (it may be followed by a comment)
+    const qint64 fileSize = m_file.size();
+    const qint64 tailSize = qMin<qint64>(fileSize, END_OF_CENTRAL_DIRECTORY_SIZE + MAX_COMMENT_SIZE);
+    if (!m_file.seek(fileSize - tailSize)) {
+        return fail("Not a zip file");
+    }
+    const QByteArray tail = m_file.read(tailSize);
+
+    qsizetype end = -1;
+    for (qsizetype i = tail.size() - END_OF_CENTRAL_DIRECTORY_SIZE; i >= 0; --i) {
+        if (readUInt32(tail.constData() + i) == END_OF_CENTRAL_DIRECTORY_SIGNATURE) {
+            end = i;
+            break;
+        }
+    }
+    if (end < 0) {
+        return fail("No end of central directory record");
+    }
+
+    const char* record = tail.constData() + end;
+    const int entryCount = readUInt16(record + 10);
+    const qint64 directorySize = readUInt32(record + 12);
+    const qint64 directoryOffset = readUInt32(record + 16);
+    if (directoryOffset + directorySize > fileSize) {
+        return fail("Central directory out of range (zip64 is not supported)");
+    }
+
+    if (!m_file.seek(directoryOffset)) {
+        return fail("Cannot seek to central directory");
+    }
+    const QByteArray directory = m_file.read(directorySize);
+
+    m_entries.reserve(entryCount);
+    qsizetype position = 0;
+    for (int i = 0; i < entryCount; ++i) {
+        if (position + 46 > directory.size()
+            || readUInt32(directory.constData() + position) != CENTRAL_HEADER_SIGNATURE) {
+            return fail("Corrupt central directory");
+        }
+
+        const char* header = directory.constData() + position;
+        const int nameLength = readUInt16(header + 28);
+        const int extraLength = readUInt16(header + 30);
+        const int commentLength = readUInt16(header + 32);
+        if (position + 46 + nameLength > directory.size()) {
+            return fail("Corrupt central directory");
+        }
+
+        Entry entry;
+        entry.method = readUInt16(header + 10);
+        entry.crc = readUInt32(header + 16);
+        entry.compressedSize = readUInt32(header + 20);
+        entry.uncompressedSize = readUInt32(header + 24);
+        entry.localHeaderOffset = readUInt32(header + 42);
+        entry.name = QString::fromUtf8(header + 46, nameLength);
+        m_entries.append(entry);
+
+        position += 46 + nameLength + extraLength + commentLength;
+    }
+
+    return true;
+}
+
+bool ZipReader::fail(const QString& error)
+{
+    m_errorString = error;
+    return false;
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <QFile>
+#include <QList>
+#include <QString>
+
+// Minimal reader for the stored/deflated entries found in library jars.
+// Not thread-safe; use one reader per thread.
+class ZipReader
+{
+public:
+    struct Entry {
+        QString name;
+        quint16 method = 0;
+        quint32 crc = 0;
+        qint64 compressedSize = 0;
+        qint64 uncompressedSize = 0;
+        qint64 localHeaderOffset = 0;
+
+        bool isDirectory() const { return name.endsWith('/'); }
+    };
+
+    explicit ZipReader(const QString& filePath);
+
+    bool open();
+    QString errorString() const { return m_errorString; }
+
+    QList<Entry> entries() const { return m_entries; }
+    bool read(const Entry& entry, QByteArray* data);
+
+private:
+    bool readCentralDirectory();
+    bool fail(const QString& error);
+
+    QFile m_file;
+    QList<Entry> m_entries;
+    QString m_errorString;
+};
\ No newline at end of file
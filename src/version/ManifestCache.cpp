@@ -0,0 +1,275 @@
+#include "ManifestCache.h"
+#include <QStandardPaths>
+#include <QJsonDocument>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QLoggingCategory>
+
+Q_LOGGING_CATEGORY(manifestCache, "cryovex.version.cache")
+
+const qint64 ManifestCache::DEFAULT_BUDGET_BYTES = 32 * 1024 * 1024;
+
+ManifestCache& ManifestCache::instance()
+{
+    static ManifestCache instance;
+    return instance;
+}
+
+ManifestCache::ManifestCache(QObject *parent)
+    : QObject(parent)
+{
+    m_cache.setMaxCost(DEFAULT_BUDGET_BYTES);
+}
+
+QJsonObject ManifestCache::get(const QString& key)
+{
+    QJsonObject manifest;
+    {
+        QMutexLocker locker(&m_mutex);
+
+        // Pinned before it was stored, or removed since: the pin holds no manifest
+        auto pinned = m_pinned.find(key);
+        if (pinned != m_pinned.end() && !pinned->manifest.isEmpty()) {
+            ++m_hits;
+            return pinned->manifest;
+        }
+
+        if (QJsonObject* cached = m_cache.object(key)) {
+            ++m_hits;
+            return *cached;
+        }
+
+        ++m_misses;
+        qint64 cost = 0;
+        if (loadFromStoreLocked(key, &manifest, &cost)) {
+            if (pinned != m_pinned.end()) {
+                pinned->manifest = manifest;
+                pinned->cost = cost;
+                m_pinnedBytes += cost;
+            } else {
+                insertLocked(key, manifest, cost);
+            }
+        }
+    }
+
+    emit statsChanged();
+    return manifest;
+}
+
+void ManifestCache::put(const QString& key, const QJsonObject& manifest)
+{
+    const QByteArray data = QJsonDocument(manifest).toJson(QJsonDocument::Compact);
+
+    // Write-through so evicted entries can be reloaded
+    const QString path = storePath(key);
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QFile file(path);
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(data);
+    } else {
+        qCWarning(manifestCache) << "Failed to store manifest" << key << ":" << file.errorString();
+    }
+
+    {
+        QMutexLocker locker(&m_mutex);
+        auto pinned = m_pinned.find(key);
+        if (pinned != m_pinned.end()) {
+            m_pinnedBytes += data.size() - pinned->cost;
+            pinned->manifest = manifest;
+            pinned->cost = data.size();
+        } else {
+            insertLocked(key, manifest, data.size());
+        }
+    }
+
+    emit statsChanged();
+}
+
+bool ManifestCache::contains(const QString& key) const
+{
+    QMutexLocker locker(&m_mutex);
+    return !m_pinned.value(key).manifest.isEmpty() || m_cache.contains(key) || QFile::exists(storePath(key));
+}
+
+void ManifestCache::remove(const QString& key)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_cache.remove(key);
+        auto pinned = m_pinned.find(key);
+        if (pinned != m_pinned.end()) {
+            m_pinnedBytes -= pinned->cost;
+            pinned->manifest = QJsonObject();
+            pinned->cost = 0;
+        }
+        QFile::remove(storePath(key));
+    }
+
+    emit statsChanged();
+}
+
+void ManifestCache::trim()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_evictions += m_cache.count();
+        m_cache.clear();
+        qCInfo(manifestCache) << "Manifest cache trimmed," << m_pinned.size() << "pinned entries kept";
+    }
+
+    emit statsChanged();
+}
+
+void ManifestCache::pin(const QString& key)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+
+        auto pinned = m_pinned.find(key);
+        if (pinned != m_pinned.end()) {
+            ++pinned->pinCount;
+            return;
+        }
+
+        // Move the entry out of the LRU so it can never be evicted
+        PinnedEntry entry;
+        entry.pinCount = 1;
+        if (QJsonObject* cached = m_cache.object(key)) {
+            entry.manifest = *cached;
+            entry.cost = QJsonDocument(entry.manifest).toJson(QJsonDocument::Compact).size();
+            m_cache.remove(key);
+        } else {
+            loadFromStoreLocked(key, &entry.manifest, &entry.cost);
+        }
+
+        m_pinnedBytes += entry.cost;
+        m_pinned.insert(key, entry);
+    }
+
+    emit statsChanged();
+}
+
+void ManifestCache::unpin(const QString& key)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+
+        auto pinned = m_pinned.find(key);
+        if (pinned == m_pinned.end() || --pinned->pinCount > 0) {
+            return;
+        }
+
+        const PinnedEntry entry = pinned.value();
+        m_pinned.erase(pinned);
+        m_pinnedBytes -= entry.cost;
+        if (!entry.manifest.isEmpty()) {
+            insertLocked(key, entry.manifest, entry.cost);
+        }
+    }
+
+    emit statsChanged();
+}
+
+bool ManifestCache::isPinned(const QString& key) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_pinned.contains(key);
+}
+
+qint64 ManifestCache::budgetBytes() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_cache.maxCost();
+}
+
+void ManifestCache::setBudgetBytes(qint64 bytes)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_cache.maxCost() == bytes) {
+            return;
+        }
+
+        const qsizetype countBefore = m_cache.count();
+        m_cache.setMaxCost(qMax<qint64>(0, bytes));
+        m_evictions += countBefore - m_cache.count();
+        qCInfo(manifestCache) << "Manifest cache budget set to" << bytes << "bytes";
+    }
+
+    emit statsChanged();
+}
+
+qint64 ManifestCache::bytesUsed() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_cache.totalCost() + m_pinnedBytes;
+}
+
+int ManifestCache::entryCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_cache.count() + m_pinned.size();
+}
+
+quint64 ManifestCache::hits() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_hits;
+}
+
+quint64 ManifestCache::misses() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_misses;
+}
+
+quint64 ManifestCache::evictions() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_evictions;
+}
+
+double ManifestCache::hitRate() const
+{
+    QMutexLocker locker(&m_mutex);
+    const quint64 lookups = m_hits + m_misses;
+    return lookups > 0 ? static_cast<double>(m_hits) / lookups : 0.0;
+}
+
+void ManifestCache::insertLocked(const QString& key, const QJsonObject& manifest, qint64 cost)
+{
+    // QCache evicts least recently used entries until the new one fits
+    const qsizetype countBefore = m_cache.count() + (m_cache.contains(key) ? -1 : 0);
+    if (!m_cache.insert(key, new QJsonObject(manifest), cost)) {
+        qCDebug(manifestCache) << "Manifest" << key << "exceeds the cache budget, not kept in memory";
+        return;
+    }
+    m_evictions += qMax<qsizetype>(0, countBefore + 1 - m_cache.count());
+}
+
+bool ManifestCache::loadFromStoreLocked(const QString& key, QJsonObject* manifest, qint64* cost) const
+{
+    QFile file(storePath(key));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    const QByteArray data = file.readAll();
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(data, &error);
+    if (error.error != QJsonParseError::NoError) {
+        qCWarning(manifestCache) << "Discarding corrupt stored manifest" << key << ":" << error.errorString();
+        return false;
+    }
+
+    *manifest = doc.object();
+    *cost = data.size();
+    return true;
+}
+
+QString ManifestCache::storePath(const QString& key) const
+{
+    QString appDataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    return QDir(appDataPath).filePath("cache/manifests/" + QString::fromLatin1(key.toUtf8().toPercentEncoding()) + ".json");
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <QObject>
+#include <QCache>
+#include <QHash>
+#include <QJsonObject>
+#include <QMutex>
+
+// Byte-budgeted LRU cache for parsed version manifests, backed by an on-disk
+// store so an evicted manifest can be reloaded without a network round trip.
+// Manifests of running or installing versions can be pinned in memory.
+class ManifestCache : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(qint64 budgetBytes READ budgetBytes WRITE setBudgetBytes NOTIFY statsChanged)
+    Q_PROPERTY(qint64 bytesUsed READ bytesUsed NOTIFY statsChanged)
+    Q_PROPERTY(int entryCount READ entryCount NOTIFY statsChanged)
+    Q_PROPERTY(double hitRate READ hitRate NOTIFY statsChanged)
+
+public:
+    static ManifestCache& instance();
+
+    QJsonObject get(const QString& key);
+    void put(const QString& key, const QJsonObject& manifest);
+    bool contains(const QString& key) const;
+    void remove(const QString& key);
+    // Empties the in-memory cache; pinned manifests and the on-disk store stay
+    void trim();
+
+    void pin(const QString& key);
+    void unpin(const QString& key);
+    bool isPinned(const QString& key) const;
+
+    qint64 budgetBytes() const;
+    void setBudgetBytes(qint64 bytes);
+
+    qint64 bytesUsed() const;
+    int entryCount() const;
+    quint64 hits() const;
+    quint64 misses() const;
+    quint64 evictions() const;
+    double hitRate() const;
+
+signals:
+    void statsChanged();
+
+private:
+    struct PinnedEntry {
+        QJsonObject manifest;
+        qint64 cost = 0;
+        int pinCount = 0;
+    };
+
+    explicit ManifestCache(QObject *parent = nullptr);
+    ~ManifestCache() = default;
+
+    void insertLocked(const QString& key, const QJsonObject& manifest, qint64 cost);
+    bool loadFromStoreLocked(const QString& key, QJsonObject* manifest, qint64* cost) const;
+    QString storePath(const QString& key) const;
+
+    mutable QMutex m_mutex;
+    QCache<QString, QJsonObject> m_cache; // cost = serialized size in bytes
+    QHash<QString, PinnedEntry> m_pinned;
+    qint64 m_pinnedBytes = 0;
+
+    quint64 m_hits = 0;
+    quint64 m_misses = 0;
+    quint64 m_evictions = 0;
+
+    static const qint64 DEFAULT_BUDGET_BYTES;
+};
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "MinecraftVersion.h"
+#include "ManifestCache.h"
 
 MinecraftVersion::MinecraftVersion(QObject *parent)
     : QObject(parent)
@@ -18,6 +19,50 @@ MinecraftVersion::MinecraftVersion(const QString& id, const QString& type,
 {
 }
 
+MinecraftVersion::MinecraftVersion(const QString& id, const QString& type, 
+                                  const QDateTime& releaseTime, const QUrl& url, 
+                                  const QString& sha1, QObject *parent)
+    : MinecraftVersion(id, type, releaseTime, url, parent)
+{
+    m_sha1 = sha1;
+}
+
+QJsonObject MinecraftVersion::manifest() const
+{
+    return ManifestCache::instance().get(m_id);
+}
+
+void MinecraftVersion::setManifest(const QJsonObject& manifest)
+{
+    ManifestCache::instance().put(m_id, manifest);
+}
+
+bool MinecraftVersion::hasManifest() const
+{
+    return ManifestCache::instance().contains(m_id);
+}
+
+bool MinecraftVersion::updateDetails(const QString& type, const QDateTime& releaseTime,
+                                     const QUrl& url, const QString& sha1)
+{
+    if (m_typeString == type && m_releaseTime == releaseTime && m_url == url && m_sha1 == sha1) {
+        return false;
+    }
+    
+    // A new sha1 means the version JSON itself changed
+    if (m_sha1 != sha1) {
+        ManifestCache::instance().remove(m_id);
+    }
+    
+    m_typeString = type;
+    m_type = parseVersionType(type);
+    m_releaseTime = releaseTime;
+    m_url = url;
+    m_sha1 = sha1;
+    emit detailsChanged();
+    return true;
+}
+
 MinecraftVersion::VersionType MinecraftVersion::parseVersionType(const QString& typeString)
 {
     if (typeString == "release") {
@@ -10,9 +10,9 @@ class MinecraftVersion : public QObject
 {
     Q_OBJECT
     Q_PROPERTY(QString id READ id CONSTANT)
-    Q_PROPERTY(QString type READ type CONSTANT)
-    Q_PROPERTY(QDateTime releaseTime READ releaseTime CONSTANT)
-    Q_PROPERTY(QUrl url READ url CONSTANT)
+    Q_PROPERTY(QString type READ type NOTIFY detailsChanged)
+    Q_PROPERTY(QDateTime releaseTime READ releaseTime NOTIFY detailsChanged)
+    Q_PROPERTY(QUrl url READ url NOTIFY detailsChanged)
 
 public:
     enum VersionType {
@@ -28,17 +28,34 @@ public:
     MinecraftVersion(const QString& id, const QString& type, 
                     const QDateTime& releaseTime, const QUrl& url, 
                     QObject *parent = nullptr);
+    MinecraftVersion(const QString& id, const QString& type, 
+                    const QDateTime& releaseTime, const QUrl& url, 
+                    const QString& sha1, QObject *parent = nullptr);
 
     QString id() const { return m_id; }
     QString type() const { return m_typeString; }
     VersionType versionType() const { return m_type; }
     QDateTime releaseTime() const { return m_releaseTime; }
     QUrl url() const { return m_url; }
+    QString sha1() const { return m_sha1; }
+    
+    // Applies catalogue changes in place; returns true if anything changed
+    bool updateDetails(const QString& type, const QDateTime& releaseTime,
+                       const QUrl& url, const QString& sha1);
     
-    QJsonObject manifest() const { return m_manifest; }
-    void setManifest(const QJsonObject& manifest) { m_manifest = manifest; }
+    // Manifests live in the bounded ManifestCache, not in this object
+    QJsonObject manifest() const;
+    void setManifest(const QJsonObject& manifest);
     
-    bool hasManifest() const { return !m_manifest.isEmpty(); }
+    bool hasManifest() const;
+    
+    // Modloader profiles (Fabric, Forge, ...) only describe their delta to a
+    // parent version; use VersionManager::resolvedManifest() to get the merge.
+    QString inheritsFrom() const { return manifest().value("inheritsFrom").toString(); }
+    bool isInherited() const { return !inheritsFrom().isEmpty(); }
+
+signals:
+    void detailsChanged();
 
 private:
     static VersionType parseVersionType(const QString& typeString);
@@ -48,5 +65,5 @@ private:
     VersionType m_type;
     QDateTime m_releaseTime;
     QUrl m_url;
-    QJsonObject m_manifest;
+    QString m_sha1;
 };
\ No newline at end of file
@@ -1,5 +1,15 @@
 #include "VersionManager.h"
 #include "MinecraftVersion.h"
+#include "VersionResolver.h"
+#include "ManifestCache.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSet>
+#include <QStandardPaths>
+#include <QCryptographicHash>
+#include <QJsonDocument>
+#include <QNetworkRequest>
 #include <QLoggingCategory>
 
 Q_LOGGING_CATEGORY(versionManager, "cryovex.version.manager")
@@ -9,6 +19,7 @@ const QString VersionManager::VERSION_MANIFEST_URL = "https://piston-meta.mojang
 VersionManager::VersionManager(QObject *parent)
     : QAbstractListModel(parent)
     , m_networkManager(new QNetworkAccessManager(this))
+    , m_resolver(new VersionResolver(this))
 {
 }
 
@@ -50,25 +61,41 @@ QHash<int, QByteArray> VersionManager::roleNames() const
     return roles;
 }
 
+void VersionManager::loadCachedCatalogue()
+{
+    QFile file(getCatalogueCachePath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCInfo(versionManager) << "No cached version catalogue";
+        return;
+    }
+    
+    if (parseVersionManifest(file.readAll())) {
+        QFile etagFile(getCatalogueCachePath() + ".etag");
+        if (etagFile.open(QIODevice::ReadOnly)) {
+            m_catalogueETag = etagFile.readAll().trimmed();
+        }
+        qCInfo(versionManager) << "Loaded" << m_versions.size() << "versions from cache";
+        emit versionsLoaded();
+    }
+}
+
 void VersionManager::refreshVersions()
 {
-    qCInfo(versionManager) << "Refreshing versions (stub)";
-    setLoading(true);
+    if (m_manifestReply) {
+        return;
+    }
     
-    // Stub: Add some dummy versions for testing
-    beginResetModel();
-    qDeleteAll(m_versions);
-    m_versions.clear();
+    qCInfo(versionManager) << "Refreshing versions";
+    setLoading(true);
     
-    // Add some test versions
-    m_versions.append(new MinecraftVersion("1.20.1", "release", QDateTime::currentDateTime(), QUrl("https://example.com"), this));
-    m_versions.append(new MinecraftVersion("1.20.2", "release", QDateTime::currentDateTime(), QUrl("https://example.com"), this));
-    m_versions.append(new MinecraftVersion("23w51b", "snapshot", QDateTime::currentDateTime(), QUrl("https://example.com"), this));
+    QNetworkRequest request{QUrl(VERSION_MANIFEST_URL)};
+    request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::NoLessSafeRedirectPolicy);
+    if (!m_catalogueETag.isEmpty() && !m_versions.isEmpty()) {
+        request.setRawHeader("If-None-Match", m_catalogueETag);
+    }
     
-    endResetModel();
-    setLoading(false);
-    emit versionsLoaded();
-    emit countChanged();
+    m_manifestReply = m_networkManager->get(request);
+    connect(m_manifestReply, &QNetworkReply::finished, this, &VersionManager::onVersionManifestReply);
 }
 
 MinecraftVersion* VersionManager::getVersion(const QString& versionId) const
@@ -87,9 +114,91 @@ void VersionManager::downloadVersionManifest(const QString& versionId)
     // Stub implementation
 }
 
+QJsonObject VersionManager::resolvedManifest(const QString& versionId)
+{
+    bool ok = false;
+    QJsonObject manifest = m_resolver->resolve(versionId, &ok);
+    if (!ok) {
+        emit errorOccurred("Failed to resolve version " + versionId);
+    }
+    return manifest;
+}
+
+QJsonObject VersionManager::installedManifest(const QString& versionId)
+{
+    if (!m_resolver->hasDocument(versionId)) {
+        return QJsonObject();
+    }
+    
+    bool ok = false;
+    const QJsonObject manifest = m_resolver->resolve(versionId, &ok);
+    if (!ok) {
+        qCInfo(versionManager) << "Installed version" << versionId << "does not resolve";
+        return QJsonObject();
+    }
+    return manifest;
+}
+
+void VersionManager::pinVersion(const QString& versionId)
+{
+    // Only the merged manifest lives in ManifestCache; the chain's documents
+    // are VersionResolver's
+    ManifestCache::instance().pin("resolved/" + versionId);
+}
+
+void VersionManager::unpinVersion(const QString& versionId)
+{
+    ManifestCache::instance().unpin("resolved/" + versionId);
+}
+
+void VersionManager::setGameDirectory(const QString& gameDirectory)
+{
+    m_resolver->setVersionsDirectory(QDir(gameDirectory).filePath("versions"));
+}
+
+void VersionManager::releaseCaches()
+{
+    m_resolver->releaseDocuments();
+    m_networkManager->clearConnectionCache();
+}
+
 void VersionManager::onVersionManifestReply()
 {
-    // Stub implementation
+    QNetworkReply* reply = m_manifestReply;
+    m_manifestReply = nullptr;
+    reply->deleteLater();
+    setLoading(false);
+    
+    if (reply->error() != QNetworkReply::NoError) {
+        qCWarning(versionManager) << "Failed to fetch version manifest:" << reply->errorString();
+        emit errorOccurred("Failed to fetch version list: " + reply->errorString());
+        return;
+    }
+    
+    // Nothing new: leave the model untouched
+    const int httpStatus = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (httpStatus == 304) {
+        qCInfo(versionManager) << "Version catalogue not modified";
+        emit versionsLoaded();
+        return;
+    }
+    
+    const QByteArray data = reply->readAll();
+    const QByteArray sha1 = QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+    if (sha1 == m_catalogueSha1) {
+        qCInfo(versionManager) << "Version catalogue unchanged";
+        emit versionsLoaded();
+        return;
+    }
+    
+    if (!parseVersionManifest(data)) {
+        emit errorOccurred("Invalid version manifest");
+        return;
+    }
+    
+    m_catalogueETag = reply->rawHeader("ETag");
+    saveCachedCatalogue(data);
+    emit versionsLoaded();
 }
 
 void VersionManager::onVersionJsonReply()
@@ -105,8 +214,177 @@ void VersionManager::setLoading(bool loading)
     }
 }
 
+bool VersionManager::parseVersionManifest(const QByteArray& data)
+{
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(data, &error);
+    if (error.error != QJsonParseError::NoError || !doc.isObject()) {
+        qCWarning(versionManager) << "Failed to parse version manifest:" << error.errorString();
+        return false;
+    }
+    
+    parseVersionManifest(doc.object());
+    m_catalogueSha1 = QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+    return true;
+}
+
 void VersionManager::parseVersionManifest(const QJsonObject& manifest)
 {
-    // Stub implementation
-    Q_UNUSED(manifest)
+    const QJsonArray versions = manifest["versions"].toArray();
+    
+    QList<CatalogueEntry> entries;
+    entries.reserve(versions.size());
+    for (const QJsonValue& value : versions) {
+        const QJsonObject version = value.toObject();
+        CatalogueEntry entry;
+        entry.id = version["id"].toString();
+        entry.type = version["type"].toString();
+        entry.releaseTime = QDateTime::fromString(version["releaseTime"].toString(), Qt::ISODate);
+        entry.url = QUrl(version["url"].toString());
+        entry.sha1 = version["sha1"].toString();
+        if (!entry.id.isEmpty()) {
+            entries.append(entry);
+        }
+    }
+    
+    applyCatalogue(entries);
+}
+
+void VersionManager::applyCatalogue(const QList<CatalogueEntry>& entries)
+{
+    const int previousCount = m_versions.size();
+    
+    QSet<QString> newIds;
+    newIds.reserve(entries.size());
+    for (const CatalogueEntry& entry : entries) {
+        newIds.insert(entry.id);
+    }
+    
+    // Remove vanished versions in contiguous runs, back to front so rows stay valid
+    int row = m_versions.size() - 1;
+    while (row >= 0) {
+        if (newIds.contains(m_versions.at(row)->id())) {
+            --row;
+            continue;
+        }
+        const int last = row;
+        while (row >= 0 && !newIds.contains(m_versions.at(row)->id())) {
+            --row;
+        }
+        const int first = row + 1;
+        beginRemoveRows(QModelIndex(), first, last);
+        for (int i = last; i >= first; --i) {
+            m_versions.takeAt(i)->deleteLater();
+        }
+        endRemoveRows();
+    }
+    
+    // Retained versions must keep their relative order, otherwise fall back to a reset
+    QHash<QString, int> retainedRows;
+    retainedRows.reserve(m_versions.size());
+    for (int i = 0; i < m_versions.size(); ++i) {
+        retainedRows.insert(m_versions.at(i)->id(), i);
+    }
+    int expectedRow = 0;
+    for (const CatalogueEntry& entry : entries) {
+        auto it = retainedRows.constFind(entry.id);
+        if (it == retainedRows.constEnd()) {
+            continue;
+        }
+        if (it.value() != expectedRow++) {
+            qCInfo(versionManager) << "Version order changed, resetting model";
+            resetCatalogue(entries);
+            return;
+        }
+    }
+    
+    // Insert new versions in contiguous runs and update changed ones in place
+    QList<int> changedRows;
+    int position = 0;
+    int next = 0;
+    while (next < entries.size()) {
+        const CatalogueEntry& entry = entries.at(next);
+        if (position < m_versions.size() && m_versions.at(position)->id() == entry.id) {
+            if (m_versions.at(position)->updateDetails(entry.type, entry.releaseTime, entry.url, entry.sha1)) {
+                changedRows.append(position);
+            }
+            ++position;
+            ++next;
+            continue;
+        }
+        
+        int runEnd = next;
+        while (runEnd < entries.size()
+               && !(position < m_versions.size() && m_versions.at(position)->id() == entries.at(runEnd).id)) {
+            ++runEnd;
+        }
+        
+        const int runLength = runEnd - next;
+        beginInsertRows(QModelIndex(), position, position + runLength - 1);
+        for (int i = 0; i < runLength; ++i) {
+            m_versions.insert(position + i, createVersion(entries.at(next + i)));
+        }
+        endInsertRows();
+        
+        position += runLength;
+        next = runEnd;
+    }
+    
+    for (int i = 0; i < changedRows.size(); ) {
+        int last = i;
+        while (last + 1 < changedRows.size() && changedRows.at(last + 1) == changedRows.at(last) + 1) {
+            ++last;
+        }
+        emit dataChanged(index(changedRows.at(i)), index(changedRows.at(last)),
+                         {TypeRole, ReleaseTimeRole, UrlRole});
+        i = last + 1;
+    }
+    
+    if (m_versions.size() != previousCount) {
+        emit countChanged();
+    }
+}
+
+void VersionManager::resetCatalogue(const QList<CatalogueEntry>& entries)
+{
+    beginResetModel();
+    for (MinecraftVersion* version : m_versions) {
+        version->deleteLater();
+    }
+    m_versions.clear();
+    m_versions.reserve(entries.size());
+    for (const CatalogueEntry& entry : entries) {
+        m_versions.append(createVersion(entry));
+    }
+    endResetModel();
+    emit countChanged();
+}
+
+MinecraftVersion* VersionManager::createVersion(const CatalogueEntry& entry)
+{
+    return new MinecraftVersion(entry.id, entry.type, entry.releaseTime, entry.url, entry.sha1, this);
+}
+
+void VersionManager::saveCachedCatalogue(const QByteArray& data) const
+{
+    const QString cachePath = getCatalogueCachePath();
+    QDir().mkpath(QFileInfo(cachePath).absolutePath());
+    
+    QFile file(cachePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(versionManager) << "Failed to cache version catalogue:" << file.errorString();
+        return;
+    }
+    file.write(data);
+    
+    QFile etagFile(cachePath + ".etag");
+    if (etagFile.open(QIODevice::WriteOnly)) {
+        etagFile.write(m_catalogueETag);
+    }
+}
+
+QString VersionManager::getCatalogueCachePath() const
+{
+    QString appDataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    return QDir(appDataPath).filePath("cache/version_manifest_v2.json");
 }
\ No newline at end of file
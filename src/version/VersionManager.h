@@ -9,6 +9,7 @@
 #include <QDateTime>
 
 class MinecraftVersion;
+class VersionResolver;
 
 class VersionManager : public QAbstractListModel
 {
@@ -33,9 +34,26 @@ public:
     
     bool isLoading() const { return m_isLoading; }
     
+    // Shows the last fetched catalogue immediately; refreshVersions() then diffs against it
+    void loadCachedCatalogue();
+    
     Q_INVOKABLE void refreshVersions();
     Q_INVOKABLE MinecraftVersion* getVersion(const QString& versionId) const;
     Q_INVOKABLE void downloadVersionManifest(const QString& versionId);
+    Q_INVOKABLE QJsonObject resolvedManifest(const QString& versionId);
+    // Like resolvedManifest(), for speculative work such as page cache
+    // warming: empty unless the version is installed, and failures are only logged
+    Q_INVOKABLE QJsonObject installedManifest(const QString& versionId);
+    
+    // Keeps a version's resolved manifest in memory while it is installing or running
+    Q_INVOKABLE void pinVersion(const QString& versionId);
+    Q_INVOKABLE void unpinVersion(const QString& versionId);
+    
+    void setGameDirectory(const QString& gameDirectory);
+    VersionResolver* resolver() const { return m_resolver; }
+    
+    // Drops parsed documents and idle connections; both are rebuilt on demand
+    void releaseCaches();
 
 signals:
     void loadingStatusChanged();
@@ -49,12 +67,30 @@ private slots:
     void onVersionJsonReply();
 
 private:
+    struct CatalogueEntry {
+        QString id;
+        QString type;
+        QDateTime releaseTime;
+        QUrl url;
+        QString sha1;
+    };
+    
     void setLoading(bool loading);
+    bool parseVersionManifest(const QByteArray& data);
     void parseVersionManifest(const QJsonObject& manifest);
+    void applyCatalogue(const QList<CatalogueEntry>& entries);
+    void resetCatalogue(const QList<CatalogueEntry>& entries);
+    MinecraftVersion* createVersion(const CatalogueEntry& entry);
+    void saveCachedCatalogue(const QByteArray& data) const;
+    QString getCatalogueCachePath() const;
     
     QNetworkAccessManager* m_networkManager;
+    VersionResolver* m_resolver;
     QList<MinecraftVersion*> m_versions;
     bool m_isLoading = false;
+    QByteArray m_catalogueSha1;
+    QByteArray m_catalogueETag;
+    QNetworkReply* m_manifestReply = nullptr;
     
     static const QString VERSION_MANIFEST_URL;
 };
\ No newline at end of file
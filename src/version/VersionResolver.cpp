@@ -0,0 +1,239 @@
+#include "VersionResolver.h"
+#include "ManifestCache.h"
+#include "utils/CompiledManifest.h"
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QCryptographicHash>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QSet>
+#include <QLoggingCategory>
+
+Q_LOGGING_CATEGORY(versionResolver, "cryovex.version.resolver")
+
+const int VersionResolver::MAX_INHERITANCE_DEPTH = 16;
+const qint64 VersionResolver::DOCUMENT_BUDGET_BYTES = 8 * 1024 * 1024;
+
+VersionResolver::VersionResolver(QObject *parent)
+    : QObject(parent)
+    , m_documents(DOCUMENT_BUDGET_BYTES)
+{
+}
+
+void VersionResolver::setVersionsDirectory(const QString& directory)
+{
+    if (m_versionsDirectory != directory) {
+        m_versionsDirectory = directory;
+        m_documents.clear();
+    }
+}
+
+QJsonObject VersionResolver::resolve(const QString& versionId, bool* ok)
+{
+    if (ok) *ok = false;
+
+    // Walk leaf -> root. Only stats files whose content is already known.
+    QList<QSharedPointer<const VersionDocument>> chain;
+    QSet<QString> visited;
+    QString currentId = versionId;
+
+    while (!currentId.isEmpty()) {
+        if (visited.contains(currentId) || chain.size() >= MAX_INHERITANCE_DEPTH) {
+            qCWarning(versionResolver) << "Inheritance cycle or chain too deep at:" << currentId;
+            return QJsonObject();
+        }
+        visited.insert(currentId);
+
+        QSharedPointer<const VersionDocument> document = loadDocument(currentId);
+        if (!document) {
+            qCWarning(versionResolver) << "Missing version JSON for" << currentId
+                                       << "while resolving" << versionId;
+            return QJsonObject();
+        }
+
+        chain.append(document);
+        currentId = document->json.value("inheritsFrom").toString();
+    }
+
+    QCryptographicHash chainHash(QCryptographicHash::Sha1);
+    for (const auto& document : chain) {
+        chainHash.addData(document->sha1);
+    }
+    const QByteArray chainKey = chainHash.result();
+
+    const QString cacheKey = "resolved/" + versionId;
+    const QString chainKeyHex = QString::fromLatin1(chainKey.toHex());
+    if (m_resolvedKeys.value(versionId) == chainKey) {
+        // May have been evicted from memory; the stored copy carries its chain key
+        QJsonObject cached = ManifestCache::instance().get(cacheKey);
+        if (cached.value(CompiledManifest::MANIFEST_KEY_FIELD).toString() == chainKeyHex) {
+            if (ok) *ok = true;
+            return cached;
+        }
+    }
+
+    QJsonObject merged = chain.size() == 1 ? chain.first()->json : merge(chain);
+    merged.insert(CompiledManifest::MANIFEST_KEY_FIELD, chainKeyHex);
+
+    qCInfo(versionResolver) << "Resolved" << versionId << "through" << chain.size() << "document(s)";
+
+    m_resolvedKeys.insert(versionId, chainKey);
+    ManifestCache::instance().put(cacheKey, merged);
+    if (ok) *ok = true;
+    return merged;
+}
+
+void VersionResolver::clearCache()
+{
+    for (auto it = m_resolvedKeys.constBegin(); it != m_resolvedKeys.constEnd(); ++it) {
+        ManifestCache::instance().remove("resolved/" + it.key());
+    }
+    m_resolvedKeys.clear();
+    m_documents.clear();
+}
+
+void VersionResolver::releaseDocuments()
+{
+    m_documents.clear();
+}
+
+QSharedPointer<const VersionResolver::VersionDocument> VersionResolver::loadDocument(const QString& versionId)
+{
+    if (m_versionsDirectory.isEmpty()) {
+        return nullptr;
+    }
+
+    QFileInfo info(documentPath(versionId));
+    if (!info.exists()) {
+        m_documents.remove(versionId);
+        return nullptr;
+    }
+
+    // Unchanged on disk: reuse the parsed document and its hash
+    const QSharedPointer<const VersionDocument>* cached = m_documents.object(versionId);
+    if (cached && (*cached)->size == info.size() && (*cached)->lastModified == info.lastModified()) {
+        return *cached;
+    }
+
+    QFile file(info.filePath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCWarning(versionResolver) << "Failed to open version JSON:" << file.errorString();
+        return nullptr;
+    }
+
+    const QByteArray data = file.readAll();
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(data, &error);
+    if (error.error != QJsonParseError::NoError || !doc.isObject()) {
+        qCWarning(versionResolver) << "Failed to parse version JSON" << info.filePath() << ":" << error.errorString();
+        return nullptr;
+    }
+
+    auto document = QSharedPointer<VersionDocument>::create();
+    document->id = versionId;
+    document->json = doc.object();
+    document->sha1 = QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+    document->size = info.size();
+    document->lastModified = info.lastModified();
+
+    // Larger than the whole budget: used for this resolve only
+    m_documents.insert(versionId, new QSharedPointer<const VersionDocument>(document), qMax<qint64>(1, document->size));
+    return document;
+}
+
+bool VersionResolver::hasDocument(const QString& versionId) const
+{
+    return QFileInfo::exists(documentPath(versionId));
+}
+
+QString VersionResolver::documentPath(const QString& versionId) const
+{
+    return QDir(m_versionsDirectory).filePath(versionId + "/" + versionId + ".json");
+}
+
+QJsonObject VersionResolver::merge(const QList<QSharedPointer<const VersionDocument>>& chain)
+{
+    // chain is ordered leaf -> root. Every document is visited a constant
+    // number of times, so merging is linear in the total size of the chain.
+    QJsonObject merged;
+
+    // Scalar keys (mainClass, assetIndex, downloads, ...): the most derived document wins
+    for (int i = chain.size() - 1; i >= 0; --i) {
+        const QJsonObject& json = chain.at(i)->json;
+        for (auto it = json.constBegin(); it != json.constEnd(); ++it) {
+            if (it.key() == "libraries" || it.key() == "arguments") {
+                continue;
+            }
+            merged.insert(it.key(), it.value());
+        }
+    }
+    merged.remove("inheritsFrom");
+
+    // Libraries: child entries come first and replace same-artifact entries of parents
+    QJsonArray libraries;
+    QSet<QString> overridden;
+    for (const auto& document : chain) {
+        QStringList documentKeys;
+        const QJsonArray documentLibraries = document->json.value("libraries").toArray();
+        for (const QJsonValue& value : documentLibraries) {
+            const QString key = libraryKey(value.toObject());
+            if (!key.isEmpty() && overridden.contains(key)) {
+                continue;
+            }
+            libraries.append(value);
+            documentKeys.append(key);
+        }
+        for (const QString& key : documentKeys) {
+            overridden.insert(key);
+        }
+    }
+    merged.insert("libraries", libraries);
+
+    // Arguments: parent arguments first, child arguments appended
+    QJsonArray gameArguments;
+    QJsonArray jvmArguments;
+    bool hasArguments = false;
+    for (int i = chain.size() - 1; i >= 0; --i) {
+        const QJsonObject arguments = chain.at(i)->json.value("arguments").toObject();
+        if (arguments.isEmpty()) {
+            continue;
+        }
+        hasArguments = true;
+        for (const QJsonValue& value : arguments.value("game").toArray()) {
+            gameArguments.append(value);
+        }
+        for (const QJsonValue& value : arguments.value("jvm").toArray()) {
+            jvmArguments.append(value);
+        }
+    }
+    if (hasArguments) {
+        QJsonObject arguments;
+        arguments["game"] = gameArguments;
+        arguments["jvm"] = jvmArguments;
+        merged.insert("arguments", arguments);
+    }
+
+    return merged;
+}
+
+QString VersionResolver::libraryKey(const QJsonObject& library)
+{
+    // group:artifact:version[:classifier][@ext] -> group:artifact[:classifier]
+    QString name = library.value("name").toString();
+    const int extension = name.indexOf('@');
+    if (extension != -1) {
+        name.truncate(extension);
+    }
+
+    const QStringList parts = name.split(':');
+    if (parts.size() < 3) {
+        return name;
+    }
+
+    QString key = parts.at(0) + ":" + parts.at(1);
+    if (parts.size() > 3) {
+        key += ":" + parts.at(3);
+    }
+    return key;
+}
\ No newline at end of file
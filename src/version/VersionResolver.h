@@ -0,0 +1,55 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QHash>
+#include <QCache>
+#include <QJsonObject>
+#include <QDateTime>
+#include <QByteArray>
+#include <QSharedPointer>
+
+// Resolves version JSONs that use "inheritsFrom" (Fabric, Quilt, Forge,
+// NeoForge) into a single merged manifest. Merged results are cached keyed by
+// the sha1s of every document in the chain, so a manifest is only rebuilt when
+// the version itself or one of its parents changes.
+class VersionResolver : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit VersionResolver(QObject *parent = nullptr);
+
+    QString versionsDirectory() const { return m_versionsDirectory; }
+    void setVersionsDirectory(const QString& directory);
+
+    QJsonObject resolve(const QString& versionId, bool* ok = nullptr);
+    // The version's own JSON is on disk; its parents may still be missing
+    bool hasDocument(const QString& versionId) const;
+    void clearCache();
+    // Frees the parsed documents only; resolved manifests stay valid and the
+    // documents are parsed again when a chain has to be rebuilt
+    void releaseDocuments();
+
+    static const int MAX_INHERITANCE_DEPTH;
+    static const qint64 DOCUMENT_BUDGET_BYTES;
+
+private:
+    struct VersionDocument {
+        QString id;
+        QJsonObject json;
+        QByteArray sha1;
+        qint64 size = -1;
+        QDateTime lastModified;
+    };
+
+    QSharedPointer<const VersionDocument> loadDocument(const QString& versionId);
+    QString documentPath(const QString& versionId) const;
+    static QJsonObject merge(const QList<QSharedPointer<const VersionDocument>>& chain);
+    static QString libraryKey(const QJsonObject& library);
+
+    QString m_versionsDirectory;
+    // cost = file size in bytes; a cold document is parsed again from disk
+    QCache<QString, QSharedPointer<const VersionDocument>> m_documents;
+    QHash<QString, QByteArray> m_resolvedKeys; // merged manifests live in ManifestCache
+};
\ No newline at end of file
@@ -0,0 +1,184 @@
+#!/usr/bin/env python3
+"""
+Cryovex Launcher - Local stand-in for the sign-in services
+
+Serves the hops of the Microsoft sign-in chain (token, Xbox Live, XSTS,
+Minecraft login, profile and entitlements) on one local port, each with
+an artificial delay, so sign-in latency can be measured without a real
+account or network:
+
+    python auth_standin.py --port 8765 --latency 60
+    CRYOVEX_AUTH_ENDPOINT=http://127.0.0.1:8765 ./CryovexLauncher --benchmark-auth
+
+With --bench it also runs the chain itself, sequentially and the way the
+launcher pipelines it, mirroring the C++ implementation.
+"""
+
+import argparse
+import http.client
+import json
+import statistics
+import threading
+import time
+import urllib.parse
+from concurrent.futures import ThreadPoolExecutor
+from datetime import datetime, timedelta, timezone
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+
+def not_after(hours: int) -> str:
+    """Xbox style expiry, with seven fractional digits"""
+    expiry = datetime.now(timezone.utc) + timedelta(hours=hours)
+    return expiry.strftime("%Y-%m-%dT%H:%M:%S.0000000Z")
+
+
+class StandInHandler(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"  # keep-alive, like the real services
+    latency = 0.06
+    handshake = 0.12
+
+    def setup(self):
+        # Once per connection: what a TLS handshake would cost
+        super().setup()
+        time.sleep(self.handshake)
+
+    def log_message(self, format, *args):
+        pass
+
+    def reply(self, payload: dict, status: int = 200):
+        time.sleep(self.latency)
+        body = json.dumps(payload).encode()
+        self.send_response(status)
+        self.send_header("Content-Type", "application/json")
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+
+    def do_POST(self):
+        length = int(self.headers.get("Content-Length", 0))
+        data = self.rfile.read(length)
+        path = urllib.parse.urlparse(self.path).path
+
+        if path == "/consumers/oauth2/v2.0/token":
+            form = urllib.parse.parse_qs(data.decode())
+            if not form.get("refresh_token") and not form.get("code"):
+                self.reply({"error": "invalid_grant"}, 400)
+                return
+            self.reply({"access_token": "msa-token", "refresh_token": "msa-refresh", "expires_in": 3600})
+        elif path == "/user/authenticate":
+            self.reply({"Token": "xbl-token", "NotAfter": not_after(24 * 14)})
+        elif path == "/xsts/authorize":
+            self.reply({"Token": "xsts-token", "NotAfter": not_after(16),
+                        "DisplayClaims": {"xui": [{"uhs": "1234567890"}]}})
+        elif path == "/authentication/login_with_xbox":
+            self.reply({"access_token": "mc-token", "expires_in": 86400})
+        else:
+            self.reply({"error": "not found"}, 404)
+
+    def do_GET(self):
+        path = urllib.parse.urlparse(self.path).path
+        if path == "/minecraft/profile":
+            self.reply({"id": "0123456789abcdef0123456789abcdef", "name": "StandIn"})
+        elif path == "/entitlements/mcstore":
+            self.reply({"items": [{"name": "product_minecraft"}, {"name": "game_minecraft"}]})
+        else:
+            self.reply({"error": "not found"}, 404)
+
+
+class ChainClient:
+    """Silent sign-in from a refresh token, as MicrosoftAuth runs it"""
+
+    def __init__(self, host: str, port: int, pipelined: bool):
+        self.host = host
+        self.port = port
+        self.pipelined = pipelined
+        self.local = threading.local()
+
+    def connection(self) -> http.client.HTTPConnection:
+        # One kept-alive connection per thread, fresh for every run
+        if getattr(self.local, "conn", None) is None:
+            self.local.conn = http.client.HTTPConnection(self.host, self.port)
+        return self.local.conn
+
+    def request(self, method: str, path: str, body: bytes = None, headers: dict = None) -> dict:
+        conn = self.connection()
+        conn.request(method, path, body=body, headers=headers or {})
+        response = conn.getresponse()
+        payload = json.loads(response.read())
+        if response.status != 200:
+            raise RuntimeError(f"{path}: HTTP {response.status}")
+        return payload
+
+    def run(self) -> None:
+        self.local = threading.local()
+        with ThreadPoolExecutor(max_workers=2) as pool:
+            if self.pipelined:
+                # Open the second connection while the first hops run
+                pool.submit(lambda: self.connection().connect())
+
+            form = urllib.parse.urlencode({"grant_type": "refresh_token", "refresh_token": "benchmark"}).encode()
+            msa = self.request("POST", "/consumers/oauth2/v2.0/token", form,
+                               {"Content-Type": "application/x-www-form-urlencoded"})
+            json_headers = {"Content-Type": "application/json"}
+            xbl = self.request("POST", "/user/authenticate", json.dumps(
+                {"Properties": {"RpsTicket": "d=" + msa["access_token"]}}).encode(), json_headers)
+            xsts = self.request("POST", "/xsts/authorize", json.dumps(
+                {"Properties": {"UserTokens": [xbl["Token"]]}}).encode(), json_headers)
+            uhs = xsts["DisplayClaims"]["xui"][0]["uhs"]
+            mc = self.request("POST", "/authentication/login_with_xbox", json.dumps(
+                {"identityToken": f"XBL3.0 x={uhs};{xsts['Token']}"}).encode(), json_headers)
+
+            bearer = {"Authorization": "Bearer " + mc["access_token"]}
+            if self.pipelined:
+                entitlements = pool.submit(self.request, "GET", "/entitlements/mcstore", None, bearer)
+                self.request("GET", "/minecraft/profile", None, bearer)
+                entitlements.result()
+            else:
+                self.request("GET", "/minecraft/profile", None, bearer)
+                self.request("GET", "/entitlements/mcstore", None, bearer)
+
+
+def bench(host: str, port: int, iterations: int) -> None:
+    print(f"Silent sign-in latency, {iterations} runs against http://{host}:{port}")
+    for name, pipelined in (("sequential", False), ("pipelined", True)):
+        client = ChainClient(host, port, pipelined)
+        samples = []
+        for _ in range(iterations):
+            start = time.perf_counter()
+            client.run()
+            samples.append((time.perf_counter() - start) * 1000)
+        samples.sort()
+        print(f"  {name:>10}: median {statistics.median(samples):.0f} ms, "
+              f"p90 {samples[int(len(samples) * 0.9)]:.0f} ms")
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description="Local stand-in for the Microsoft/Xbox/Minecraft sign-in services")
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=8765)
+    parser.add_argument("--latency", type=float, default=60, help="delay per request, in ms")
+    parser.add_argument("--handshake", type=float, default=120, help="delay per new connection, in ms")
+    parser.add_argument("--bench", type=int, metavar="RUNS", help="run the chain RUNS times and exit")
+    args = parser.parse_args()
+
+    StandInHandler.latency = args.latency / 1000
+    StandInHandler.handshake = args.handshake / 1000
+    server = ThreadingHTTPServer((args.host, args.port), StandInHandler)
+    server.daemon_threads = True
+
+    if args.bench:
+        threading.Thread(target=server.serve_forever, daemon=True).start()
+        bench(args.host, server.server_address[1], args.bench)
+        server.shutdown()
+        return
+
+    print(f"Stand-in sign-in services on http://{args.host}:{server.server_address[1]}")
+    print(f"  CRYOVEX_AUTH_ENDPOINT=http://{args.host}:{server.server_address[1]}")
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
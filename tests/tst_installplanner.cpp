@@ -0,0 +1,124 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include "download/InstallPlanner.h"
+#include "download/DownloadManager.h"
+
+// InstallPlanner planning and the critical-file gate of submit()
+class TestInstallPlanner : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void readyWhenNothingMissing();
+    void readyWhenOnlyNonCriticalMissing();
+    void sharedAssetObjectsPlannedOnce();
+    void planKeyedOnRequestedVersion();
+};
+
+void TestInstallPlanner::readyWhenNothingMissing()
+{
+    InstallPlanner planner;
+    DownloadManager downloads;
+    QSignalSpy ready(&planner, &InstallPlanner::criticalFilesReady);
+
+    InstallPlan plan;
+    plan.versionId = "1.20.1";
+    planner.submit(plan, &downloads);
+
+    QCOMPARE(ready.count(), 1);
+}
+
+void TestInstallPlanner::readyWhenOnlyNonCriticalMissing()
+{
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+
+    InstallPlanner planner;
+    DownloadManager downloads;
+    QSignalSpy ready(&planner, &InstallPlanner::criticalFilesReady);
+    QSignalSpy failed(&planner, &InstallPlanner::criticalFilesFailed);
+
+    // A sound with the asset index already on disk: nothing critical to wait for
+    InstallRequirement sound;
+    sound.kind = InstallRequirement::Asset;
+    sound.url = QUrl::fromLocalFile(directory.filePath("missing-source"));
+    sound.filePath = directory.filePath("assets/objects/ab/abcdef");
+    sound.critical = false;
+
+    InstallPlan plan;
+    plan.versionId = "1.20.1";
+    plan.gameDirectory = directory.path();
+    plan.missing.append(sound);
+    planner.submit(plan, &downloads);
+
+    QVERIFY(ready.wait(5000));
+    QCOMPARE(ready.first().at(0).toString(), QString("1.20.1"));
+    QCOMPARE(failed.count(), 0);
+}
+
+void TestInstallPlanner::sharedAssetObjectsPlannedOnce()
+{
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    QVERIFY(QDir(directory.path()).mkpath("assets/indexes"));
+
+    // A sound and a texture share one object
+    const QString shared = "1111111111111111111111111111111111111111";
+    const QString other = "2222222222222222222222222222222222222222";
+    QFile index(directory.filePath("assets/indexes/test.json"));
+    QVERIFY(index.open(QIODevice::WriteOnly));
+    index.write(QString(R"({"objects": {
+        "minecraft/sounds/ambient/cave1.ogg": {"hash": "%1", "size": 3},
+        "minecraft/textures/block/stone.png": {"hash": "%1", "size": 3},
+        "minecraft/textures/block/dirt.png": {"hash": "%2", "size": 5}
+    }})").arg(shared, other).toUtf8());
+    index.close();
+
+    QJsonObject assetIndex;
+    assetIndex["id"] = "test";
+    assetIndex["url"] = QUrl::fromLocalFile(index.fileName()).toString();
+    QJsonObject manifest;
+    manifest["id"] = "test";
+    manifest["assetIndex"] = assetIndex;
+
+    InstallPlanner planner;
+    QSignalSpy planned(&planner, &InstallPlanner::planReady);
+    planner.planAsync("test", manifest, directory.path());
+    QVERIFY(planned.wait(5000));
+
+    const InstallPlan plan = planned.first().at(0).value<InstallPlan>();
+    QVERIFY(!plan.assetsPending);
+    QCOMPARE(plan.missing.size(), 2);
+    QCOMPARE(plan.totalBytes, qint64(8));
+    for (const InstallRequirement& requirement : plan.missing) {
+        // Needed at startup by the texture, though the sound came first
+        QVERIFY(requirement.critical);
+    }
+}
+
+void TestInstallPlanner::planKeyedOnRequestedVersion()
+{
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+
+    InstallPlanner planner;
+    DownloadManager downloads;
+    QSignalSpy planned(&planner, &InstallPlanner::planReady);
+    QSignalSpy ready(&planner, &InstallPlanner::criticalFilesReady);
+
+    // A manifest without an "id" must still release the launch waiting on 1.20.1
+    QJsonObject manifest;
+    manifest["type"] = "release";
+    planner.planAsync("1.20.1", manifest, directory.path());
+    QVERIFY(planned.wait(5000));
+
+    const InstallPlan plan = planned.first().at(0).value<InstallPlan>();
+    QCOMPARE(plan.versionId, QString("1.20.1"));
+    planner.submit(plan, &downloads);
+
+    QCOMPARE(ready.count(), 1);
+    QCOMPARE(ready.first().at(0).toString(), QString("1.20.1"));
+}
+
+QTEST_GUILESS_MAIN(TestInstallPlanner)
+#include "tst_installplanner.moc"
\ No newline at end of file
@@ -0,0 +1,124 @@
+#include <QtTest>
+#include <QJsonArray>
+#include <QJsonObject>
+#include "utils/RuleEngine.h"
+#include "utils/CompiledManifest.h"
+
+// Rule compilation against this host and its use by CompiledManifest
+class TestRuleEngine : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void lastMatchingRuleWins();
+    void otherOsRulesFoldAway();
+    void featureRulesStayConditional();
+    void nativeClassifierArchSubstituted();
+
+private:
+    static QJsonObject rule(const QString& action, const QJsonObject& os = QJsonObject(),
+                            const QJsonObject& features = QJsonObject());
+    static QString otherOsName();
+};
+
+QJsonObject TestRuleEngine::rule(const QString& action, const QJsonObject& os, const QJsonObject& features)
+{
+    QJsonObject rule;
+    rule["action"] = action;
+    if (!os.isEmpty()) {
+        rule["os"] = os;
+    }
+    if (!features.isEmpty()) {
+        rule["features"] = features;
+    }
+    return rule;
+}
+
+QString TestRuleEngine::otherOsName()
+{
+    return RuleEngine::hostOsName() == "linux" ? "windows" : "linux";
+}
+
+void TestRuleEngine::lastMatchingRuleWins()
+{
+    const QJsonObject host{{"name", RuleEngine::hostOsName()}};
+
+    // The usual "everywhere but here" library, and its reverse
+    const CompiledRule exceptHost = CompiledRule::compile({rule("allow"), rule("disallow", host)});
+    QVERIFY(exceptHost.isConstant());
+    QVERIFY(!exceptHost.evaluate(0));
+
+    const CompiledRule onlyHost = CompiledRule::compile({rule("disallow", host), rule("allow")});
+    QVERIFY(onlyHost.isConstant());
+    QVERIFY(onlyHost.evaluate(0));
+
+    // No rule matching: disallowed
+    const CompiledRule nothingMatches = CompiledRule::compile({rule("allow", QJsonObject{{"name", otherOsName()}})});
+    QVERIFY(nothingMatches.isNeverAllowed());
+}
+
+void TestRuleEngine::otherOsRulesFoldAway()
+{
+    const QJsonObject other{{"name", otherOsName()}};
+    const quint32 allFeatures = RuleEngine::IsDemoUser | RuleEngine::HasCustomResolution;
+
+    // A rule for another OS never matches, whatever features it asks for
+    const CompiledRule folded = CompiledRule::compile({
+        rule("allow"),
+        rule("disallow", other, QJsonObject{{"is_demo_user", true}})
+    });
+    QVERIFY(folded.isConstant());
+    QVERIFY(folded.evaluate(0));
+    QVERIFY(folded.evaluate(allFeatures));
+
+    // Nor does one for another architecture
+    const QString otherArch = RuleEngine::hostArch() == "x86" ? "arm64" : "x86";
+    const CompiledRule otherArchOnly = CompiledRule::compile({rule("allow", QJsonObject{{"arch", otherArch}})});
+    QVERIFY(otherArchOnly.isNeverAllowed());
+}
+
+void TestRuleEngine::featureRulesStayConditional()
+{
+    const CompiledRule resolution = CompiledRule::compile({
+        rule("allow", QJsonObject(), QJsonObject{{"has_custom_resolution", true}})
+    });
+    QVERIFY(!resolution.isConstant());
+    QVERIFY(!resolution.evaluate(0));
+    QVERIFY(resolution.evaluate(RuleEngine::HasCustomResolution));
+
+    // An unknown feature is never enabled, so asking for it can never match
+    const CompiledRule unknown = CompiledRule::compile({
+        rule("allow", QJsonObject(), QJsonObject{{"is_some_future_feature", true}})
+    });
+    QVERIFY(unknown.isNeverAllowed());
+}
+
+void TestRuleEngine::nativeClassifierArchSubstituted()
+{
+    const QString os = RuleEngine::hostOsName();
+    auto classifier = [](const QString& path) {
+        return QJsonObject{{"path", path}, {"url", "https://example.invalid/" + path},
+                           {"sha1", "0000000000000000000000000000000000000000"}, {"size", 1}};
+    };
+
+    QJsonObject classifiers;
+    classifiers["natives-" + os + "-32"] = classifier("natives-32.jar");
+    classifiers["natives-" + os + "-64"] = classifier("natives-64.jar");
+
+    QJsonObject library;
+    library["name"] = "org.lwjgl.lwjgl:lwjgl-platform:2.9.4";
+    library["natives"] = QJsonObject{{os, "natives-" + os + "-${arch}"}};
+    library["downloads"] = QJsonObject{{"classifiers", classifiers}};
+
+    QJsonObject manifest;
+    manifest["id"] = "arch-test";
+    manifest["libraries"] = QJsonArray{library};
+
+    const QSharedPointer<const CompiledManifest> compiled = CompiledManifest::get(manifest);
+    QCOMPARE(compiled->libraries.size(), 1);
+    QCOMPARE(compiled->libraries.first().nativePath,
+             QString(QSysInfo::WordSize == 64 ? "natives-64.jar" : "natives-32.jar"));
+}
+
+QTEST_GUILESS_MAIN(TestRuleEngine)
+#include "tst_ruleengine.moc"
\ No newline at end of file
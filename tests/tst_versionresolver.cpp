@@ -0,0 +1,132 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include "version/VersionResolver.h"
+#include "utils/CompiledManifest.h"
+
+// Merging of "inheritsFrom" chains, as written by Fabric, Forge and friends
+class TestVersionResolver : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void childLibrariesOverrideParents();
+    void parentArgumentsComeFirst();
+    void resolvedManifestCarriesChainKey();
+
+private:
+    void writeVersion(const QString& id, const QJsonObject& json);
+    static QJsonObject library(const QString& name);
+    static QStringList names(const QJsonArray& libraries);
+
+    QScopedPointer<QTemporaryDir> m_directory;
+};
+
+void TestVersionResolver::initTestCase()
+{
+    // ManifestCache stores resolved manifests under the app data location
+    QStandardPaths::setTestModeEnabled(true);
+}
+
+void TestVersionResolver::init()
+{
+    m_directory.reset(new QTemporaryDir);
+    QVERIFY(m_directory->isValid());
+
+    QJsonObject parent;
+    parent["id"] = "1.20.1";
+    parent["mainClass"] = "net.minecraft.client.main.Main";
+    parent["libraries"] = QJsonArray{library("org.ow2.asm:asm:9.3"), library("com.google.code.gson:gson:2.10")};
+    parent["arguments"] = QJsonObject{
+        {"game", QJsonArray{"--username", "${auth_player_name}"}},
+        {"jvm", QJsonArray{"-cp", "${classpath}"}}
+    };
+    writeVersion("1.20.1", parent);
+
+    QJsonObject child;
+    child["id"] = "fabric-loader-1.20.1";
+    child["inheritsFrom"] = "1.20.1";
+    child["mainClass"] = "net.fabricmc.loader.impl.launch.knot.KnotClient";
+    child["libraries"] = QJsonArray{library("org.ow2.asm:asm:9.6"), library("net.fabricmc:fabric-loader:0.15.0")};
+    child["arguments"] = QJsonObject{
+        {"game", QJsonArray{"--fabric"}},
+        {"jvm", QJsonArray{"-DFabricMcEmu=net.minecraft.client.main.Main"}}
+    };
+    writeVersion("fabric-loader-1.20.1", child);
+}
+
+void TestVersionResolver::childLibrariesOverrideParents()
+{
+    VersionResolver resolver;
+    resolver.setVersionsDirectory(m_directory->path());
+
+    bool ok = false;
+    const QJsonObject manifest = resolver.resolve("fabric-loader-1.20.1", &ok);
+    QVERIFY(ok);
+
+    // The child's asm replaces the parent's; the rest follow in chain order
+    QCOMPARE(names(manifest["libraries"].toArray()), QStringList({"org.ow2.asm:asm:9.6",
+                                                                  "net.fabricmc:fabric-loader:0.15.0",
+                                                                  "com.google.code.gson:gson:2.10"}));
+    QCOMPARE(manifest["mainClass"].toString(), QString("net.fabricmc.loader.impl.launch.knot.KnotClient"));
+    QVERIFY(!manifest.contains("inheritsFrom"));
+}
+
+void TestVersionResolver::parentArgumentsComeFirst()
+{
+    VersionResolver resolver;
+    resolver.setVersionsDirectory(m_directory->path());
+
+    bool ok = false;
+    const QJsonObject arguments = resolver.resolve("fabric-loader-1.20.1", &ok)["arguments"].toObject();
+    QVERIFY(ok);
+
+    QCOMPARE(arguments["game"].toArray(), QJsonArray({"--username", "${auth_player_name}", "--fabric"}));
+    QCOMPARE(arguments["jvm"].toArray(), QJsonArray({"-cp", "${classpath}",
+                                                     "-DFabricMcEmu=net.minecraft.client.main.Main"}));
+}
+
+void TestVersionResolver::resolvedManifestCarriesChainKey()
+{
+    VersionResolver resolver;
+    resolver.setVersionsDirectory(m_directory->path());
+
+    bool ok = false;
+    const QJsonObject manifest = resolver.resolve("fabric-loader-1.20.1", &ok);
+    QVERIFY(ok);
+
+    // The launcher keys compiled manifests and launch plans on it
+    const QString key = manifest[CompiledManifest::MANIFEST_KEY_FIELD].toString();
+    QVERIFY(!key.isEmpty());
+    QCOMPARE(CompiledManifest::cacheKey(manifest), key);
+}
+
+void TestVersionResolver::writeVersion(const QString& id, const QJsonObject& json)
+{
+    QDir versions(m_directory->path());
+    QVERIFY(versions.mkpath(id));
+    QFile file(versions.filePath(id + "/" + id + ".json"));
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(QJsonDocument(json).toJson());
+}
+
+QJsonObject TestVersionResolver::library(const QString& name)
+{
+    return QJsonObject{{"name", name}};
+}
+
+QStringList TestVersionResolver::names(const QJsonArray& libraries)
+{
+    QStringList names;
+    for (const QJsonValue& value : libraries) {
+        names.append(value.toObject()["name"].toString());
+    }
+    return names;
+}
+
+QTEST_GUILESS_MAIN(TestVersionResolver)
+#include "tst_versionresolver.moc"
\ No newline at end of file